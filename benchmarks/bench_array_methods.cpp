@@ -0,0 +1,66 @@
+// Higher-order array method benchmark
+//
+// map/filter/reduce/forEach/find/some/every are natives: they walk the
+// array in C++, reuse one argument buffer for every callback and size
+// their result up front. Each script below is timed next to the
+// equivalent interpreted loop built on push, on both engines.
+
+#include "bench_util.h"
+
+using namespace volt;
+using namespace volt::bench;
+
+namespace {
+
+// Both versions of each script start from the same 200k-element array
+const char* kSetup =
+    "let a = [];"
+    "for (let i = 0; i < 200000; i++) { a.push(i); }"
+    "fn double(x) { return x * 2; }"
+    "fn isEven(x) { return x % 2 == 0; }"
+    "fn add(total, x) { return total + x; }"
+    "fn isNegative(x) { return x < 0; }";
+
+std::string withSetup(const std::string& body) {
+    return std::string(kSetup) + body;
+}
+
+} // anonymous namespace
+
+int main() {
+    struct Case {
+        const char* name;
+        Program native;
+        Program loop;
+    };
+    Case cases[] = {
+        {"map",
+         Program(withSetup("let b = a.map(double); print len(b);")),
+         Program(withSetup("let b = []; for (let i = 0; i < len(a); i++) { b.push(double(a[i])); }"
+                           "print len(b);"))},
+        {"filter",
+         Program(withSetup("let b = a.filter(isEven); print len(b);")),
+         Program(withSetup("let b = []; for (let i = 0; i < len(a); i++) { if (isEven(a[i])) b.push(a[i]); }"
+                           "print len(b);"))},
+        {"reduce",
+         Program(withSetup("print a.reduce(add, 0);")),
+         Program(withSetup("let t = 0; for (let i = 0; i < len(a); i++) { t = add(t, a[i]); } print t;"))},
+        {"some (no match)",
+         Program(withSetup("print a.some(isNegative);")),
+         Program(withSetup("let found = false;"
+                           "for (let i = 0; i < len(a); i++) { if (isNegative(a[i])) { found = true; break; } }"
+                           "print found;"))},
+    };
+
+    std::printf("200k elements, ms including setup (best of 3)\n\n");
+    std::printf("  %-24s %10s %10s %10s %10s\n", "", "ast loop", "ast native", "vm loop", "vm native");
+    for (const auto& c : cases) {
+        double astLoop = bestOfMs(3, [&]() { runProgramMs(c.loop, Engine::Ast); });
+        double astNative = bestOfMs(3, [&]() { runProgramMs(c.native, Engine::Ast); });
+        double vmLoop = bestOfMs(3, [&]() { runProgramMs(c.loop, Engine::Vm); });
+        double vmNative = bestOfMs(3, [&]() { runProgramMs(c.native, Engine::Vm); });
+        std::printf("  %-24s %10.2f %10.2f %10.2f %10.2f\n",
+                    c.name, astLoop, astNative, vmLoop, vmNative);
+    }
+    return 0;
+}
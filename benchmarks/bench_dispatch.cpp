@@ -0,0 +1,119 @@
+// Node dispatch micro-benchmark
+//
+// Compares the old dynamic_cast chain (kept here verbatim in order) with
+// the ExprKind switch the interpreter uses now. The cost of the chain
+// grows with a node's position in it; the switch is flat.
+
+#include "bench_util.h"
+#include "ast.h"
+#include <algorithm>
+
+using namespace volt;
+using namespace volt::bench;
+
+namespace {
+
+// The dispatch order Interpreter::evaluate used before ExprKind existed
+int dispatchByCast(Expr* expr) {
+    if (dynamic_cast<LiteralExpr*>(expr)) return 0;
+    if (dynamic_cast<VariableExpr*>(expr)) return 1;
+    if (dynamic_cast<UnaryExpr*>(expr)) return 2;
+    if (dynamic_cast<BinaryExpr*>(expr)) return 3;
+    if (dynamic_cast<LogicalExpr*>(expr)) return 4;
+    if (dynamic_cast<GroupingExpr*>(expr)) return 5;
+    if (dynamic_cast<CallExpr*>(expr)) return 6;
+    if (dynamic_cast<AssignExpr*>(expr)) return 7;
+    if (dynamic_cast<CompoundAssignExpr*>(expr)) return 8;
+    if (dynamic_cast<UpdateExpr*>(expr)) return 9;
+    if (dynamic_cast<TernaryExpr*>(expr)) return 10;
+    if (dynamic_cast<ArrayExpr*>(expr)) return 11;
+    if (dynamic_cast<IndexExpr*>(expr)) return 12;
+    if (dynamic_cast<IndexAssignExpr*>(expr)) return 13;
+    if (dynamic_cast<MemberExpr*>(expr)) return 14;
+    if (dynamic_cast<HashMapExpr*>(expr)) return 15;
+    return -1;
+}
+
+int dispatchByKind(Expr* expr) {
+    switch (expr->kind) {
+        case ExprKind::Literal: return 0;
+        case ExprKind::Variable: return 1;
+        case ExprKind::Unary: return 2;
+        case ExprKind::Binary: return 3;
+        case ExprKind::Logical: return 4;
+        case ExprKind::Grouping: return 5;
+        case ExprKind::Call: return 6;
+        case ExprKind::Assign: return 7;
+        case ExprKind::CompoundAssign: return 8;
+        case ExprKind::Update: return 9;
+        case ExprKind::Ternary: return 10;
+        case ExprKind::Array: return 11;
+        case ExprKind::Index: return 12;
+        case ExprKind::IndexAssign: return 13;
+        case ExprKind::Member: return 14;
+        case ExprKind::HashMap: return 15;
+        case ExprKind::MethodCall: return 16;
+        case ExprKind::MemberAssign: return 17;
+    }
+    return -1;
+}
+
+Token tok(TokenType type = TokenType::Identifier) { return Token(type, "x", 1, 1); }
+
+ExprPtr makeNode(const std::string& kind) {
+    if (kind == "Literal") return std::make_unique<LiteralExpr>(tok(), 1.0);
+    if (kind == "Binary") {
+        return std::make_unique<BinaryExpr>(std::make_unique<LiteralExpr>(tok(), 1.0),
+                                            tok(TokenType::Plus),
+                                            std::make_unique<LiteralExpr>(tok(), 2.0));
+    }
+    if (kind == "Index") {
+        return std::make_unique<IndexExpr>(tok(), std::make_unique<VariableExpr>(tok(), "a"),
+                                           std::make_unique<LiteralExpr>(tok(), 0.0));
+    }
+    if (kind == "Member") {
+        return std::make_unique<MemberExpr>(tok(), std::make_unique<VariableExpr>(tok(), "a"), "length");
+    }
+    return std::make_unique<HashMapExpr>(tok(), std::vector<std::pair<ExprPtr, ExprPtr>>{});
+}
+
+template <typename Dispatch>
+double nsPerNode(const std::vector<ExprPtr>& nodes, Dispatch dispatch, int rounds) {
+    double ms = bestOfMs(5, [&]() {
+        long sum = 0;
+        for (int r = 0; r < rounds; r++) {
+            for (const auto& node : nodes) sum += dispatch(node.get());
+        }
+        doNotOptimize(sum);
+    });
+    return ms * 1e6 / (static_cast<double>(nodes.size()) * rounds);
+}
+
+} // anonymous namespace
+
+int main() {
+    std::printf("Node dispatch: ns per node (dynamic_cast chain vs ExprKind switch)\n\n");
+    const char* kinds[] = {"Literal", "Binary", "Index", "Member", "HashMap"};
+    for (const char* kind : kinds) {
+        std::vector<ExprPtr> nodes;
+        for (int i = 0; i < 1024; i++) nodes.push_back(makeNode(kind));
+        double before = nsPerNode(nodes, dispatchByCast, 2000);
+        double after = nsPerNode(nodes, dispatchByKind, 2000);
+        std::printf("  %-10s before %7.2f ns   after %7.2f ns   (%.1fx)\n",
+                    kind, before, after, before / after);
+    }
+
+    // End to end: an index/member heavy loop on the tree-walk interpreter
+    Program program(
+        "let arr = [1, 2, 3, 4, 5, 6, 7, 8];"
+        "let m = {\"a\": 1, \"b\": 2};"
+        "let total = 0;"
+        "for (let i = 0; i < 200000; i++) {"
+        "  total = total + arr[i % 8] + arr.length + m[\"a\"];"
+        "}"
+        "print total;");
+    double ms = bestOfMs(3, [&]() { runProgramMs(program, Engine::Ast); });
+    std::printf("\nIndex/member loop (200k iterations, AST engine)\n");
+    printRow("total", ms, "ms");
+    return 0;
+}
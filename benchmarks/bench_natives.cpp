@@ -0,0 +1,83 @@
+// Native function call benchmark
+//
+// Natives used to be std::function objects taking a freshly built
+// std::vector of arguments. They are now plain function pointers reading
+// their arguments from the caller's stack, with a fixed-arity fast path
+// for 0-3 arguments. The first section isolates the calling convention,
+// the second runs native-heavy scripts end to end on both engines.
+
+#include "bench_util.h"
+#include "callable.h"
+#include <cmath>
+#include <functional>
+
+using namespace volt;
+using namespace volt::bench;
+
+namespace {
+
+// The old ABI: type-erased callable plus a heap-allocated argument list
+using OldNative = std::function<Value(const std::vector<Value>&)>;
+
+double nsPerOldCall(int calls) {
+    OldNative sqrtNative = [](const std::vector<Value>& args) -> Value {
+        return std::sqrt(asNumber(args[0]));
+    };
+    double ms = bestOfMs(5, [&]() {
+        double sum = 0;
+        for (int i = 0; i < calls; i++) {
+            std::vector<Value> args;
+            args.push_back(static_cast<double>(i));
+            sum += asNumber(sqrtNative(args));
+        }
+        doNotOptimize(sum);
+    });
+    return ms * 1e6 / calls;
+}
+
+double nsPerNewCall(int calls) {
+    NativeFunction sqrtNative([](const Value& value) -> Value {
+        return std::sqrt(asNumber(value));
+    }, "sqrt");
+    double ms = bestOfMs(5, [&]() {
+        double sum = 0;
+        for (int i = 0; i < calls; i++) {
+            Value args[1] = {static_cast<double>(i)};
+            sum += asNumber(sqrtNative.invoke(args));
+        }
+        doNotOptimize(sum);
+    });
+    return ms * 1e6 / calls;
+}
+
+} // anonymous namespace
+
+int main() {
+    std::printf("Calling a one-argument native: ns per call\n\n");
+    double oldCall = nsPerOldCall(2000000);
+    double newCall = nsPerNewCall(2000000);
+    printRow("std::function + vector (old)", oldCall, "ns");
+    printRow("function pointer + span (new)", newCall, "ns");
+    std::printf("  %-40s %10.1fx\n", "speedup", oldCall / newCall);
+
+    Program math(
+        "let s = 0;"
+        "for (let i = 0; i < 300000; i++) { s = s + sqrt(i) + abs(-i) + max(i, 3); }"
+        "print s;");
+    Program methods(
+        "let a = [];"
+        "for (let i = 0; i < 300000; i++) { a.push(i); }"
+        "print len(a);");
+
+    std::printf("\nScripts (ms, best of 3)%22s %10s\n", "ast", "vm");
+    struct { const char* name; const Program* program; } scripts[] = {
+        {"sqrt/abs/max in a loop (300k)", &math},
+        {"array.push in a loop (300k)", &methods},
+    };
+    for (const auto& script : scripts) {
+        double ast = bestOfMs(3, [&]() { runProgramMs(*script.program, Engine::Ast); });
+        double vm = bestOfMs(3, [&]() { runProgramMs(*script.program, Engine::Vm); });
+        std::printf("  %-40s %10.2f %10.2f\n", script.name, ast, vm);
+    }
+    return 0;
+}
@@ -0,0 +1,92 @@
+// Call-heavy recursion benchmark
+//
+// 'return', 'break' and 'continue' used to unwind the C++ stack with
+// exceptions; now they travel back up as a Completion value. The first
+// section isolates that mechanism, the second runs call-heavy scripts
+// end to end on both engines.
+
+#include "bench_util.h"
+#include <stdexcept>
+
+using namespace volt;
+using namespace volt::bench;
+
+namespace {
+
+// The exception the tree-walk interpreter threw on every 'return'
+struct ThrownReturn : std::exception {
+    Value value;
+    explicit ThrownReturn(Value v) : value(std::move(v)) {}
+};
+
+__attribute__((noinline)) void returnByThrow(double n) {
+    throw ThrownReturn(n);
+}
+
+__attribute__((noinline)) Completion returnByCompletion(double n, Value& slot) {
+    slot = n;
+    return Completion::Return;
+}
+
+double nsPerReturn(int calls, bool useExceptions) {
+    double ms = bestOfMs(5, [&]() {
+        double sum = 0;
+        Value slot;
+        for (int i = 0; i < calls; i++) {
+            if (useExceptions) {
+                try {
+                    returnByThrow(i);
+                } catch (const ThrownReturn& ret) {
+                    sum += asNumber(ret.value);
+                }
+            } else if (returnByCompletion(i, slot) == Completion::Return) {
+                sum += asNumber(slot);
+            }
+        }
+        doNotOptimize(sum);
+    });
+    return ms * 1e6 / calls;
+}
+
+} // anonymous namespace
+
+int main() {
+    std::printf("Returning from a function: ns per return\n\n");
+    double thrown = nsPerReturn(200000, true);
+    double completed = nsPerReturn(200000, false);
+    printRow("exception (old)", thrown, "ns");
+    printRow("completion value (new)", completed, "ns");
+    std::printf("  %-40s %10.1fx\n", "speedup", thrown / completed);
+
+    Program fib(
+        "fn fib(n) { if (n < 2) return n; return fib(n - 1) + fib(n - 2); }"
+        "print fib(24);");
+    Program ackermann(
+        "fn ack(m, n) {"
+        "  if (m == 0) return n + 1;"
+        "  if (n == 0) return ack(m - 1, 1);"
+        "  return ack(m - 1, ack(m, n - 1));"
+        "}"
+        "print ack(2, 300);");
+    Program loopControl(
+        "let total = 0;"
+        "for (let i = 0; i < 300000; i++) {"
+        "  if (i % 3 == 0) continue;"
+        "  if (i == 299999) break;"
+        "  total = total + i;"
+        "}"
+        "print total;");
+
+    std::printf("\nScripts (ms, best of 3)%22s %10s\n", "ast", "vm");
+    struct { const char* name; const Program* program; } scripts[] = {
+        {"fib(24)", &fib},
+        {"ack(2, 300)", &ackermann},
+        {"for loop with continue/break (300k)", &loopControl},
+    };
+    for (const auto& script : scripts) {
+        double ast = bestOfMs(3, [&]() { runProgramMs(*script.program, Engine::Ast); });
+        double vm = bestOfMs(3, [&]() { runProgramMs(*script.program, Engine::Vm); });
+        std::printf("  %-40s %10.2f %10.2f\n", script.name, ast, vm);
+    }
+    return 0;
+}
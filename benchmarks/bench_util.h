@@ -0,0 +1,86 @@
+#pragma once
+#include "lexer.h"
+#include "parser.h"
+#include "interpreter.h"
+#include "optimizer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace volt::bench {
+
+/**
+ * Timer - Wall-clock stopwatch in nanoseconds
+ */
+class Timer {
+public:
+    Timer() : start_(std::chrono::steady_clock::now()) {}
+    double elapsedNs() const {
+        auto now = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(now - start_).count();
+    }
+    double elapsedMs() const { return elapsedNs() / 1e6; }
+private:
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Keeps the optimizer from deleting a computation whose result is unused
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Best of N runs, so one noisy run doesn't skew the numbers
+template <typename Fn>
+double bestOfMs(int runs, Fn&& fn) {
+    double best = 1e300;
+    for (int i = 0; i < runs; i++) {
+        Timer timer;
+        fn();
+        best = std::min(best, timer.elapsedMs());
+    }
+    return best;
+}
+
+// Parse and optimize a script once, as volt does (statements must
+// outlive every run)
+struct Program {
+    std::string source;
+    std::vector<Token> tokens;
+    std::vector<StmtPtr> statements;
+
+    explicit Program(std::string src) : source(std::move(src)) {
+        Lexer lexer(source);
+        tokens = lexer.tokenize();
+        Parser parser(tokens);
+        statements = parser.parseProgram();
+        if (parser.hadError()) {
+            for (const auto& error : parser.getErrors()) std::cerr << error << "\n";
+            std::exit(1);
+        }
+        Optimizer().optimize(statements);
+    }
+};
+
+// Run a parsed program with stdout silenced, returns milliseconds
+inline double runProgramMs(const Program& program, Engine engine) {
+    std::ostringstream sink;
+    std::streambuf* old = std::cout.rdbuf(sink.rdbuf());
+    Interpreter interpreter(engine);
+    Timer timer;
+    interpreter.execute(program.statements);
+    double ms = timer.elapsedMs();
+    std::cout.rdbuf(old);
+    return ms;
+}
+
+inline void printRow(const std::string& name, double value, const char* unit) {
+    std::printf("  %-40s %10.2f %s\n", name.c_str(), value, unit);
+}
+
+} // namespace volt::bench
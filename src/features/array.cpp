@@ -2,11 +2,22 @@
 #include <sstream>
 #include <stdexcept>
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace volt {
 
 VoltArray::VoltArray(std::vector<Value> elements)
-    : elements_(std::move(elements)) {}
+    : elements_(std::move(elements)) {
+    for (const auto& element : elements_) {
+        if (!isNumber(element)) nonNumbers_++;
+    }
+}
 
 Value VoltArray::get(size_t index) const {
     if (index >= elements_.size()) {
@@ -21,10 +32,13 @@ void VoltArray::set(size_t index, Value value) {
         throw std::runtime_error("Array index out of bounds: " + 
                                 std::to_string(index));
     }
+    nonNumbers_ += !isNumber(value);
+    nonNumbers_ -= !isNumber(elements_[index]);
     elements_[index] = value;
 }
 
 void VoltArray::push(Value value) {
+    nonNumbers_ += !isNumber(value);
     elements_.push_back(value);
 }
 
@@ -34,6 +48,7 @@ Value VoltArray::pop() {
     }
     Value last = elements_.back();
     elements_.pop_back();
+    nonNumbers_ -= !isNumber(last);
     return last;
 }
 
@@ -41,6 +56,265 @@ void VoltArray::reverse() {
     std::reverse(elements_.begin(), elements_.end());
 }
 
+void VoltArray::insert(size_t index, Value value) {
+    nonNumbers_ += !isNumber(value);
+    elements_.insert(elements_.begin() + index, std::move(value));
+}
+
+void VoltArray::fill(const Value& value) {
+    std::fill(elements_.begin(), elements_.end(), value);
+    nonNumbers_ = isNumber(value) ? 0 : elements_.size();
+}
+
+Ref<VoltArray> VoltArray::splice(size_t start, size_t count) {
+    auto first = elements_.begin() + start;
+    std::vector<Value> removed(std::make_move_iterator(first),
+                               std::make_move_iterator(first + count));
+    elements_.erase(first, first + count);
+    auto result = makeRef<VoltArray>(std::move(removed));
+    nonNumbers_ -= result->nonNumbers_;
+    return result;
+}
+
+Ref<VoltArray> VoltArray::slice(size_t start, size_t end) const {
+    if (end <= start) return makeRef<VoltArray>();
+    return makeRef<VoltArray>(std::vector<Value>(elements_.begin() + start,
+                                                 elements_.begin() + end));
+}
+
+Ref<VoltArray> VoltArray::concat(const VoltArray& other) const {
+    std::vector<Value> combined;
+    combined.reserve(elements_.size() + other.elements_.size());
+    combined.insert(combined.end(), elements_.begin(), elements_.end());
+    combined.insert(combined.end(), other.elements_.begin(), other.elements_.end());
+    auto result = makeRef<VoltArray>();
+    result->elements_ = std::move(combined);
+    result->nonNumbers_ = nonNumbers_ + other.nonNumbers_;
+    return result;
+}
+
+std::string VoltArray::join(const std::string& separator) const {
+    // Strings are borrowed; everything else is converted once up front
+    // (short numbers fit in std::string's inline buffer), so the result
+    // is sized exactly and allocated once
+    std::vector<std::string> converted;
+    converted.reserve(nonNumbers_ == 0 ? elements_.size() : 0);
+    size_t total = elements_.empty() ? 0 : separator.size() * (elements_.size() - 1);
+    for (const auto& element : elements_) {
+        if (isString(element)) {
+            total += asString(element).size();
+        } else {
+            converted.push_back(valueToString(element));
+            total += converted.back().size();
+        }
+    }
+    
+    std::string result;
+    result.reserve(total);
+    size_t next = 0;
+    for (size_t i = 0; i < elements_.size(); i++) {
+        if (i > 0) result += separator;
+        result += isString(elements_[i]) ? asString(elements_[i]) : converted[next++];
+    }
+    return result;
+}
+
+bool VoltArray::sortNatural() {
+    if (nonNumbers_ == 0) {
+        // Sort the raw doubles (an introsort over 8-byte keys), with NaNs
+        // moved out of the way since they don't order
+        std::vector<double> numbers;
+        numbers.reserve(elements_.size());
+        size_t nans = 0;
+        for (const auto& element : elements_) {
+            double d = element.number();
+            if (std::isnan(d)) {
+                nans++;
+            } else {
+                numbers.push_back(d);
+            }
+        }
+        std::sort(numbers.begin(), numbers.end());
+        for (size_t i = 0; i < numbers.size(); i++) elements_[i] = Value(numbers[i]);
+        for (size_t i = numbers.size(); i < elements_.size(); i++) {
+            elements_[i] = Value(std::numeric_limits<double>::quiet_NaN());
+        }
+        return true;
+    }
+    if (nonNumbers_ != elements_.size() ||
+        !std::all_of(elements_.begin(), elements_.end(), [](const Value& v) { return isString(v); })) {
+        return false;
+    }
+    std::sort(elements_.begin(), elements_.end(), [](const Value& a, const Value& b) {
+        return asString(a) < asString(b);
+    });
+    return true;
+}
+
+void VoltArray::assign(std::vector<Value> elements) {
+    elements_ = std::move(elements);
+    nonNumbers_ = 0;
+    for (const auto& element : elements_) {
+        if (!isNumber(element)) nonNumbers_++;
+    }
+}
+
+long long VoltArray::indexOf(const Value& value) const {
+    for (size_t i = 0; i < elements_.size(); i++) {
+        if (elements_[i] == value) return static_cast<long long>(i);
+    }
+    return -1;
+}
+
+// ==================== NUMERIC BULK OPERATIONS ====================
+
+namespace {
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+double numberAt(const double* numbers, size_t i) {
+    double d;
+    std::memcpy(&d, numbers + i, sizeof d);
+    return d;
+}
+
+// Results written straight into Value slots must keep NaNs canonical,
+// the same as Value(double) does
+void storeNumber(Value* out, double d) {
+    *out = Value(d);
+}
+
+#if defined(__SSE2__)
+void storeNumbers(Value* out, __m128d v) {
+    const __m128d nan = _mm_cmpunord_pd(v, v);
+    v = _mm_or_pd(_mm_andnot_pd(nan, v), _mm_and_pd(nan, _mm_set1_pd(kNaN)));
+    _mm_storeu_pd(reinterpret_cast<double*>(out), v);
+}
+#endif
+
+template <bool Max>
+Value extreme(const double* numbers, size_t n) {
+    if (n == 0) return nullptr;
+    double best = numberAt(numbers, 0);
+    bool sawNaN = false;
+    size_t i = 0;
+#if defined(__SSE2__)
+    if (n >= 2) {
+        __m128d acc = _mm_loadu_pd(numbers);
+        __m128d nan = _mm_setzero_pd();
+        for (; i + 2 <= n; i += 2) {
+            __m128d v = _mm_loadu_pd(numbers + i);
+            acc = Max ? _mm_max_pd(acc, v) : _mm_min_pd(acc, v);
+            nan = _mm_or_pd(nan, _mm_cmpunord_pd(v, v));
+        }
+        double lanes[2];
+        _mm_storeu_pd(lanes, acc);
+        best = Max ? std::max(lanes[0], lanes[1]) : std::min(lanes[0], lanes[1]);
+        sawNaN = _mm_movemask_pd(nan) != 0;
+    }
+#endif
+    for (; i < n; i++) {
+        double d = numberAt(numbers, i);
+        sawNaN |= std::isnan(d);
+        best = Max ? std::max(best, d) : std::min(best, d);
+    }
+    return sawNaN ? kNaN : best;
+}
+
+} // anonymous namespace
+
+const double* VoltArray::numbers(const char* operation) const {
+    if (nonNumbers_ != 0) {
+        throw std::runtime_error(std::string(operation) + "() needs an array of numbers");
+    }
+    return reinterpret_cast<const double*>(elements_.data());
+}
+
+double VoltArray::sum() const {
+    const double* numbers = this->numbers("sum");
+    const size_t n = elements_.size();
+    size_t i = 0;
+    double total = 0.0;
+#if defined(__SSE2__)
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_loadu_pd(numbers + i));
+        acc1 = _mm_add_pd(acc1, _mm_loadu_pd(numbers + i + 2));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(acc0, acc1));
+    total = lanes[0] + lanes[1];
+#endif
+    for (; i < n; i++) total += numberAt(numbers, i);
+    return total;
+}
+
+Value VoltArray::min() const {
+    return extreme<false>(numbers("min"), elements_.size());
+}
+
+Value VoltArray::max() const {
+    return extreme<true>(numbers("max"), elements_.size());
+}
+
+double VoltArray::dot(const VoltArray& other) const {
+    const double* a = numbers("dot");
+    const double* b = other.numbers("dot");
+    const size_t n = elements_.size();
+    if (other.elements_.size() != n) {
+        throw std::runtime_error("dot() needs arrays of the same length");
+    }
+    size_t i = 0;
+    double total = 0.0;
+#if defined(__SSE2__)
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(acc0, acc1));
+    total = lanes[0] + lanes[1];
+#endif
+    for (; i < n; i++) total += numberAt(a, i) * numberAt(b, i);
+    return total;
+}
+
+Ref<VoltArray> VoltArray::scale(double factor) const {
+    const double* numbers = this->numbers("scale");
+    const size_t n = elements_.size();
+    std::vector<Value> result(n);
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128d k = _mm_set1_pd(factor);
+    for (; i + 2 <= n; i += 2) {
+        storeNumbers(&result[i], _mm_mul_pd(_mm_loadu_pd(numbers + i), k));
+    }
+#endif
+    for (; i < n; i++) storeNumber(&result[i], numberAt(numbers, i) * factor);
+    return makeRef<VoltArray>(std::move(result));
+}
+
+Ref<VoltArray> VoltArray::add(const VoltArray& other) const {
+    const double* a = numbers("add");
+    const double* b = other.numbers("add");
+    const size_t n = elements_.size();
+    if (other.elements_.size() != n) {
+        throw std::runtime_error("add() needs arrays of the same length");
+    }
+    std::vector<Value> result(n);
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 2 <= n; i += 2) {
+        storeNumbers(&result[i], _mm_add_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+    }
+#endif
+    for (; i < n; i++) storeNumber(&result[i], numberAt(a, i) + numberAt(b, i));
+    return makeRef<VoltArray>(std::move(result));
+}
+
 std::string VoltArray::toString() const {
     std::ostringstream oss;
     oss << "[";
@@ -52,4 +326,13 @@ std::string VoltArray::toString() const {
     return oss.str();
 }
 
+void VoltArray::trace(Tracer& tracer) const {
+    for (const Value& element : elements_) tracer(element);
+}
+
+void VoltArray::clearReferences() {
+    elements_.clear();
+    nonNumbers_ = 0;
+}
+
 } // namespace volt
@@ -1,5 +1,6 @@
 #pragma once
 #include "value.h"
+#include "gc.h"
 #include <vector>
 #include <memory>
 #include <string>
@@ -14,8 +15,14 @@ namespace volt {
  * - Heterogeneous (can hold mixed types)
  * - Zero-indexed
  * - Have built-in methods (push, pop, length, etc.)
+ *
+ * A number Value is its plain double, so an array of numbers is already
+ * a packed double buffer. The array counts its non-number elements;
+ * while that count is zero the numeric bulk operations below run SIMD
+ * kernels straight over the buffer. They throw std::runtime_error if the
+ * array holds anything but numbers.
  */
-class VoltArray {
+class VoltArray : public GcObject {
 public:
     VoltArray() = default;
     explicit VoltArray(std::vector<Value> elements);
@@ -28,7 +35,42 @@ public:
     void push(Value value);
     Value pop();
     void reverse();
+    void insert(size_t index, Value value);   // index <= length()
+    void fill(const Value& value);
+    
+    // Removes 'count' elements from 'start' and returns them
+    // (start <= length(), start + count <= length())
+    Ref<VoltArray> splice(size_t start, size_t count);
+    
+    // Copying operations, each one pass with the result reserved up front
+    Ref<VoltArray> slice(size_t start, size_t end) const;  // [start, end)
+    Ref<VoltArray> concat(const VoltArray& other) const;
+    std::string join(const std::string& separator) const;
+    
+    // Sorts numbers ascending (NaNs last) or strings by bytes, with no
+    // comparator calls; false (array unchanged) if the elements are
+    // anything else or a mix
+    bool sortNatural();
+    
+    // Replaces the contents, e.g. with a sorted copy
+    void assign(std::vector<Value> elements);
+    
+    // Position of the first element equal to 'value' (as ==), or -1
+    long long indexOf(const Value& value) const;
+    
     size_t length() const { return elements_.size(); }
+    bool allNumbers() const { return nonNumbers_ == 0; }
+    
+    // Numeric bulk operations. sum() adds in several lanes, so rounding
+    // can differ from a left-to-right loop; min()/max() of an empty array
+    // are nil and any NaN makes them NaN. dot() and add() need arrays of
+    // equal length; scale() and add() return new arrays.
+    double sum() const;
+    Value min() const;
+    Value max() const;
+    double dot(const VoltArray& other) const;
+    Ref<VoltArray> scale(double factor) const;
+    Ref<VoltArray> add(const VoltArray& other) const;
     
     // Iteration
     const std::vector<Value>& elements() const { return elements_; }
@@ -36,8 +78,15 @@ public:
     // String representation
     std::string toString() const;
     
+    void trace(Tracer& tracer) const override;
+    void clearReferences() override;
+    size_t byteSize() const override { return sizeof(*this) + elements_.capacity() * sizeof(Value); }
+    
 private:
+    const double* numbers(const char* operation) const;
+    
     std::vector<Value> elements_;
+    size_t nonNumbers_ = 0;
 };
 
 } // namespace volt
@@ -10,31 +10,60 @@ namespace volt {
 // VoltFunction (User-defined functions)
 // ========================================
 
-VoltFunction::VoltFunction(FnStmt* declaration, 
-                           std::shared_ptr<Environment> closure)
-    : declaration_(declaration), closure_(closure) {}
+VoltFunction::VoltFunction(FnStmt* declaration, std::vector<Ref<Cell>> captures)
+    : declaration_(declaration), captures_(std::move(captures)) {}
 
 Value VoltFunction::call(Interpreter& interpreter, 
-                        const std::vector<Value>& arguments) {
+                        std::span<const Value> arguments) {
     // Create a new environment for this function call
-    // The closure is the parent (so we can access captured variables)
-    auto environment = std::make_shared<Environment>(closure_);
+    // Parameters and the body's locals share one slot array; variables of
+    // enclosing functions are reached through captures_. Frames come from
+    // the interpreter's pool and go straight back to it, since closures
+    // made during the call hold cells rather than the frame.
+    auto environment = interpreter.acquireScope(interpreter.globals_, declaration_->layout);
     
-    // Bind parameters to arguments
+    // Bind parameters to arguments (the Resolver gave them slots 0..n-1)
     for (size_t i = 0; i < declaration_->parameters.size(); i++) {
-        environment->define(declaration_->parameters[i], arguments[i]);
+        environment->defineAt(static_cast<int>(i), arguments[i]);
     }
     
-    // Execute the function body
-    try {
-        interpreter.executeBlock(declaration_->body, environment);
-    } catch (const ReturnValue& returnValue) {
-        // Return statement throws a special exception with the value
-        return returnValue.value;
-    }
+    // The body reads captured variables through the interpreter
+    struct CapturesScope {
+        Interpreter& interpreter;
+        const std::vector<Ref<Cell>>* previous;
+        ~CapturesScope() { interpreter.captures_ = previous; }
+    } capturesScope{interpreter, interpreter.captures_};
+    interpreter.captures_ = &captures_;
     
-    // If no return statement, functions return nil
-    return nullptr;
+    // Each 'return g(...)' of a script function replaces this call with
+    // g's, so tail recursion loops here instead of growing the C++ stack
+    VoltFunction* current = this;
+    Ref<VoltFunction> tailCalled;  // Keeps the running function alive
+    while (true) {
+        if (interpreter.executeBlock(current->declaration_->body, environment) != Completion::Return) {
+            // If no return statement, functions return nil
+            interpreter.releaseScope(environment);
+            return nullptr;
+        }
+        Ref<VoltFunction> next = interpreter.takeTailCall();
+        if (!next) {
+            // The return statement left its value in the interpreter
+            interpreter.releaseScope(environment);
+            return interpreter.takeReturnValue();
+        }
+        
+        // The old frame is done; the pool hands it straight back
+        interpreter.releaseScope(environment);
+        environment = interpreter.acquireScope(interpreter.globals_, next->declaration_->layout);
+        std::vector<Value>& nextArguments = interpreter.tailCallArguments();
+        for (size_t i = 0; i < nextArguments.size(); i++) {
+            environment->defineAt(static_cast<int>(i), std::move(nextArguments[i]));
+        }
+        interpreter.captures_ = &next->captures_;
+        
+        current = next.get();
+        tailCalled = std::move(next);
+    }
 }
 
 int VoltFunction::arity() const {
@@ -45,17 +74,48 @@ std::string VoltFunction::toString() const {
     return "<fn " + declaration_->name + ">";
 }
 
+void VoltFunction::trace(Tracer& tracer) const {
+    for (const auto& cell : captures_) tracer(cell);
+}
+
+void VoltFunction::clearReferences() {
+    captures_.clear();
+}
+
+size_t VoltFunction::byteSize() const {
+    return sizeof(*this) + captures_.capacity() * sizeof(Ref<Cell>);
+}
+
 // ========================================
 // NativeFunction (Built-in C++ functions)
 // ========================================
 
+NativeFunction::NativeFunction(Fn0 function, std::string name)
+    : arity_(0), kind_(Kind::Fixed0), fn0_(function), name_(std::move(name)) {}
+
+NativeFunction::NativeFunction(Fn1 function, std::string name)
+    : arity_(1), kind_(Kind::Fixed1), fn1_(function), name_(std::move(name)) {}
+
+NativeFunction::NativeFunction(Fn2 function, std::string name)
+    : arity_(2), kind_(Kind::Fixed2), fn2_(function), name_(std::move(name)) {}
+
+NativeFunction::NativeFunction(Fn3 function, std::string name)
+    : arity_(3), kind_(Kind::Fixed3), fn3_(function), name_(std::move(name)) {}
+
 NativeFunction::NativeFunction(int arity, NativeFn function, std::string name)
-    : arity_(arity), function_(function), name_(std::move(name)) {}
+    : arity_(arity), kind_(Kind::Span), fnN_(function), name_(std::move(name)) {}
+
+NativeFunction::NativeFunction(int arity, MethodFn function, Value self, std::string name)
+    : arity_(arity), kind_(Kind::Method), method_(function),
+      self_(std::move(self)), name_(std::move(name)) {}
 
 Value NativeFunction::call(Interpreter& interpreter, 
-                          const std::vector<Value>& arguments) {
+                          std::span<const Value> arguments) {
+    // Methods get the interpreter so they can call back into script code
+    if (kind_ == Kind::Method) return method_(interpreter, self_, arguments);
+    
     // Just call the C++ function we wrapped
-    return function_(arguments);
+    return invoke(arguments);
 }
 
 int NativeFunction::arity() const {
@@ -1,9 +1,10 @@
 #pragma once
 #include "value.h"
+#include "gc.h"
 #include <vector>
 #include <string>
 #include <memory>
-#include <functional>  // ← ADD THIS!
+#include <span>
 
 namespace volt {
 
@@ -22,13 +23,19 @@ class Environment;
  * This interface allows both user-defined functions and native functions
  * to work the same way in the interpreter.
  */
-class Callable {
+class Callable : public GcObject {
 public:
     virtual ~Callable() = default;
     
+    // Most callables hold no values; closures and bound methods override
+    void trace(Tracer&) const override {}
+    void clearReferences() override {}
+    size_t byteSize() const override { return sizeof(Callable); }
+    
     // Execute the function with given arguments
+    // The span points into the caller's storage and is only valid for the call
     virtual Value call(Interpreter& interpreter, 
-                      const std::vector<Value>& arguments) = 0;
+                      std::span<const Value> arguments) = 0;
     
     // How many parameters does this function expect?
     virtual int arity() const = 0;
@@ -41,22 +48,30 @@ public:
  * VoltFunction - User-defined functions from VoltScript code
  * 
  * These are functions written in VoltScript itself (using 'fn' keyword).
- * They capture their surrounding environment to support closures.
+ * A closure holds the cells of just the enclosing variables its body
+ * uses (FnStmt::captures), not the scopes around it, so it doesn't keep
+ * the rest of its defining function's locals alive. Calls run inside the
+ * calling interpreter's global scope, which the function doesn't own: a
+ * function stored in a global would otherwise keep that scope alive.
  */
 class VoltFunction : public Callable {
 public:
-    VoltFunction(struct FnStmt* declaration, 
-                 std::shared_ptr<Environment> closure);
+    VoltFunction(struct FnStmt* declaration, std::vector<Ref<Cell>> captures);
     
     Value call(Interpreter& interpreter, 
-              const std::vector<Value>& arguments) override;
+              std::span<const Value> arguments) override;
     
     int arity() const override;
     std::string toString() const override;
     
+    // A recursive closure and the cell holding it form a cycle
+    void trace(Tracer& tracer) const override;
+    void clearReferences() override;
+    size_t byteSize() const override;
+    
 private:
-    struct FnStmt* declaration_;           // The function's AST node
-    std::shared_ptr<Environment> closure_; // The environment where it was defined
+    struct FnStmt* declaration_;        // The function's AST node
+    std::vector<Ref<Cell>> captures_;   // Parallel to declaration_->captures
 };
 
 /**
@@ -64,22 +79,72 @@ private:
  * 
  * These are functions provided by the language runtime (like 'clock()').
  * They're implemented in C++ for performance or to access system features.
+ * 
+ * Natives are plain function pointers, so calling one is a direct call
+ * with no std::function and no argument vector:
+ * - Fixed 0-3 arguments: the arity comes from the signature and the
+ *   arguments are passed as individual references (the fast path)
+ * - Any other arity: the arguments arrive as a span
+ * - Methods (array.push, map.keys): bound to a receiver, which is passed
+ *   in front of the span along with the interpreter, so methods like
+ *   array.map can call script functions back
  */
 class NativeFunction : public Callable {
 public:
-    using NativeFn = std::function<Value(const std::vector<Value>&)>;
+    using Fn0 = Value (*)();
+    using Fn1 = Value (*)(const Value&);
+    using Fn2 = Value (*)(const Value&, const Value&);
+    using Fn3 = Value (*)(const Value&, const Value&, const Value&);
+    using NativeFn = Value (*)(std::span<const Value> args);
+    using MethodFn = Value (*)(Interpreter& interpreter, const Value& self,
+                               std::span<const Value> args);
     
+    NativeFunction(Fn0 function, std::string name);
+    NativeFunction(Fn1 function, std::string name);
+    NativeFunction(Fn2 function, std::string name);
+    NativeFunction(Fn3 function, std::string name);
     NativeFunction(int arity, NativeFn function, std::string name);
+    NativeFunction(int arity, MethodFn function, Value self, std::string name);
     
     Value call(Interpreter& interpreter, 
-              const std::vector<Value>& arguments) override;
+              std::span<const Value> arguments) override;
+    
+    // Calls the function pointer directly (arity already checked);
+    // methods go through call(), which has the interpreter
+    Value invoke(std::span<const Value> args) const {
+        switch (kind_) {
+            case Kind::Fixed0: return fn0_();
+            case Kind::Fixed1: return fn1_(args[0]);
+            case Kind::Fixed2: return fn2_(args[0], args[1]);
+            case Kind::Fixed3: return fn3_(args[0], args[1], args[2]);
+            case Kind::Span: return fnN_(args);
+            case Kind::Method: break;
+        }
+        return nullptr;
+    }
     
     int arity() const override;
     std::string toString() const override;
     
+    // A bound method holds its receiver
+    void trace(Tracer& tracer) const override { tracer(self_); }
+    void clearReferences() override { self_ = nullptr; }
+    size_t byteSize() const override { return sizeof(*this); }
+    
 private:
+    enum class Kind : uint8_t { Fixed0, Fixed1, Fixed2, Fixed3, Span, Method };
+    
     int arity_;
-    NativeFn function_;
+    Kind kind_;
+    union {
+        Fn0 fn0_;
+        Fn1 fn1_;
+        Fn2 fn2_;
+        Fn3 fn3_;
+        NativeFn fnN_;
+        MethodFn method_;
+    };
+    Value self_;  // Receiver of a bound method
     std::string name_;
 };
 
@@ -1,9 +1,255 @@
 #include "hashmap.h"
-#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 
 namespace volt {
 
-// Nothing needed here for now - the hashmap implementation is header-only
-// since it's mostly template/inline methods
+// ==================== KEYS ====================
 
-} // namespace volt
\ No newline at end of file
+namespace {
+
+// The number, bool or nil a string spells the way valueToString prints
+// it, if any. Only text starting with a digit, '-', 't', 'f' or 'n' can,
+// so most string keys are ruled out by their first character.
+std::optional<Value> scalarSpelledBy(std::string_view text) {
+    if (text.empty()) return std::nullopt;
+    char first = text[0];
+    if ((first >= '0' && first <= '9') || first == '-') {
+        std::string chars(text);
+        char* end = nullptr;
+        double number = std::strtod(chars.c_str(), &end);
+        if (end != chars.c_str() + chars.size() || !std::isfinite(number)) return std::nullopt;
+        if (valueToString(number) != text) return std::nullopt;  // "01", "1.50", "1e3" stay strings
+        return Value(number == 0 ? 0.0 : number);
+    }
+    if (text == "true") return Value(true);
+    if (text == "false") return Value(false);
+    if (text == "nil") return Value();
+    return std::nullopt;
+}
+
+} // anonymous namespace
+
+std::optional<Value> VoltHashMap::keyFor(const Value& index, bool intern) {
+    if (isNumber(index)) {
+        return asNumber(index) == 0 ? Value(0.0) : index;  // -0 and 0 are one key
+    }
+    if (isBool(index) || isNil(index)) return index;
+    if (!isString(index)) return keyFor(std::string_view(valueToString(index)), intern);
+
+    const StringObject* string = asStringObject(index);
+    if (auto scalar = scalarSpelledBy(string->view())) return scalar;
+    if (string->isInterned()) return index;
+    if (StringObject* interned = StringObject::findInterned(string)) {
+        return Value(Ref<StringObject>(interned));
+    }
+    if (intern) return Value(StringObject::intern(string->view()));
+    return std::nullopt;
+}
+
+std::optional<Value> VoltHashMap::keyFor(std::string_view text, bool intern) {
+    if (auto scalar = scalarSpelledBy(text)) return scalar;
+    if (intern) return Value(StringObject::intern(text));
+    if (StringObject* interned = StringObject::findInterned(text)) {
+        return Value(Ref<StringObject>(interned));
+    }
+    return std::nullopt;
+}
+
+// ==================== FIELDS ====================
+
+size_t VoltHashMap::findField(FieldCache& cache, std::string_view name) const {
+    if (isNil(cache.key)) cache.key = *keyFor(name, true);  // Field names are never "nil"
+    size_t position = data.shape()->find(cache.key);
+    if (position != Shape::kNotFound && data.shape()->isShared()) {
+        cache.shape = data.shape();
+        cache.position = position;
+    }
+    return position;
+}
+
+void VoltHashMap::storeField(FieldCache& cache, std::string_view name, const Value& value) {
+    if (isNil(cache.key)) cache.key = *keyFor(name, true);
+    data.set(cache.key, value);
+    if (data.shape()->isShared()) {
+        cache.shape = data.shape();
+        cache.position = data.shape()->find(cache.key);
+    }
+}
+
+// ==================== SHAPES ====================
+
+const Ref<Shape>& Shape::empty() {
+    static const Ref<Shape>* root = new Ref<Shape>(new Shape(false));  // Never destroyed
+    return *root;
+}
+
+Ref<Shape> Shape::dictionary(std::vector<Value> keys) {
+    Ref<Shape> shape(new Shape(true));
+    shape->keys_ = std::move(keys);
+    size_t slotCount = kMinSlots;
+    while (shape->keys_.size() * 4 > slotCount * 3) slotCount *= 2;
+    shape->rebuildIndex(slotCount);
+    return shape;
+}
+
+Shape::~Shape() {
+    if (parent_) std::erase(parent_->transitions_, this);
+}
+
+const Value& Shape::removedKey() {
+    static const Value removed(StringObject::create("<removed>"));
+    return removed;
+}
+
+Ref<Shape> Shape::withKey(const Value& key) {
+    for (Shape* child : transitions_) {
+        if (child->keys_.back().bits() == key.bits()) return Ref<Shape>(child);
+    }
+    if (keys_.size() >= kMaxSharedKeys || transitions_.size() >= kMaxTransitions) {
+        Ref<Shape> dictionary = copy();
+        dictionary->append(key);
+        return dictionary;
+    }
+
+    Ref<Shape> child(new Shape(false));
+    child->keys_ = keys_;
+    child->slots_ = slots_;
+    child->add(key);
+    child->parent_ = Ref<Shape>(this);
+    transitions_.push_back(child.get());
+    return child;
+}
+
+Ref<Shape> Shape::copy() const {
+    Ref<Shape> shape(new Shape(true));
+    shape->keys_ = keys_;
+    shape->slots_ = slots_;
+    shape->removed_ = removed_;
+    return shape;
+}
+
+void Shape::append(Value key) {
+    add(std::move(key));
+}
+
+void Shape::removeAt(size_t position) {
+    const uint32_t hash = hashOf(keys_[position]);
+    size_t hole = hash & mask();
+    while (slots_[hole].position != position) hole = (hole + 1) & mask();
+    keys_[position] = removedKey();
+    removed_++;
+
+    // Backward-shift deletion: pull later slots of the probe run into the
+    // hole unless that would move them before their home slot
+    slots_[hole] = Slot{};
+    for (size_t i = (hole + 1) & mask(); slots_[i].position != kEmpty; i = (i + 1) & mask()) {
+        size_t home = slots_[i].hash & mask();
+        if (((i - home) & mask()) < ((i - hole) & mask())) continue;
+        slots_[hole] = slots_[i];
+        slots_[i] = Slot{};
+        hole = i;
+    }
+}
+
+void Shape::add(Value key) {
+    // Grow before the index passes 3/4 full
+    if ((keys_.size() - removed_ + 1) * 4 > slots_.size() * 3) {
+        rebuildIndex(std::max(kMinSlots, slots_.size() * 2));
+    }
+    const uint32_t hash = hashOf(key);
+    keys_.push_back(std::move(key));
+    place(static_cast<uint32_t>(keys_.size() - 1), hash);
+}
+
+void Shape::place(uint32_t position, uint32_t hash) {
+    size_t i = hash & mask();
+    while (slots_[i].position != kEmpty) i = (i + 1) & mask();
+    slots_[i] = Slot{position, hash};
+}
+
+void Shape::rebuildIndex(size_t slotCount) {
+    slots_.assign(slotCount, Slot{});
+    for (size_t position = 0; position < keys_.size(); position++) {
+        if (!isRemoved(position)) {
+            place(static_cast<uint32_t>(position), hashOf(keys_[position]));
+        }
+    }
+}
+
+// ==================== HASH TABLE ====================
+
+HashTable::HashTable(const HashTable& other)
+    : shape_(other.shape_->isShared() ? other.shape_ : other.shape_->copy()),
+      values_(other.values_) {}
+
+HashTable& HashTable::operator=(const HashTable& other) {
+    if (this != &other) {
+        shape_ = other.shape_->isShared() ? other.shape_ : other.shape_->copy();
+        values_ = other.values_;
+    }
+    return *this;
+}
+
+void HashTable::set(Value key, Value value) {
+    size_t position = shape_->find(key);
+    if (position != Shape::kNotFound) {
+        values_[position] = std::move(value);
+        return;
+    }
+    if (shape_->isShared()) {
+        shape_ = shape_->withKey(key);
+    } else {
+        shape_->append(std::move(key));
+    }
+    values_.push_back(std::move(value));
+}
+
+bool HashTable::remove(const Value& key) {
+    size_t position = shape_->find(key);
+    if (position == Shape::kNotFound) return false;
+
+    if (shape_->isShared()) shape_ = shape_->copy();
+    shape_->removeAt(position);
+    values_[position] = nullptr;
+
+    if (shape_->removed() > kMinCompact && shape_->removed() > size()) compact();
+    return true;
+}
+
+void HashTable::clear() {
+    shape_ = Shape::empty();
+    values_.clear();
+}
+
+void HashTable::assign(Ref<Shape> shape, std::vector<Value> values) {
+    shape_ = std::move(shape);
+    values_ = std::move(values);
+}
+
+bool HashTable::operator==(const HashTable& other) const {
+    if (size() != other.size()) return false;
+    for (const auto& entry : *this) {
+        const Value* value = other.find(entry.key);
+        if (!value || *value != entry.value) return false;
+    }
+    return true;
+}
+
+// Drops removed keys and their values, keeping the live ones in order
+void HashTable::compact() {
+    std::vector<Value> keys;
+    std::vector<Value> values;
+    keys.reserve(size());
+    values.reserve(size());
+    for (size_t position = 0; position < values_.size(); position++) {
+        if (shape_->isRemoved(position)) continue;
+        keys.push_back(shape_->keyAt(position));
+        values.push_back(std::move(values_[position]));
+    }
+    shape_ = Shape::dictionary(std::move(keys));
+    values_ = std::move(values);
+}
+
+} // namespace volt
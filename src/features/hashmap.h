@@ -1,9 +1,13 @@
 #pragma once
 #include <unordered_map>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <memory>
 #include <vector>
+#include <cstdint>
 #include "value.h"
+#include "gc.h"
 
 namespace volt {
 
@@ -11,86 +15,365 @@ namespace volt {
 struct VoltHashMap;
 
 // Shared pointer type for hash maps
-using HashMapPtr = std::shared_ptr<VoltHashMap>;
+using HashMapPtr = Ref<VoltHashMap>;
+
+/**
+ * Shape - The key layout of a hash map (a "hidden class")
+ *
+ * A shape lists a map's keys in insertion order, with an open-addressing
+ * index of {key position, hash} slots, probed linearly, to find them. The
+ * map itself only stores values, at the same positions, so a map whose
+ * shape is known turns a key lookup into values[position].
+ *
+ * Shared shapes are immutable and form a transition tree from empty():
+ * adding key k to a map of shape S moves it to the child of S for k,
+ * created once and found again by every later map built the same way. All
+ * maps built from one literal layout ({"name": .., "age": ..}) therefore
+ * end up with the same Shape, which is what lets an inline cache (see
+ * FieldCache) remember one position for a whole family of records.
+ * Children hold their parent; a parent only keeps a weak list of its
+ * children, which unlink themselves when the last map using them goes.
+ *
+ * A map that removes a key, grows past kMaxSharedKeys or adds a key to a
+ * shape with kMaxTransitions children already (a map used as a
+ * dictionary, not a record) switches to a dictionary shape: a private
+ * copy it changes in place. Removal marks the key removed (iteration
+ * skips it) and shifts the following slots back, so the index never holds
+ * tombstones.
+ */
+class Shape : public Object {
+public:
+    static constexpr size_t kNotFound = SIZE_MAX;
+    static constexpr size_t kMaxSharedKeys = 32;
+    static constexpr size_t kMaxTransitions = 16;
+
+    // The shared shape with no keys, root of every transition
+    static const Ref<Shape>& empty();
+
+    // A new dictionary shape holding these keys (canonical, distinct)
+    static Ref<Shape> dictionary(std::vector<Value> keys);
+
+    ~Shape() override;
+
+    bool isShared() const { return !dictionary_; }
+
+    // Key positions in use, removed ones included
+    size_t count() const { return keys_.size(); }
+    size_t removed() const { return removed_; }
+    const Value& keyAt(size_t position) const { return keys_[position]; }
+    bool isRemoved(size_t position) const { return keys_[position].bits() == removedKey().bits(); }
+
+    // Position of a canonical key, or kNotFound
+    size_t find(const Value& key) const {
+        if (slots_.empty()) return kNotFound;
+        const uint32_t hash = hashOf(key);
+        for (size_t i = hash & mask(); slots_[i].position != kEmpty; i = (i + 1) & mask()) {
+            const Slot& slot = slots_[i];
+            if (slot.hash == hash && keys_[slot.position].bits() == key.bits()) {
+                return slot.position;
+            }
+        }
+        return kNotFound;
+    }
+
+    // Shared shapes: the shape with 'key' added at the end (the cached
+    // transition), or a new dictionary shape past the sharing limits
+    Ref<Shape> withKey(const Value& key);
+
+    // A dictionary copy of this shape
+    Ref<Shape> copy() const;
+
+    // Dictionary shapes only: add a key at the end, or mark one removed
+    void append(Value key);
+    void removeAt(size_t position);
+
+    // Strings hash their characters (cached on the string), everything
+    // else its bits
+    static uint32_t hashOf(const Value& key) {
+        if (isString(key)) return static_cast<uint32_t>(asStringObject(key)->hash());
+        uint64_t bits = key.bits();  // splitmix64 finalizer: small integers differ in high bits only
+        bits = (bits ^ (bits >> 30)) * 0xbf58476d1ce4e5b9ull;
+        bits = (bits ^ (bits >> 27)) * 0x94d049bb133111ebull;
+        return static_cast<uint32_t>(bits ^ (bits >> 31));
+    }
+
+private:
+    static constexpr uint32_t kEmpty = UINT32_MAX;
+    static constexpr size_t kMinSlots = 8;
+
+    struct Slot {
+        uint32_t position = kEmpty;  // Index into keys_
+        uint32_t hash = 0;           // hashOf(key)
+    };
+
+    explicit Shape(bool dictionary) : dictionary_(dictionary) {}
+
+    // A string no lookup can produce (never interned)
+    static const Value& removedKey();
+
+    size_t mask() const { return slots_.size() - 1; }
+    void add(Value key);
+    void place(uint32_t position, uint32_t hash);
+    void rebuildIndex(size_t slotCount);
+
+    std::vector<Value> keys_;  // Insertion order; removedKey() once removed
+    std::vector<Slot> slots_;  // Power-of-two size, at most 3/4 full
+    size_t removed_ = 0;
+    bool dictionary_;
+
+    Ref<Shape> parent_;                // Shared shapes: the shape this one extends
+    std::vector<Shape*> transitions_;  // Shared shapes: children, weak
+};
+
+/**
+ * FieldCache - Monomorphic inline cache for one obj.field site
+ *
+ * Remembers the last shared Shape seen at the site and the position of
+ * the field in it, so a map of that shape reads and writes the field
+ * without hashing. Any other shape takes the slow path, which refills the
+ * cache (dictionary shapes are never cached: they change in place).
+ */
+struct FieldCache {
+    Value key;         // The field name, interned on first use
+    Ref<Shape> shape;  // Shape the position is valid for
+    size_t position = 0;
+};
+
+/**
+ * HashTable - Insertion-ordered hash table keyed by canonical key Values
+ *
+ * Keys are interned strings, numbers, bools or nil in the canonical form
+ * VoltHashMap::keyFor() gives them, so two keys are equal exactly when
+ * their bits are: a pointer compare for strings, no formatting for
+ * numbers.
+ *
+ * The keys and their index live in the table's Shape; the table holds the
+ * values in a dense vector at the same positions, so iteration (and so
+ * keys(), values() and printing) follows insertion order. A dictionary
+ * shape is compacted, together with the values, once removed keys
+ * outnumber live ones.
+ */
+class HashTable {
+public:
+    struct Entry {
+        const Value& key;
+        const Value& value;
+    };
+
+    // Walks live entries in insertion order
+    class Iterator {
+    public:
+        Iterator(const HashTable& table, size_t at) : table_(table), at_(at) { skipRemoved(); }
+        Entry operator*() const { return {table_.shape_->keyAt(at_), table_.values_[at_]}; }
+        Iterator& operator++() {
+            ++at_;
+            skipRemoved();
+            return *this;
+        }
+        bool operator!=(const Iterator& other) const { return at_ != other.at_; }
+        bool operator==(const Iterator& other) const { return at_ == other.at_; }
+    private:
+        void skipRemoved() {
+            while (at_ != table_.values_.size() && table_.shape_->isRemoved(at_)) ++at_;
+        }
+        const HashTable& table_;
+        size_t at_;
+    };
+
+    HashTable() : shape_(Shape::empty()) {}
+
+    // Copies share a shared shape and clone a dictionary one
+    HashTable(const HashTable& other);
+    HashTable& operator=(const HashTable& other);
+
+    size_t size() const { return values_.size() - shape_->removed(); }
+    bool empty() const { return size() == 0; }
+    size_t capacity() const { return values_.capacity(); }  // Value slots allocated
+
+    Iterator begin() const { return {*this, 0}; }
+    Iterator end() const { return {*this, values_.size()}; }
+
+    // The value stored under a canonical key, or nullptr
+    const Value* find(const Value& key) const {
+        size_t position = shape_->find(key);
+        return position == Shape::kNotFound ? nullptr : &values_[position];
+    }
+
+    // Adds the key at the end, or overwrites its value in place
+    void set(Value key, Value value);
+    bool remove(const Value& key);
+    void clear();
+
+    // The current layout and the value at a position in it
+    const Ref<Shape>& shape() const { return shape_; }
+    const Value& at(size_t position) const { return values_[position]; }
+    Value& at(size_t position) { return values_[position]; }
+
+    // Takes a shared shape and one value per key (a literal's layout)
+    void assign(Ref<Shape> shape, std::vector<Value> values);
+
+    // Same keys mapped to equal values, in any order
+    bool operator==(const HashTable& other) const;
+
+private:
+    static constexpr size_t kMinCompact = 8;
+
+    void compact();
+
+    Ref<Shape> shape_;
+    std::vector<Value> values_;  // One per shape position; nil once removed
+};
 
 /**
  * @brief Hash map/dictionary implementation for VoltScript
- * 
- * Stores key-value pairs where keys are strings and values can be any VoltScript type
+ *
+ * Stores key-value pairs where keys are strings, numbers, booleans or nil
+ * and values can be any VoltScript type. Keys keep their type (see
+ * keyFor()), so map[i] hashes the number i rather than formatting it.
+ * String keys are interned StringObjects: hashing reuses the string's
+ * cached hash and key comparison is a pointer compare. Lookups by a string
+ * that was never interned miss without allocating. Keys iterate in
+ * insertion order (see HashTable).
  */
-struct VoltHashMap {
-    std::unordered_map<std::string, Value> data;
-    
+struct VoltHashMap : GcObject {
+    HashTable data;
+
     // Constructor
     VoltHashMap() = default;
-    
+
     // Copy constructor
-    VoltHashMap(const std::unordered_map<std::string, Value>& initialData) : data(initialData) {}
-    
+    VoltHashMap(const std::unordered_map<std::string, Value>& initialData) {
+        for (const auto& [key, value] : initialData) {
+            data.set(*keyFor(std::string_view(key), true), value);
+        }
+    }
+
+    // The canonical key a script value is stored under, the same for
+    // reads and writes:
+    // - numbers, bools and nil are themselves (-0 becomes 0)
+    // - a string spelling a number, bool or nil the way print shows it
+    //   ("1", "2.5", "true", "nil") is that value, so map[1] and map["1"]
+    //   are one entry
+    // - other strings are interned; with 'intern' false, a string that was
+    //   never interned gives nullopt (it can't be a key yet)
+    // - anything else keys by its printed form
+    static std::optional<Value> keyFor(const Value& index, bool intern);
+    static std::optional<Value> keyFor(std::string_view text, bool intern);
+
+    // Types that are keys as they are (others go through their printed form)
+    static bool isKeyType(const Value& index) {
+        return isString(index) || isNumber(index) || isBool(index) || isNil(index);
+    }
+
     // Get the number of key-value pairs
     size_t size() const { return data.size(); }
-    
+
     // Check if the hash map is empty
     bool empty() const { return data.empty(); }
-    
-    // Check if a key exists
-    bool contains(const std::string& key) const {
-        return data.find(key) != data.end();
-    }
-    
-    // Get value by key (returns nullptr if not found)
-    Value get(const std::string& key) const {
-        auto it = data.find(key);
-        if (it != data.end()) {
-            return it->second;
-        }
-        return nullptr; // Return nil if key doesn't exist
+
+    // Check if a key exists (strings, numbers, bools and nil; other values
+    // by their printed form)
+    bool contains(const Value& index) const { return find(keyFor(index, false)); }
+
+    // Get value by key (returns nil if not found)
+    Value get(const Value& index) const { return valueOr(find(keyFor(index, false))); }
+
+    // Get by a string object (no copy of the characters)
+    Value get(const StringObject* key) const {
+        return key ? valueOr(find(keyFor(key->view(), false))) : Value();
     }
-    
+
     // Set key-value pair
-    void set(const std::string& key, const Value& value) {
-        data[key] = value;
+    void set(const Value& index, const Value& value) { data.set(*keyFor(index, true), value); }
+    void set(const StringObject* key, const Value& value) {
+        data.set(*keyFor(key->view(), true), value);
     }
-    
+
     // Remove a key-value pair
-    bool remove(const std::string& key) {
-        return data.erase(key) > 0;
+    bool remove(const Value& index) {
+        auto key = keyFor(index, false);
+        return key && data.remove(*key);
     }
-    
-    // Get all keys as a vector
+
+    // Get all keys as a vector (in their printed form)
     std::vector<std::string> getKeys() const {
         std::vector<std::string> keys;
         keys.reserve(data.size());
-        for (const auto& pair : data) {
-            keys.push_back(pair.first);
+        for (const auto& entry : data) {
+            keys.push_back(isString(entry.key) ? asString(entry.key) : valueToString(entry.key));
         }
         return keys;
     }
-    
+
     // Get all values as a vector
     std::vector<Value> getValues() const {
         std::vector<Value> values;
         values.reserve(data.size());
-        for (const auto& pair : data) {
-            values.push_back(pair.second);
+        for (const auto& entry : data) {
+            values.push_back(entry.value);
         }
         return values;
     }
-    
+
+    // obj.field: the value under the field name, nil if missing. A map
+    // with the shape the site's cache saw last is read by position.
+    Value getField(FieldCache& cache, std::string_view name) const {
+        if (data.shape() == cache.shape) return data.at(cache.position);
+        size_t position = findField(cache, name);
+        return position == Shape::kNotFound ? Value() : data.at(position);
+    }
+
+    // obj.field = value, through the same cache
+    void setField(FieldCache& cache, std::string_view name, const Value& value) {
+        if (data.shape() == cache.shape) {
+            data.at(cache.position) = value;
+            return;
+        }
+        storeField(cache, name, value);
+    }
+
+    // The shape later maps built from the same constant-keyed literal can
+    // take as is: this map's, if it is shared and has one key per pair
+    // (repeated keys collapse, so positions wouldn't match the pairs)
+    Ref<Shape> layoutFor(size_t pairCount) const {
+        const Ref<Shape>& shape = data.shape();
+        return shape->isShared() && shape->count() == pairCount ? shape : nullptr;
+    }
+
     // Clear all entries
     void clear() { data.clear(); }
-    
+
     // Equality comparison
     bool operator==(const VoltHashMap& other) const {
         return data == other.data;
     }
-    
+
     // Merge another hash map into this one
     void merge(const VoltHashMap& other) {
         for (const auto& [key, value] : other.data) {
-            data[key] = value;
+            data.set(key, value);
         }
     }
+
+    // Keys are strings and scalars, so only values can lead to a cycle
+    void trace(Tracer& tracer) const override {
+        for (const auto& entry : data) tracer(entry.value);
+    }
+    void clearReferences() override { data.clear(); }
+    size_t byteSize() const override { return sizeof(*this) + data.capacity() * sizeof(Value); }
+
+private:
+    // Cache misses: look the field up by key and remember its position
+    // if the shape is shared
+    size_t findField(FieldCache& cache, std::string_view name) const;
+    void storeField(FieldCache& cache, std::string_view name, const Value& value);
+
+    const Value* find(const std::optional<Value>& key) const {
+        return key ? data.find(*key) : nullptr;  // nullopt: never interned, so never a key
+    }
+    static Value valueOr(const Value* value) {
+        return value ? *value : Value();  // nil if the key doesn't exist
+    }
 };
 
-} // namespace volt
\ No newline at end of file
+} // namespace volt
@@ -3,52 +3,156 @@
 
 namespace volt {
 
+Environment::Environment()
+    : slots_(inlineSlots_),
+      values_(std::make_unique<std::unordered_map<std::string, Value>>()) {}
+
+Environment::Environment(std::shared_ptr<Environment> enclosing, const ScopeLayout& layout)
+    : slots_(inlineSlots_),
+      enclosing_(std::move(enclosing)) {
+    setLayout(layout);
+}
+
+Environment::~Environment() {
+    // Caches may point into this global scope's table
+    if (!enclosing_ && values_) {
+        globalVersion_++;
+    }
+}
+
 void Environment::define(const std::string& name, Value value) {
-    values_[name] = value;
+    // Local scopes only get a name table if something defines by name
+    if (!values_) {
+        values_ = std::make_unique<std::unordered_map<std::string, Value>>();
+    }
+    auto [it, inserted] = values_->try_emplace(name, value);
+    if (!inserted) {
+        it->second = std::move(value);
+        globalVersion_++;  // Redefinition (REPL): drop cached lookups
+    }
 }
 
-Value Environment::get(const std::string& name) const {  
+Value Environment::get(const std::string& name) const {
     // Check current scope
-    auto it = values_.find(name);
-    if (it != values_.end()) {
-        return it->second;
+    if (values_) {
+        auto it = values_->find(name);
+        if (it != values_->end()) {
+            return it->second;
+        }
+    }
+    int slot = findSlot(name);
+    if (slot >= 0) {
+        return load(slots_[slot]);
     }
-    
+
     // Check enclosing scope
     if (enclosing_) {
         return enclosing_->get(name);
     }
-    
+
     throw std::runtime_error("Undefined variable: " + name);
 }
 
 void Environment::assign(const std::string& name, Value value) {
     // Check current scope
-    auto it = values_.find(name);
-    if (it != values_.end()) {
-        it->second = value;
+    if (values_) {
+        auto it = values_->find(name);
+        if (it != values_->end()) {
+            it->second = value;
+            return;
+        }
+    }
+    int slot = findSlot(name);
+    if (slot >= 0) {
+        store(slots_[slot], value);
         return;
     }
-    
+
     // Check enclosing scope
     if (enclosing_) {
         enclosing_->assign(name, value);
         return;
     }
-    
+
     throw std::runtime_error("Undefined variable: " + name);
 }
 
 bool Environment::exists(const std::string& name) const {
-    if (values_.find(name) != values_.end()) {
+    if (values_ && values_->find(name) != values_->end()) {
         return true;
     }
-    
+    if (findSlot(name) >= 0) {
+        return true;
+    }
+
     if (enclosing_) {
         return enclosing_->exists(name);
     }
-    
+
     return false;
 }
 
+Value* Environment::refreshGlobal(const std::string& name, GlobalCache& cache) {
+    if (!values_) return nullptr;
+    auto it = values_->find(name);
+    if (it == values_->end()) return nullptr;
+    cache = {this, globalVersion_, &it->second};
+    return &it->second;
+}
+
+void Environment::clearSlots() {
+    for (size_t i = 0; i < slotCount_; i++) {
+        if (slots_[i].isObject(Value::Tag::Cell)) {
+            slots_[i] = makeRef<Cell>();
+        } else {
+            slots_[i] = nullptr;
+        }
+    }
+}
+
+void Environment::reuse(std::shared_ptr<Environment> enclosing, const ScopeLayout& layout) {
+    enclosing_ = std::move(enclosing);
+    setLayout(layout);
+}
+
+void Environment::retire() {
+    for (size_t i = 0; i < slotCount_; i++) {
+        slots_[i] = nullptr;
+    }
+    values_.reset();
+    enclosing_.reset();
+    slotNames_ = nullptr;
+    slotCount_ = 0;
+}
+
+// Size the slot array for 'layout' (its slots are all nil) and give the
+// captured slots their cells
+void Environment::setLayout(const ScopeLayout& layout) {
+    slotNames_ = &layout.names;
+    slotCount_ = layout.names.size();
+    if (slotCount_ <= kInlineSlots) {
+        slots_ = inlineSlots_;
+    } else {
+        if (slotCount_ > heapCapacity_) {
+            heapSlots_ = std::make_unique<Value[]>(slotCount_);
+            heapCapacity_ = slotCount_;
+        }
+        slots_ = heapSlots_.get();
+    }
+    for (int slot : layout.cells) {
+        slots_[slot] = makeRef<Cell>();
+    }
+}
+
+// Later slots shadow earlier ones (a repeated parameter name)
+int Environment::findSlot(const std::string& name) const {
+    if (!slotNames_) return -1;
+    for (size_t i = slotCount_; i-- > 0;) {
+        if ((*slotNames_)[i] == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
 } // namespace volt
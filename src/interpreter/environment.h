@@ -1,32 +1,151 @@
 #pragma once
 #include "value.h"
+#include "gc.h"
+#include <cstdint>
 #include <unordered_map>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace volt {
 
+class Environment;
+
+// Inline cache for one global name at one use site (an AST node or a
+// bytecode name slot). See Environment::lookupGlobal.
+struct GlobalCache {
+    const Environment* owner = nullptr;
+    uint64_t version = 0;
+    Value* slot = nullptr;
+};
+
+// A local variable that a nested function captures. Its slot holds the
+// cell rather than the value, so the scope and every closure that
+// captured it share one variable; a closure keeps only the cells it
+// uses, not the scopes around it.
+struct Cell : GcObject {
+    Value value;
+
+    void trace(Tracer& tracer) const override { tracer(value); }
+    void clearReferences() override { value = nullptr; }
+    size_t byteSize() const override { return sizeof(*this); }
+};
+
+inline Cell* asCell(const Value& v) {
+    return static_cast<Cell*>(v.object());
+}
+
+// The variables of one block, loop or call scope, laid out by the Resolver
+struct ScopeLayout {
+    std::vector<std::string> names;  // Slot -> name
+    std::vector<int> cells;          // Slots nested functions capture
+};
+
 // Variable storage and scoping
+//
+// The global scope stores variables by name. Block, loop and function
+// scopes are a flat array of slots assigned by the Resolver, read with
+// getAt(depth, slot) instead of a string lookup per enclosing scope.
+// Small scopes keep their slots inline, so entering one costs a single
+// allocation and no hash table. Slot names live in a side table owned
+// by the AST and are only used for name-based lookups (debugging, REPL).
+// Captured slots get a fresh Cell when the scope is entered or cleared;
+// the slot accessors read and write through it.
 class Environment {
 public:
-    Environment() : enclosing_(nullptr) {}
-    explicit Environment(std::shared_ptr<Environment> enclosing) 
-        : enclosing_(enclosing) {}
-    
+    // Scopes with up to this many variables need no separate slot array
+    static constexpr size_t kInlineSlots = 4;
+
+    // Global scope
+    Environment();
+
+    // Local scope with the slots of 'layout'
+    Environment(std::shared_ptr<Environment> enclosing, const ScopeLayout& layout);
+
+    ~Environment();
+
+    Environment(const Environment&) = delete;
+    Environment& operator=(const Environment&) = delete;
+
     // Define new variable
     void define(const std::string& name, Value value);
-    
+
     // Get variable value
     Value get(const std::string& name) const;
-    
+
     // Assign to existing variable
     void assign(const std::string& name, Value value);
-    
+
     // Check if variable exists
     bool exists(const std::string& name) const;
 
+    // Storage of a global, or nullptr if it isn't defined. Hash table
+    // entries never move, so 'cache' remembers the pointer and later
+    // lookups from the same site skip hashing the name. Redefining a
+    // global or destroying a global scope bumps the version, which
+    // invalidates every cache at once.
+    Value* lookupGlobal(const std::string& name, GlobalCache& cache) {
+        if (cache.owner == this && cache.version == globalVersion_) {
+            return cache.slot;
+        }
+        return refreshGlobal(name, cache);
+    }
+
+    // Resolved access: 'depth' scopes up, then index 'slot'
+    void defineAt(int slot, Value value) { store(slots_[slot], std::move(value)); }
+    const Value& getAt(int depth, int slot) { return load(ancestor(depth)->slots_[slot]); }
+    void assignAt(int depth, int slot, Value value) { store(ancestor(depth)->slots_[slot], std::move(value)); }
+
+    // The cell of a captured slot, for a closure being created
+    Ref<Cell> cellAt(int depth, int slot) { return Ref<Cell>(ancestor(depth)->slots_[slot].object()); }
+
+    // Set every slot back to nil so a loop body can run in this scope again
+    // (captured slots get new cells: earlier closures keep the old ones)
+    void clearSlots();
+
+    // Turn a retired scope into a fresh one for another activation
+    // (see Interpreter::acquireScope); keeps its slot storage
+    void reuse(std::shared_ptr<Environment> enclosing, const ScopeLayout& layout);
+
+    // Drop everything the scope holds before it waits for reuse
+    void retire();
+
 private:
-    std::unordered_map<std::string, Value> values_;
+    Environment* ancestor(int depth) {
+        Environment* env = this;
+        for (int i = 0; i < depth; i++) {
+            env = env->enclosing_.get();
+        }
+        return env;
+    }
+
+    static const Value& load(const Value& slot) {
+        return slot.isObject(Value::Tag::Cell) ? asCell(slot)->value : slot;
+    }
+    static void store(Value& slot, Value value) {
+        if (slot.isObject(Value::Tag::Cell)) {
+            asCell(slot)->value = std::move(value);
+        } else {
+            slot = std::move(value);
+        }
+    }
+
+    void setLayout(const ScopeLayout& layout);
+
+    // Slot index of 'name' in this scope, or -1
+    int findSlot(const std::string& name) const;
+
+    Value* refreshGlobal(const std::string& name, GlobalCache& cache);
+
+    static inline uint64_t globalVersion_ = 0;
+
+    Value* slots_;
+    size_t slotCount_ = 0;
+    Value inlineSlots_[kInlineSlots];
+    std::unique_ptr<Value[]> heapSlots_;              // Scopes larger than kInlineSlots
+    size_t heapCapacity_ = 0;
+    const std::vector<std::string>* slotNames_ = nullptr;
+    std::unique_ptr<std::unordered_map<std::string, Value>> values_;  // Globals only
     std::shared_ptr<Environment> enclosing_;
 };
 
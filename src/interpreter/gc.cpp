@@ -0,0 +1,249 @@
+#include "gc.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+namespace volt {
+
+// ==================== TRACKING ====================
+
+GcObject::GcObject() {
+    Collector::track(this);
+}
+
+GcObject::GcObject(const GcObject& other) : Object(other) {
+    Collector::track(this);
+}
+
+GcObject::~GcObject() {
+    Collector::untrack(this);
+}
+
+void Collector::track(GcObject* object) {
+    auto& young = spaces()[kYoung];
+    object->traced_ = true;
+    object->gcSpace_ = kYoung;
+    object->gcIndex_ = static_cast<uint32_t>(young.size());
+    young.push_back(object);
+    youngCount_++;
+}
+
+void Collector::untrack(GcObject* object) {
+    auto& list = spaces()[object->gcSpace_];
+    GcObject* last = list.back();
+    list[object->gcIndex_] = last;
+    last->gcIndex_ = object->gcIndex_;
+    list.pop_back();
+    if (object->gcSpace_ == kYoung) youngCount_--;
+}
+
+void Collector::moveTo(GcObject* object, uint8_t space) {
+    untrack(object);
+    auto& list = spaces()[space];
+    object->gcSpace_ = space;
+    object->gcIndex_ = static_cast<uint32_t>(list.size());
+    list.push_back(object);
+}
+
+size_t Collector::oldCount() {
+    auto& lists = spaces();
+    return lists[1].size() + lists[2].size();
+}
+
+size_t Collector::liveBytes() {
+    size_t bytes = 0;
+    for (const auto& list : spaces()) {
+        for (const GcObject* object : list) bytes += object->byteSize();
+    }
+    return bytes;
+}
+
+// ==================== COLLECTION ====================
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+GcObject* traced(Object* object) {
+    return object->isTraced() ? static_cast<GcObject*>(object) : nullptr;
+}
+
+double millisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+} // anonymous namespace
+
+// Trial deletion over 'set' (every object marked InSet): frees its garbage,
+// moves its survivors to the visited old space
+size_t Collector::collectSet(std::vector<GcObject*>& set, size_t& promoted) {
+    using Mark = GcObject::Mark;
+
+    // References from outside = count - references from the set
+    for (GcObject* object : set) {
+        object->gcRefs_ = static_cast<int32_t>(object->refCount());
+    }
+    struct Subtract : Tracer {
+        void visit(Object* object) override {
+            GcObject* target = traced(object);
+            if (target && target->gcMark_ == Mark::InSet) target->gcRefs_--;
+        }
+    } subtract;
+    for (GcObject* object : set) {
+        object->trace(subtract);
+    }
+
+    // Mark everything reachable from an object with outside references
+    std::vector<GcObject*> pending;
+    for (GcObject* object : set) {
+        if (object->gcRefs_ > 0) {
+            object->gcMark_ = Mark::Reachable;
+            pending.push_back(object);
+        }
+    }
+    struct Reach : Tracer {
+        std::vector<GcObject*>& pending;
+        explicit Reach(std::vector<GcObject*>& p) : pending(p) {}
+        void visit(Object* object) override {
+            GcObject* target = traced(object);
+            if (target && target->gcMark_ == Mark::InSet) {
+                target->gcMark_ = Mark::Reachable;
+                pending.push_back(target);
+            }
+        }
+    } reach(pending);
+    while (!pending.empty()) {
+        GcObject* object = pending.back();
+        pending.pop_back();
+        object->trace(reach);
+    }
+
+    // Survivors grow old; the garbage is held while its cycles are cut
+    std::vector<Ref<GcObject>> garbage;
+    for (GcObject* object : set) {
+        bool reachable = object->gcMark_ == Mark::Reachable;
+        object->gcMark_ = Mark::None;
+        if (!reachable) {
+            garbage.emplace_back(static_cast<Object*>(object));
+        } else if (object->gcSpace_ != visited_) {
+            if (object->gcSpace_ == kYoung) promoted += object->byteSize();
+            moveTo(object, visited_);
+        }
+    }
+    for (const auto& object : garbage) {
+        object->clearReferences();
+    }
+    size_t freed = garbage.size();
+    garbage.clear();
+    return freed;
+}
+
+void Collector::collectNursery() {
+    using Mark = GcObject::Mark;
+    if (collecting_) return;
+    collecting_ = true;
+    auto start = Clock::now();
+    auto& lists = spaces();
+
+    if (!passRunning_ && oldCount() >= oldThreshold_) {
+        std::swap(pending_, visited_);  // Everything old is now unvisited
+        passRunning_ = true;
+        wholePass_ = pauseBudgetMs_ <= 0 || oldCount() >= wholePassThreshold_;
+    }
+
+    std::vector<GcObject*> set(lists[kYoung]);
+    for (GcObject* object : set) {
+        object->gcMark_ = Mark::InSet;
+    }
+
+    // The next slice of the old pass and what it references, as far as
+    // the budget goes (all of it in a whole pass)
+    if (passRunning_) {
+        auto& unvisited = lists[pending_];
+        size_t slice = unvisited.size();
+        if (pauseBudgetMs_ > 0) {
+            auto budget = static_cast<size_t>(objectsPerMs_ * pauseBudgetMs_);
+            slice = std::min(slice, budget > set.size() + kMinSlice ? budget - set.size() : kMinSlice);
+        }
+        size_t first = set.size();
+        size_t limit = wholePass_ ? SIZE_MAX : first + 2 * slice;
+        for (size_t i = 0; i < slice; i++) {
+            GcObject* object = unvisited[unvisited.size() - 1 - i];
+            object->gcMark_ = Mark::InSet;
+            set.push_back(object);
+        }
+        struct Expand : Tracer {
+            std::vector<GcObject*>& set;
+            size_t limit;
+            Expand(std::vector<GcObject*>& s, size_t l) : set(s), limit(l) {}
+            void visit(Object* object) override {
+                GcObject* target = traced(object);
+                if (target && target->gcMark_ == Mark::None && set.size() < limit) {
+                    target->gcMark_ = Mark::InSet;
+                    set.push_back(target);
+                }
+            }
+        } expand(set, limit);
+        for (size_t i = first; i < set.size() && set.size() < limit; i++) {
+            set[i]->trace(expand);
+        }
+    }
+
+    size_t promoted = 0;
+    size_t freed = collectSet(set, promoted);
+
+    if (passRunning_ && lists[pending_].empty()) {
+        passRunning_ = false;
+        stats_.oldPasses++;
+        oldThreshold_ = std::max(kMinOldThreshold, 2 * oldCount());
+        if (wholePass_) wholePassThreshold_ = std::max(kMinOldThreshold, 4 * oldCount());
+    }
+
+    double pauseMs = millisecondsSince(start);
+    if (set.size() >= kMinSlice && pauseMs > 0) {
+        objectsPerMs_ = (objectsPerMs_ + static_cast<double>(set.size()) / pauseMs) / 2;
+    }
+    record(pauseMs, freed, promoted);
+    collecting_ = false;
+}
+
+size_t Collector::collect() {
+    using Mark = GcObject::Mark;
+    if (collecting_) return 0;
+    collecting_ = true;
+    auto start = Clock::now();
+
+    std::vector<GcObject*> set;
+    set.reserve(trackedCount());
+    for (const auto& list : spaces()) {
+        for (GcObject* object : list) {
+            object->gcMark_ = Mark::InSet;
+            set.push_back(object);
+        }
+    }
+    size_t promoted = 0;
+    size_t freed = collectSet(set, promoted);
+
+    // Everything left is visited: a running pass is complete
+    if (passRunning_) stats_.oldPasses++;
+    passRunning_ = false;
+    oldThreshold_ = std::max(kMinOldThreshold, 2 * oldCount());
+    wholePassThreshold_ = std::max(kMinOldThreshold, 4 * oldCount());
+
+    record(millisecondsSince(start), freed, promoted);
+    collecting_ = false;
+    return freed;
+}
+
+void Collector::record(double pauseMs, size_t freed, size_t promoted) {
+    stats_.collections++;
+    stats_.lastPauseMs = pauseMs;
+    stats_.maxPauseMs = std::max(stats_.maxPauseMs, pauseMs);
+    stats_.totalPauseMs += pauseMs;
+    stats_.lastBytesPromoted = promoted;
+    stats_.bytesPromoted += promoted;
+    stats_.lastFreed = freed;
+    stats_.freed += freed;
+}
+
+} // namespace volt
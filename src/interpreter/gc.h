@@ -0,0 +1,186 @@
+#pragma once
+#include "value.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace volt {
+
+/**
+ * Tracer - Receives the references a GcObject holds (see GcObject::trace)
+ */
+class Tracer {
+public:
+    virtual void visit(Object* object) = 0;
+
+    void operator()(const Value& value) {
+        if (value.isObject()) visit(value.object());
+    }
+    template <typename T>
+    void operator()(const Ref<T>& ref) {
+        if (ref) visit(ref.object());
+    }
+
+protected:
+    ~Tracer() = default;
+};
+
+/**
+ * GcObject - A heap object that can hold references to other objects
+ *
+ * Reference counting frees an object as soon as its last reference goes,
+ * but not a cycle: a recursive closure and the cell holding it, or an
+ * array that contains itself. Every GcObject is registered with the
+ * Collector, which finds such cycles by following the references each
+ * object reports in trace().
+ *
+ * trace() must report exactly the references the object owns (each one
+ * counted in the target's reference count). Leaving one out only keeps
+ * its target alive; reporting one it doesn't own could free a live
+ * object. clearReferences() drops them all; the collector calls it on
+ * garbage to break its cycles. byteSize() is the object's approximate
+ * footprint, its own size plus the buffers it owns, for gcStats().
+ */
+class GcObject : public Object {
+public:
+    GcObject();
+    GcObject(const GcObject& other);
+    GcObject& operator=(const GcObject&) { return *this; }
+    ~GcObject() override;
+
+    virtual void trace(Tracer& tracer) const = 0;
+    virtual void clearReferences() = 0;
+    virtual size_t byteSize() const = 0;
+
+private:
+    friend class Collector;
+
+    enum class Mark : uint8_t { None, InSet, Reachable };
+
+    uint32_t gcIndex_ = 0;        // Position in its space's list
+    uint8_t gcSpace_ = 0;         // Collector::kYoung or one of the old spaces
+    Mark gcMark_ = Mark::None;    // During a collection
+    int32_t gcRefs_ = 0;          // During a collection: references from outside the set
+};
+
+/**
+ * GcStats - What the collector did, for gcStats()
+ */
+struct GcStats {
+    size_t collections = 0;        // Each takes the nursery, and maybe an old slice
+    size_t oldPasses = 0;          // Completed passes over the old generation
+    double lastPauseMs = 0;
+    double maxPauseMs = 0;
+    double totalPauseMs = 0;
+    size_t lastBytesPromoted = 0;  // Nursery survivors moved to the old generation
+    size_t bytesPromoted = 0;
+    size_t lastFreed = 0;          // Objects freed
+    size_t freed = 0;
+};
+
+/**
+ * Collector - Generational, incremental collector for cycles among GcObjects
+ *
+ * A collection is a mark-sweep over a set of GcObjects in which the roots
+ * are found rather than listed (trial deletion):
+ *
+ *   1. each object in the set starts with its reference count
+ *   2. every reference one object of the set holds to another is
+ *      subtracted; what is left are references from outside the set:
+ *      environment slots, the VM stack, constants in the AST and bytecode,
+ *      Values in C++ locals, and objects that are not in the set
+ *   3. objects with outside references are the roots; everything in the
+ *      set reachable from them is marked live
+ *   4. the rest is only referenced by itself: the collector drops its
+ *      references and reference counting frees it
+ *
+ * Since anything outside the set counts as a root, the set can be any
+ * part of the heap, which is what makes the collector generational and
+ * incremental without write barriers:
+ *
+ * - New objects start in the nursery. Once kNurserySize of them are alive
+ *   at a safepoint (a statement, a loop back-edge or a call), the nursery
+ *   is collected: short-lived cycles die young, survivors are promoted to
+ *   the old generation. Acyclic temporaries never get that far, reference
+ *   counting frees them first.
+ * - When the old generation has doubled since its last pass, a pass over
+ *   it starts. Each nursery collection then also takes the next slice of
+ *   the old objects not yet visited in the pass. Without a pause budget a
+ *   pass is a single collection. With one (--gc-pause-ms), a slice is
+ *   sized from the measured collection rate to fit it, together with the
+ *   objects it references up to as many again.
+ *
+ * A garbage cycle cut by a slice boundary survives that pass, so once the
+ * old generation has grown fourfold since a pass saw whole cycles, the
+ * next one takes everything each slice reaches: it can overrun the budget
+ * on a large connected structure, but cyclic garbage stays bounded. An
+ * object's own references are traced in one go, so a slice holding a
+ * very large array takes as long as its elements do.
+ *
+ * Nothing has to register roots, so collect() is safe at any point.
+ *
+ * Single-threaded, like the rest of the runtime.
+ */
+class Collector {
+public:
+    static constexpr size_t kNurserySize = 4096;
+    static constexpr size_t kMinOldThreshold = 8192;
+    static constexpr size_t kMinSlice = 256;
+
+    // Collect the nursery (and an old slice) if it is full
+    static void safepoint() {
+        if (youngCount_ >= kNurserySize) collectNursery();
+    }
+
+    // Full collection of both generations; returns the number of objects freed
+    static size_t collect();
+
+    // Milliseconds an incremental collection should take (0: no budget)
+    static void setPauseBudget(double ms) { pauseBudgetMs_ = ms; }
+    static double pauseBudget() { return pauseBudgetMs_; }
+
+    static const GcStats& stats() { return stats_; }
+
+    // GcObjects currently alive, in total and per generation
+    static size_t trackedCount() { return youngCount_ + oldCount(); }
+    static size_t youngCount() { return youngCount_; }
+    static size_t oldCount();
+
+    // Sum of byteSize() over every live GcObject (walks the heap)
+    static size_t liveBytes();
+
+private:
+    friend class GcObject;
+
+    static constexpr uint8_t kYoung = 0;
+
+    static void track(GcObject* object);
+    static void untrack(GcObject* object);
+    static void moveTo(GcObject* object, uint8_t space);
+
+    static void collectNursery();
+    static size_t collectSet(std::vector<GcObject*>& set, size_t& promoted);
+    static void record(double pauseMs, size_t freed, size_t promoted);
+
+    // Young, and the two halves of the old generation: objects a running
+    // pass has yet to visit, and the ones it has (plus new promotions)
+    static std::array<std::vector<GcObject*>, 3>& spaces() {
+        static auto* lists = new std::array<std::vector<GcObject*>, 3>();  // Never destroyed
+        return *lists;
+    }
+
+    static inline size_t youngCount_ = 0;
+    static inline uint8_t pending_ = 1;
+    static inline uint8_t visited_ = 2;
+    static inline bool passRunning_ = false;
+    static inline bool wholePass_ = false;  // Slices take everything they reach
+    static inline size_t oldThreshold_ = kMinOldThreshold;
+    static inline size_t wholePassThreshold_ = kMinOldThreshold;
+    static inline double pauseBudgetMs_ = 0;
+    static inline double objectsPerMs_ = 20000;  // Collection rate, measured as we go
+    static inline bool collecting_ = false;
+    static inline GcStats stats_;
+};
+
+} // namespace volt
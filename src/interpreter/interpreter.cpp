@@ -4,8 +4,10 @@
 #include "ast.h"
 #include "value.h"
 #include "environment.h"
+#include "resolver.h"
 #include "features/array.h"  // NEW!
 #include "features/hashmap.h"  // NEW!
+#include "vm/vm.h"
 #include <memory>
 #include <sstream>
 #include <fstream>
@@ -13,16 +15,52 @@
 #include <cmath>
 #include <iostream>  // NEW! For std::cout, std::cin
 #include <chrono>    // NEW! For clock() function
+#include <cstdlib>   // std::getenv
+#include <algorithm>
 
 namespace volt {
 
 Interpreter::Interpreter()
+    : Interpreter(defaultEngine()) {}
+
+Interpreter::Interpreter(Engine engine)
     : environment_(std::make_shared<Environment>()),
-      globals_(environment_) {
+      globals_(environment_),
+      engine_(engine) {
     // Register built-in functions
     defineNatives();
 }
 
+// Whatever this interpreter's scopes held is gone now; free the cycles
+// among it too, so sessions that come and go keep memory bounded
+Interpreter::~Interpreter() {
+    vm_.reset();
+    scopePool_.clear();
+    environment_.reset();
+    globals_.reset();
+    returnValue_ = nullptr;
+    tailCall_ = nullptr;
+    tailCallArguments_.clear();
+    Collector::collect();
+}
+
+// VOLT_ENGINE=vm lets the whole test suite (and embedders) switch
+// engines without touching code
+Engine Interpreter::defaultEngine() {
+    const char* env = std::getenv("VOLT_ENGINE");
+    if (env && std::string(env) == "vm") {
+        return Engine::Vm;
+    }
+    return Engine::Ast;
+}
+
+VM& Interpreter::vm() {
+    if (!vm_) {
+        vm_ = std::make_unique<VM>(*this);
+    }
+    return *vm_;
+}
+
 void Interpreter::reset() {
     environment_ = std::make_shared<Environment>();
     globals_ = environment_;
@@ -32,9 +70,9 @@ void Interpreter::reset() {
 // Register native functions (built into the language)
 void Interpreter::defineNatives() {
     // clock() - returns current time in seconds
-    globals_->define("clock", std::make_shared<NativeFunction>(
+    globals_->define("clock", makeRef<NativeFunction>(
         0,
-        [](const std::vector<Value>&) -> Value {
+        [](std::span<const Value>) -> Value {
             auto now = std::chrono::system_clock::now();
             auto duration = now.time_since_epoch();
             auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
@@ -44,9 +82,9 @@ void Interpreter::defineNatives() {
     ));
     
     // len(value) - returns length of string, array, or hash map  // ENHANCED!
-    globals_->define("len", std::make_shared<NativeFunction>(
+    globals_->define("len", makeRef<NativeFunction>(
         1,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             if (isString(args[0])) {
                 return static_cast<double>(asString(args[0]).length());
             }
@@ -62,18 +100,18 @@ void Interpreter::defineNatives() {
     ));
     
     // str(value) - convert to string
-    globals_->define("str", std::make_shared<NativeFunction>(
+    globals_->define("str", makeRef<NativeFunction>(
         1,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             return valueToString(args[0]);
         },
         "str"
     ));
     
     // num(value) - convert to number
-    globals_->define("num", std::make_shared<NativeFunction>(
+    globals_->define("num", makeRef<NativeFunction>(
         1,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             if (isNumber(args[0])) return args[0];
             if (isString(args[0])) {
                 try {
@@ -91,9 +129,9 @@ void Interpreter::defineNatives() {
     ));
     
     // input(prompt) - read line from stdin
-    globals_->define("input", std::make_shared<NativeFunction>(
+    globals_->define("input", makeRef<NativeFunction>(
         1,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             if (isString(args[0])) {
                 std::cout << asString(args[0]);
             }
@@ -105,9 +143,9 @@ void Interpreter::defineNatives() {
     ));
     
     // readFile(path) - read entire file as string
-    globals_->define("readFile", std::make_shared<NativeFunction>(
+    globals_->define("readFile", makeRef<NativeFunction>(
         1,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             if (!isString(args[0])) {
                 throw std::runtime_error("readFile() requires a string path");
             }
@@ -123,9 +161,9 @@ void Interpreter::defineNatives() {
     ));
     
     // writeFile(path, content) - write string to file (overwrites)
-    globals_->define("writeFile", std::make_shared<NativeFunction>(
+    globals_->define("writeFile", makeRef<NativeFunction>(
         2,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             if (!isString(args[0]) || !isString(args[1])) {
                 throw std::runtime_error("writeFile() requires string path and content");
             }
@@ -140,9 +178,9 @@ void Interpreter::defineNatives() {
     ));
     
     // appendFile(path, content) - append string to file
-    globals_->define("appendFile", std::make_shared<NativeFunction>(
+    globals_->define("appendFile", makeRef<NativeFunction>(
         2,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             if (!isString(args[0]) || !isString(args[1])) {
                 throw std::runtime_error("appendFile() requires string path and content");
             }
@@ -157,9 +195,9 @@ void Interpreter::defineNatives() {
     ));
     
     // fileExists(path) - check if file exists
-    globals_->define("fileExists", std::make_shared<NativeFunction>(
+    globals_->define("fileExists", makeRef<NativeFunction>(
         1,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             if (!isString(args[0])) {
                 throw std::runtime_error("fileExists() requires a string path");
             }
@@ -170,9 +208,9 @@ void Interpreter::defineNatives() {
     ));
     
     // toUpper(str) - convert string to uppercase
-    globals_->define("toUpper", std::make_shared<NativeFunction>(
+    globals_->define("toUpper", makeRef<NativeFunction>(
         1,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             if (!isString(args[0])) throw std::runtime_error("toUpper() requires a string");
             std::string s = asString(args[0]);
             for (auto& c : s) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
@@ -182,9 +220,9 @@ void Interpreter::defineNatives() {
     ));
     
     // toLower(str) - convert string to lowercase
-    globals_->define("toLower", std::make_shared<NativeFunction>(
+    globals_->define("toLower", makeRef<NativeFunction>(
         1,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             if (!isString(args[0])) throw std::runtime_error("toLower() requires a string");
             std::string s = asString(args[0]);
             for (auto& c : s) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
@@ -194,9 +232,9 @@ void Interpreter::defineNatives() {
     ));
     
     // upper(str) - convert string to uppercase (alias for toUpper)
-    globals_->define("upper", std::make_shared<NativeFunction>(
+    globals_->define("upper", makeRef<NativeFunction>(
         1,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             if (!isString(args[0])) throw std::runtime_error("upper() requires a string");
             std::string s = asString(args[0]);
             for (auto& c : s) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
@@ -206,9 +244,9 @@ void Interpreter::defineNatives() {
     ));
     
     // lower(str) - convert string to lowercase (alias for toLower)
-    globals_->define("lower", std::make_shared<NativeFunction>(
+    globals_->define("lower", makeRef<NativeFunction>(
         1,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             if (!isString(args[0])) throw std::runtime_error("lower() requires a string");
             std::string s = asString(args[0]);
             for (auto& c : s) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
@@ -218,14 +256,14 @@ void Interpreter::defineNatives() {
     ));
     
     // substr(str, start, length) - extract substring  // NEW!
-    globals_->define("substr", std::make_shared<NativeFunction>(
+    globals_->define("substr", makeRef<NativeFunction>(
         3,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             if (!isString(args[0])) throw std::runtime_error("substr() requires a string as first argument");
             if (!isNumber(args[1])) throw std::runtime_error("substr() requires a number as start position");
             if (!isNumber(args[2])) throw std::runtime_error("substr() requires a number as length");
             
-            std::string s = asString(args[0]);
+            const std::string& s = asString(args[0]);
             int start = static_cast<int>(asNumber(args[1]));
             int length = static_cast<int>(asNumber(args[2]));
             
@@ -243,14 +281,14 @@ void Interpreter::defineNatives() {
     ));
     
     // indexOf(str, substr) - find first occurrence of substring  // NEW!
-    globals_->define("indexOf", std::make_shared<NativeFunction>(
+    globals_->define("indexOf", makeRef<NativeFunction>(
         2,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             if (!isString(args[0])) throw std::runtime_error("indexOf() requires a string as first argument");
             if (!isString(args[1])) throw std::runtime_error("indexOf() requires a string as second argument");
             
-            std::string s = asString(args[0]);
-            std::string sub = asString(args[1]);
+            const std::string& s = asString(args[0]);
+            const std::string& sub = asString(args[1]);
             
             size_t pos = s.find(sub);
             if (pos == std::string::npos) {
@@ -263,23 +301,23 @@ void Interpreter::defineNatives() {
     ));
     
     // ==================== MATH FUNCTIONS (NEW FOR v0.7.2) ====================
+    // Fixed-arity natives: the arity comes from the signature and the
+    // arguments are passed directly, the cheapest way to call a builtin
     
     // abs(number) - absolute value
-    globals_->define("abs", std::make_shared<NativeFunction>(
-        1,
-        [](const std::vector<Value>& args) -> Value {
-            if (!isNumber(args[0])) throw std::runtime_error("abs() requires a number");
-            return std::abs(asNumber(args[0]));
+    globals_->define("abs", makeRef<NativeFunction>(
+        [](const Value& value) -> Value {
+            if (!isNumber(value)) throw std::runtime_error("abs() requires a number");
+            return std::abs(asNumber(value));
         },
         "abs"
     ));
     
     // sqrt(number) - square root
-    globals_->define("sqrt", std::make_shared<NativeFunction>(
-        1,
-        [](const std::vector<Value>& args) -> Value {
-            if (!isNumber(args[0])) throw std::runtime_error("sqrt() requires a number");
-            double val = asNumber(args[0]);
+    globals_->define("sqrt", makeRef<NativeFunction>(
+        [](const Value& value) -> Value {
+            if (!isNumber(value)) throw std::runtime_error("sqrt() requires a number");
+            double val = asNumber(value);
             if (val < 0) throw std::runtime_error("sqrt() argument must be non-negative");
             return std::sqrt(val);
         },
@@ -287,75 +325,68 @@ void Interpreter::defineNatives() {
     ));
     
     // pow(base, exponent) - power function
-    globals_->define("pow", std::make_shared<NativeFunction>(
-        2,
-        [](const std::vector<Value>& args) -> Value {
-            if (!isNumber(args[0]) || !isNumber(args[1])) {
+    globals_->define("pow", makeRef<NativeFunction>(
+        [](const Value& a, const Value& b) -> Value {
+            if (!isNumber(a) || !isNumber(b)) {
                 throw std::runtime_error("pow() requires two numbers");
             }
-            return std::pow(asNumber(args[0]), asNumber(args[1]));
+            return std::pow(asNumber(a), asNumber(b));
         },
         "pow"
     ));
     
     // min(a, b) - minimum of two values
-    globals_->define("min", std::make_shared<NativeFunction>(
-        2,
-        [](const std::vector<Value>& args) -> Value {
-            if (!isNumber(args[0]) || !isNumber(args[1])) {
+    globals_->define("min", makeRef<NativeFunction>(
+        [](const Value& a, const Value& b) -> Value {
+            if (!isNumber(a) || !isNumber(b)) {
                 throw std::runtime_error("min() requires two numbers");
             }
-            return std::min(asNumber(args[0]), asNumber(args[1]));
+            return std::min(asNumber(a), asNumber(b));
         },
         "min"
     ));
     
     // max(a, b) - maximum of two values
-    globals_->define("max", std::make_shared<NativeFunction>(
-        2,
-        [](const std::vector<Value>& args) -> Value {
-            if (!isNumber(args[0]) || !isNumber(args[1])) {
+    globals_->define("max", makeRef<NativeFunction>(
+        [](const Value& a, const Value& b) -> Value {
+            if (!isNumber(a) || !isNumber(b)) {
                 throw std::runtime_error("max() requires two numbers");
             }
-            return std::max(asNumber(args[0]), asNumber(args[1]));
+            return std::max(asNumber(a), asNumber(b));
         },
         "max"
     ));
     
     // round(number) - round to nearest integer
-    globals_->define("round", std::make_shared<NativeFunction>(
-        1,
-        [](const std::vector<Value>& args) -> Value {
-            if (!isNumber(args[0])) throw std::runtime_error("round() requires a number");
-            return std::round(asNumber(args[0]));
+    globals_->define("round", makeRef<NativeFunction>(
+        [](const Value& value) -> Value {
+            if (!isNumber(value)) throw std::runtime_error("round() requires a number");
+            return std::round(asNumber(value));
         },
         "round"
     ));
     
     // floor(number) - round down to integer
-    globals_->define("floor", std::make_shared<NativeFunction>(
-        1,
-        [](const std::vector<Value>& args) -> Value {
-            if (!isNumber(args[0])) throw std::runtime_error("floor() requires a number");
-            return std::floor(asNumber(args[0]));
+    globals_->define("floor", makeRef<NativeFunction>(
+        [](const Value& value) -> Value {
+            if (!isNumber(value)) throw std::runtime_error("floor() requires a number");
+            return std::floor(asNumber(value));
         },
         "floor"
     ));
     
     // ceil(number) - round up to integer
-    globals_->define("ceil", std::make_shared<NativeFunction>(
-        1,
-        [](const std::vector<Value>& args) -> Value {
-            if (!isNumber(args[0])) throw std::runtime_error("ceil() requires a number");
-            return std::ceil(asNumber(args[0]));
+    globals_->define("ceil", makeRef<NativeFunction>(
+        [](const Value& value) -> Value {
+            if (!isNumber(value)) throw std::runtime_error("ceil() requires a number");
+            return std::ceil(asNumber(value));
         },
         "ceil"
     ));
     
     // random() - random number between 0 and 1
-    globals_->define("random", std::make_shared<NativeFunction>(
-        0,
-        [](const std::vector<Value>&) -> Value {
+    globals_->define("random", makeRef<NativeFunction>(
+        []() -> Value {
             return static_cast<double>(std::rand()) / RAND_MAX;
         },
         "random"
@@ -364,31 +395,28 @@ void Interpreter::defineNatives() {
     // ==================== TRIGONOMETRIC FUNCTIONS (NEW FOR v0.7.5) ====================
     
     // sin(x) - sine function
-    globals_->define("sin", std::make_shared<NativeFunction>(
-        1,
-        [](const std::vector<Value>& args) -> Value {
-            if (!isNumber(args[0])) throw std::runtime_error("sin() requires a number");
-            return std::sin(asNumber(args[0]));
+    globals_->define("sin", makeRef<NativeFunction>(
+        [](const Value& value) -> Value {
+            if (!isNumber(value)) throw std::runtime_error("sin() requires a number");
+            return std::sin(asNumber(value));
         },
         "sin"
     ));
     
     // cos(x) - cosine function
-    globals_->define("cos", std::make_shared<NativeFunction>(
-        1,
-        [](const std::vector<Value>& args) -> Value {
-            if (!isNumber(args[0])) throw std::runtime_error("cos() requires a number");
-            return std::cos(asNumber(args[0]));
+    globals_->define("cos", makeRef<NativeFunction>(
+        [](const Value& value) -> Value {
+            if (!isNumber(value)) throw std::runtime_error("cos() requires a number");
+            return std::cos(asNumber(value));
         },
         "cos"
     ));
     
     // tan(x) - tangent function
-    globals_->define("tan", std::make_shared<NativeFunction>(
-        1,
-        [](const std::vector<Value>& args) -> Value {
-            if (!isNumber(args[0])) throw std::runtime_error("tan() requires a number");
-            return std::tan(asNumber(args[0]));
+    globals_->define("tan", makeRef<NativeFunction>(
+        [](const Value& value) -> Value {
+            if (!isNumber(value)) throw std::runtime_error("tan() requires a number");
+            return std::tan(asNumber(value));
         },
         "tan"
     ));
@@ -396,11 +424,10 @@ void Interpreter::defineNatives() {
     // ==================== LOGARITHMIC FUNCTIONS (NEW FOR v0.7.5) ====================
     
     // log(x) - natural logarithm
-    globals_->define("log", std::make_shared<NativeFunction>(
-        1,
-        [](const std::vector<Value>& args) -> Value {
-            if (!isNumber(args[0])) throw std::runtime_error("log() requires a number");
-            double x = asNumber(args[0]);
+    globals_->define("log", makeRef<NativeFunction>(
+        [](const Value& value) -> Value {
+            if (!isNumber(value)) throw std::runtime_error("log() requires a number");
+            double x = asNumber(value);
             if (x <= 0) throw std::runtime_error("log() argument must be positive");
             return std::log(x);
         },
@@ -408,11 +435,10 @@ void Interpreter::defineNatives() {
     ));
     
     // exp(x) - exponential function
-    globals_->define("exp", std::make_shared<NativeFunction>(
-        1,
-        [](const std::vector<Value>& args) -> Value {
-            if (!isNumber(args[0])) throw std::runtime_error("exp() requires a number");
-            return std::exp(asNumber(args[0]));
+    globals_->define("exp", makeRef<NativeFunction>(
+        [](const Value& value) -> Value {
+            if (!isNumber(value)) throw std::runtime_error("exp() requires a number");
+            return std::exp(asNumber(value));
         },
         "exp"
     ));
@@ -420,9 +446,9 @@ void Interpreter::defineNatives() {
     // ==================== DATE/TIME FUNCTIONS (NEW FOR v0.7.5) ====================
     
     // now() - get current timestamp in milliseconds
-    globals_->define("now", std::make_shared<NativeFunction>(
+    globals_->define("now", makeRef<NativeFunction>(
         0,
-        [](const std::vector<Value>&) -> Value {
+        [](std::span<const Value>) -> Value {
             auto now = std::chrono::system_clock::now();
             auto duration = now.time_since_epoch();
             auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
@@ -432,14 +458,14 @@ void Interpreter::defineNatives() {
     ));
     
     // formatDate(timestamp, format) - format timestamp (stub implementation)
-    globals_->define("formatDate", std::make_shared<NativeFunction>(
+    globals_->define("formatDate", makeRef<NativeFunction>(
         2,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             if (!isNumber(args[0])) throw std::runtime_error("formatDate() requires a timestamp number as first argument");
             if (!isString(args[1])) throw std::runtime_error("formatDate() requires a format string as second argument");
             // Simple implementation - just return a formatted string
             double timestamp = asNumber(args[0]);
-            std::string format = asString(args[1]);
+            const std::string& format = asString(args[1]);
             std::ostringstream oss;
             oss << "Date(" << static_cast<long long>(timestamp) << ") formatted as '" << format << "'";
             return oss.str();
@@ -450,9 +476,9 @@ void Interpreter::defineNatives() {
     // ==================== JSON FUNCTIONS (NEW FOR v0.7.5) ====================
     
     // jsonEncode(value) - encode value to JSON string (simple implementation)
-    globals_->define("jsonEncode", std::make_shared<NativeFunction>(
+    globals_->define("jsonEncode", makeRef<NativeFunction>(
         1,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             // Simple JSON encoding
             if (isNil(args[0])) return "null";
             if (isBool(args[0])) return asBool(args[0]) ? "true" : "false";
@@ -465,7 +491,7 @@ void Interpreter::defineNatives() {
                 }
             }
             if (isString(args[0])) {
-                std::string str = asString(args[0]);
+                const std::string& str = asString(args[0]);
                 // Simple string escaping
                 std::string escaped;
                 escaped += "\"";
@@ -489,9 +515,9 @@ void Interpreter::defineNatives() {
     ));
     
     // jsonDecode(jsonString) - decode JSON string to value (simple implementation)
-    globals_->define("jsonDecode", std::make_shared<NativeFunction>(
+    globals_->define("jsonDecode", makeRef<NativeFunction>(
         1,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             if (!isString(args[0])) throw std::runtime_error("jsonDecode() requires a string");
             std::string jsonStr = asString(args[0]);
             
@@ -549,11 +575,11 @@ void Interpreter::defineNatives() {
     // ==================== STRING ENHANCEMENTS (NEW FOR v0.7.2) ====================
     
     // trim(str) - remove whitespace from both ends
-    globals_->define("trim", std::make_shared<NativeFunction>(
+    globals_->define("trim", makeRef<NativeFunction>(
         1,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             if (!isString(args[0])) throw std::runtime_error("trim() requires a string");
-            std::string s = asString(args[0]);
+            const std::string& s = asString(args[0]);
             
             // Remove leading whitespace
             size_t start = s.find_first_not_of(" \t\n\r\f\v");
@@ -568,16 +594,16 @@ void Interpreter::defineNatives() {
     ));
     
     // split(str, delimiter) - split string into array
-    globals_->define("split", std::make_shared<NativeFunction>(
+    globals_->define("split", makeRef<NativeFunction>(
         2,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             if (!isString(args[0])) throw std::runtime_error("split() requires a string as first argument");
             if (!isString(args[1])) throw std::runtime_error("split() requires a string delimiter");
             
-            std::string s = asString(args[0]);
-            std::string delim = asString(args[1]);
+            const std::string& s = asString(args[0]);
+            const std::string& delim = asString(args[1]);
             
-            auto resultArray = std::make_shared<VoltArray>();
+            auto resultArray = makeRef<VoltArray>();
             
             if (delim.empty()) {
                 // Split into individual characters
@@ -602,16 +628,16 @@ void Interpreter::defineNatives() {
     ));
     
     // replace(str, search, replacement) - replace all occurrences
-    globals_->define("replace", std::make_shared<NativeFunction>(
+    globals_->define("replace", makeRef<NativeFunction>(
         3,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             if (!isString(args[0])) throw std::runtime_error("replace() requires a string as first argument");
             if (!isString(args[1])) throw std::runtime_error("replace() requires a string to search for");
             if (!isString(args[2])) throw std::runtime_error("replace() requires a string replacement");
             
-            std::string s = asString(args[0]);
-            std::string search = asString(args[1]);
-            std::string replacement = asString(args[2]);
+            const std::string& s = asString(args[0]);
+            const std::string& search = asString(args[1]);
+            const std::string& replacement = asString(args[2]);
             
             if (search.empty()) return s; // Nothing to replace
             
@@ -632,40 +658,40 @@ void Interpreter::defineNatives() {
     ));
     
     // startsWith(str, prefix) - check if string starts with prefix
-    globals_->define("startsWith", std::make_shared<NativeFunction>(
+    globals_->define("startsWith", makeRef<NativeFunction>(
         2,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             if (!isString(args[0])) throw std::runtime_error("startsWith() requires a string as first argument");
             if (!isString(args[1])) throw std::runtime_error("startsWith() requires a string prefix");
             
-            std::string s = asString(args[0]);
-            std::string prefix = asString(args[1]);
+            const std::string& s = asString(args[0]);
+            const std::string& prefix = asString(args[1]);
             
-            return s.length() >= prefix.length() && s.substr(0, prefix.length()) == prefix;
+            return s.length() >= prefix.length() && s.compare(0, prefix.length(), prefix) == 0;
         },
         "startsWith"
     ));
     
     // endsWith(str, suffix) - check if string ends with suffix
-    globals_->define("endsWith", std::make_shared<NativeFunction>(
+    globals_->define("endsWith", makeRef<NativeFunction>(
         2,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             if (!isString(args[0])) throw std::runtime_error("endsWith() requires a string as first argument");
             if (!isString(args[1])) throw std::runtime_error("endsWith() requires a string suffix");
             
-            std::string s = asString(args[0]);
-            std::string suffix = asString(args[1]);
+            const std::string& s = asString(args[0]);
+            const std::string& suffix = asString(args[1]);
             
             return s.length() >= suffix.length() && 
-                   s.substr(s.length() - suffix.length()) == suffix;
+                   s.compare(s.length() - suffix.length(), suffix.length(), suffix) == 0;
         },
         "endsWith"
     ));
     
     // type(val) - get type of value as string
-    globals_->define("type", std::make_shared<NativeFunction>(
+    globals_->define("type", makeRef<NativeFunction>(
         1,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             const Value& v = args[0];
             if (isNil(v)) return "nil";
             if (isBool(v)) return "bool";
@@ -680,9 +706,9 @@ void Interpreter::defineNatives() {
     ));
     
     // keys(hashmap) - get all keys from a hash map  // NEW!
-    globals_->define("keys", std::make_shared<NativeFunction>(
+    globals_->define("keys", makeRef<NativeFunction>(
         1,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             if (!isHashMap(args[0])) {
                 throw std::runtime_error("keys() requires a hashmap argument");
             }
@@ -691,7 +717,7 @@ void Interpreter::defineNatives() {
             auto keysVec = map->getKeys();
             
             // Create an array with the keys
-            auto resultArray = std::make_shared<VoltArray>();
+            auto resultArray = makeRef<VoltArray>();
             for (const auto& key : keysVec) {
                 resultArray->push(key);
             }
@@ -702,9 +728,9 @@ void Interpreter::defineNatives() {
     ));
     
     // values(hashmap) - get all values from a hash map  // NEW!
-    globals_->define("values", std::make_shared<NativeFunction>(
+    globals_->define("values", makeRef<NativeFunction>(
         1,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             if (!isHashMap(args[0])) {
                 throw std::runtime_error("values() requires a hashmap argument");
             }
@@ -713,7 +739,7 @@ void Interpreter::defineNatives() {
             auto valuesVec = map->getValues();
             
             // Create an array with the values
-            auto resultArray = std::make_shared<VoltArray>();
+            auto resultArray = makeRef<VoltArray>();
             for (const auto& value : valuesVec) {
                 resultArray->push(value);
             }
@@ -724,9 +750,9 @@ void Interpreter::defineNatives() {
     ));
     
     // has(hashmap, key) - check if a key exists in a hash map  // NEW!
-    globals_->define("has", std::make_shared<NativeFunction>(
+    globals_->define("has", makeRef<NativeFunction>(
         2,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             if (!isHashMap(args[0])) {
                 throw std::runtime_error("has() requires a hashmap as first argument");
             }
@@ -734,20 +760,15 @@ void Interpreter::defineNatives() {
                 throw std::runtime_error("has() requires a string, number, boolean, or nil as key");
             }
             
-            auto map = asHashMap(args[0]);
-            
-            // Convert key to string
-            std::string keyStr = valueToString(args[1]);
-            
-            return map->contains(keyStr);
+            return asHashMap(args[0])->contains(args[1]);
         },
         "has"
     ));
     
     // remove(hashmap, key) - remove a key-value pair from a hash map  // NEW!
-    globals_->define("remove", std::make_shared<NativeFunction>(
+    globals_->define("remove", makeRef<NativeFunction>(
         2,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             if (!isHashMap(args[0])) {
                 throw std::runtime_error("remove() requires a hashmap as first argument");
             }
@@ -755,20 +776,15 @@ void Interpreter::defineNatives() {
                 throw std::runtime_error("remove() requires a string, number, boolean, or nil as key");
             }
             
-            auto map = asHashMap(args[0]);
-            
-            // Convert key to string
-            std::string keyStr = valueToString(args[1]);
-            
-            return map->remove(keyStr);  // Returns true if removed, false if not found
+            return asHashMap(args[0])->remove(args[1]);  // Returns true if removed, false if not found
         },
         "remove"
     ));
     
     // values(hashmap) - get all values from a hash map  // NEW!
-    globals_->define("values", std::make_shared<NativeFunction>(
+    globals_->define("values", makeRef<NativeFunction>(
         1,
-        [](const std::vector<Value>& args) -> Value {
+        [](std::span<const Value> args) -> Value {
             if (!isHashMap(args[0])) {
                 throw std::runtime_error("values() requires a hashmap argument");
             }
@@ -777,7 +793,7 @@ void Interpreter::defineNatives() {
             auto valuesVec = map->getValues();
             
             // Create an array with the values
-            auto resultArray = std::make_shared<VoltArray>();
+            auto resultArray = makeRef<VoltArray>();
             for (const auto& value : valuesVec) {
                 resultArray->push(value);
             }
@@ -786,124 +802,234 @@ void Interpreter::defineNatives() {
         },
         "values"
     ));
+    
+    // Array(n, init) - an array of n copies of init, allocated once
+    globals_->define("Array", makeRef<NativeFunction>(
+        [](const Value& count, const Value& init) -> Value {
+            if (!isNumber(count) || asNumber(count) < 0 ||
+                std::floor(asNumber(count)) != asNumber(count)) {
+                throw std::runtime_error("Array() requires a non-negative integer length");
+            }
+            return makeRef<VoltArray>(std::vector<Value>(static_cast<size_t>(asNumber(count)), init));
+        },
+        "Array"
+    ));
+    
+    // gcStats() - what the collector did, and how much is alive now
+    globals_->define("gcStats", makeRef<NativeFunction>(
+        0,
+        [](std::span<const Value>) -> Value {
+            const GcStats& stats = Collector::stats();
+            auto number = [](size_t n) { return Value(static_cast<double>(n)); };
+            auto result = makeRef<VoltHashMap>();
+            result->set("collections", number(stats.collections));
+            result->set("oldPasses", number(stats.oldPasses));
+            result->set("lastPauseMs", stats.lastPauseMs);
+            result->set("maxPauseMs", stats.maxPauseMs);
+            result->set("totalPauseMs", stats.totalPauseMs);
+            result->set("lastBytesPromoted", number(stats.lastBytesPromoted));
+            result->set("bytesPromoted", number(stats.bytesPromoted));
+            result->set("lastFreed", number(stats.lastFreed));
+            result->set("freed", number(stats.freed));
+            result->set("youngObjects", number(Collector::youngCount()));
+            result->set("oldObjects", number(Collector::oldCount()));
+            result->set("liveBytes", number(Collector::liveBytes()));
+            result->set("pauseBudgetMs", Collector::pauseBudget());
+            return result;
+        },
+        "gcStats"
+    ));
 }
 
 // ========================================
 // STATEMENT EXECUTION
 // ========================================
 
-void Interpreter::execute(Stmt* stmt) {
-    if (auto* exprStmt = dynamic_cast<ExprStmt*>(stmt)) {
-        executeExprStmt(exprStmt);
-    } else if (auto* printStmt = dynamic_cast<PrintStmt*>(stmt)) {
-        executePrintStmt(printStmt);
-    } else if (auto* letStmt = dynamic_cast<LetStmt*>(stmt)) {
-        executeLetStmt(letStmt);
-    } else if (auto* blockStmt = dynamic_cast<BlockStmt*>(stmt)) {
-        executeBlockStmt(blockStmt);
-    } else if (auto* ifStmt = dynamic_cast<IfStmt*>(stmt)) {
-        executeIfStmt(ifStmt);
-    } else if (auto* whileStmt = dynamic_cast<WhileStmt*>(stmt)) {
-        executeWhileStmt(whileStmt);
-    } else if (auto* runUntilStmt = dynamic_cast<RunUntilStmt*>(stmt)) {
-        executeRunUntilStmt(runUntilStmt);
-    } else if (auto* forStmt = dynamic_cast<ForStmt*>(stmt)) {
-        executeForStmt(forStmt);
-    } else if (auto* fnStmt = dynamic_cast<FnStmt*>(stmt)) {
-        executeFnStmt(fnStmt);
-    } else if (auto* returnStmt = dynamic_cast<ReturnStmt*>(stmt)) {
-        executeReturnStmt(returnStmt);
-    } else if (auto* breakStmt = dynamic_cast<BreakStmt*>(stmt)) {
-        executeBreakStmt(breakStmt);
-    } else if (auto* continueStmt = dynamic_cast<ContinueStmt*>(stmt)) {
-        executeContinueStmt(continueStmt);
-    } else {
-        throw std::runtime_error("Unknown statement type");
+// Dispatch on the node's kind tag: one jump regardless of node type
+Completion Interpreter::execute(Stmt* stmt) {
+    Collector::safepoint();
+    switch (stmt->kind) {
+        case StmtKind::Expr:
+            executeExprStmt(static_cast<ExprStmt*>(stmt));
+            return Completion::Normal;
+        case StmtKind::Print:
+            executePrintStmt(static_cast<PrintStmt*>(stmt));
+            return Completion::Normal;
+        case StmtKind::Let:
+            executeLetStmt(static_cast<LetStmt*>(stmt));
+            return Completion::Normal;
+        case StmtKind::Block:
+            return executeBlockStmt(static_cast<BlockStmt*>(stmt));
+        case StmtKind::If:
+            return executeIfStmt(static_cast<IfStmt*>(stmt));
+        case StmtKind::While:
+            return executeWhileStmt(static_cast<WhileStmt*>(stmt));
+        case StmtKind::RunUntil:
+            return executeRunUntilStmt(static_cast<RunUntilStmt*>(stmt));
+        case StmtKind::For:
+            return executeForStmt(static_cast<ForStmt*>(stmt));
+        case StmtKind::Fn:
+            executeFnStmt(static_cast<FnStmt*>(stmt));
+            return Completion::Normal;
+        case StmtKind::Return:
+            return executeReturnStmt(static_cast<ReturnStmt*>(stmt));
+        case StmtKind::Break:
+            return executeBreakStmt(static_cast<BreakStmt*>(stmt));
+        case StmtKind::Continue:
+            return executeContinueStmt(static_cast<ContinueStmt*>(stmt));
     }
+    throw std::runtime_error("Unknown statement type");
 }
 
 void Interpreter::execute(const std::vector<StmtPtr>& statements) {
+    // Undefined variables are reported here, before anything runs
+    Resolver resolver([this](const std::string& name) { return globals_->exists(name); });
+    resolver.resolve(statements);
+    
+    if (engine_ == Engine::Vm) {
+        vm().execute(statements);
+        return;
+    }
     for (const auto& stmt : statements) {
-        execute(stmt.get());
+        // A top-level 'return' ends the script, as it does on the VM
+        if (execute(stmt.get()) == Completion::Return) {
+            returnValue_ = nullptr;
+            return;
+        }
     }
 }
 
 void Interpreter::executeExprStmt(ExprStmt* stmt) {
-    evaluate(stmt->expr.get());
+    evaluateExpr(stmt->expr.get());
 }
 
 void Interpreter::executePrintStmt(PrintStmt* stmt) {
-    Value value = evaluate(stmt->expr.get());
+    Value value = evaluateExpr(stmt->expr.get());
     std::cout << valueToString(value) << "\n";
 }
 
 void Interpreter::executeLetStmt(LetStmt* stmt) {
     Value value = nullptr;
     if (stmt->initializer) {
-        value = evaluate(stmt->initializer.get());
+        value = evaluateExpr(stmt->initializer.get());
+    }
+    if (stmt->slot < 0) {
+        globals_->define(stmt->name, value);
+    } else {
+        environment_->defineAt(stmt->slot, value);
     }
-    environment_->define(stmt->name, value);
 }
 
-void Interpreter::executeBlockStmt(BlockStmt* stmt) {
-    executeBlock(stmt->statements,
-                 std::make_shared<Environment>(environment_));
+Completion Interpreter::executeBlockStmt(BlockStmt* stmt) {
+    auto scope = acquireScope(environment_, stmt->layout);
+    Completion completion = executeBlock(stmt->statements, scope);
+    releaseScope(scope);
+    return completion;
 }
 
-void Interpreter::executeBlock(const std::vector<StmtPtr>& statements,
-                                std::shared_ptr<Environment> environment) {
+// Stops at the first statement that doesn't complete normally and
+// passes its completion on to the enclosing loop or call
+Completion Interpreter::executeBlock(const std::vector<StmtPtr>& statements,
+                                     std::shared_ptr<Environment> environment) {
     std::shared_ptr<Environment> previous = environment_;
+    Completion completion = Completion::Normal;
     try {
         environment_ = environment;
         for (const auto& stmt : statements) {
-            execute(stmt.get());
+            completion = execute(stmt.get());
+            if (completion != Completion::Normal) break;
         }
         environment_ = previous;
     } catch (...) {
         environment_ = previous;
         throw;
     }
+    return completion;
+}
+
+std::shared_ptr<Environment> Interpreter::acquireScope(std::shared_ptr<Environment> enclosing,
+                                                    const ScopeLayout& layout) {
+    if (scopePool_.empty()) {
+        return std::make_shared<Environment>(std::move(enclosing), layout);
+    }
+    std::shared_ptr<Environment> scope = std::move(scopePool_.back());
+    scopePool_.pop_back();
+    scope->reuse(std::move(enclosing), layout);
+    return scope;
+}
+
+// A scope still shared with a closure (or anything else) lives on as an
+// ordinary heap object; only unshared ones are recycled
+void Interpreter::releaseScope(std::shared_ptr<Environment>& scope) {
+    if (scope && scope.use_count() == 1 && scopePool_.size() < kScopePoolSize) {
+        scope->retire();
+        scopePool_.push_back(std::move(scope));
+    }
+    scope.reset();
+}
+
+// A loop's block body gets fresh variables every iteration. Its scope is
+// recycled unless a closure from the previous iteration still holds it.
+Completion Interpreter::executeLoopBody(Stmt* body, std::shared_ptr<Environment>& scope) {
+    if (body->kind != StmtKind::Block) {
+        return execute(body);
+    }
+    auto* block = static_cast<BlockStmt*>(body);
+    if (scope && scope.use_count() == 1) {
+        scope->clearSlots();
+    } else {
+        scope = acquireScope(environment_, block->layout);
+    }
+    return executeBlock(block->statements, scope);
 }
 
-void Interpreter::executeIfStmt(IfStmt* stmt) {
-    Value condition = evaluate(stmt->condition.get());
+Completion Interpreter::executeIfStmt(IfStmt* stmt) {
+    Value condition = evaluateExpr(stmt->condition.get());
     if (isTruthy(condition)) {
-        execute(stmt->thenBranch.get());
+        return execute(stmt->thenBranch.get());
     } else if (stmt->elseBranch) {
-        execute(stmt->elseBranch.get());
+        return execute(stmt->elseBranch.get());
     }
+    return Completion::Normal;
 }
 
-void Interpreter::executeWhileStmt(WhileStmt* stmt) {
-    while (isTruthy(evaluate(stmt->condition.get()))) {
-        try {
-            execute(stmt->body.get());
-        } catch (const ContinueException&) {
-            continue; // Continue to next iteration
-        } catch (const BreakException&) {
-            break; // Exit the loop
+Completion Interpreter::executeWhileStmt(WhileStmt* stmt) {
+    std::shared_ptr<Environment> bodyEnv;
+    while (isTruthy(evaluateExpr(stmt->condition.get()))) {
+        Completion completion = executeLoopBody(stmt->body.get(), bodyEnv);
+        if (completion == Completion::Break) break;
+        if (completion == Completion::Return) {
+            releaseScope(bodyEnv);
+            return completion;
         }
+        // Continue - check the condition again
     }
+    releaseScope(bodyEnv);
+    return Completion::Normal;
 }
 
-void Interpreter::executeRunUntilStmt(RunUntilStmt* stmt) {
+Completion Interpreter::executeRunUntilStmt(RunUntilStmt* stmt) {
     // Run-until: executes body at least once, then continues until condition becomes TRUE
     // This is different from do-while which continues while condition is true
+    std::shared_ptr<Environment> bodyEnv;
     do {
-        try {
-            execute(stmt->body.get());
-        } catch (const ContinueException&) {
-            continue; // Continue to next iteration
-        } catch (const BreakException&) {
-            break; // Exit the loop
+        Completion completion = executeLoopBody(stmt->body.get(), bodyEnv);
+        if (completion == Completion::Break) break;
+        if (completion == Completion::Return) {
+            releaseScope(bodyEnv);
+            return completion;
         }
-    } while (!isTruthy(evaluate(stmt->condition.get())));
+        // Continue - check the condition
+    } while (!isTruthy(evaluateExpr(stmt->condition.get())));
+    releaseScope(bodyEnv);
+    return Completion::Normal;
 }
 
-void Interpreter::executeForStmt(ForStmt* stmt) {
+Completion Interpreter::executeForStmt(ForStmt* stmt) {
     // Create new scope for loop
-    auto loopEnv = std::make_shared<Environment>(environment_);
+    auto loopEnv = acquireScope(environment_, stmt->layout);
     auto previous = environment_;
+    Completion result = Completion::Normal;
     try {
         environment_ = loopEnv;
         
@@ -912,180 +1038,357 @@ void Interpreter::executeForStmt(ForStmt* stmt) {
             execute(stmt->initializer.get());
         }
         
+        if (stmt->counted.slot >= 0 && isNumber(loopEnv->getAt(0, stmt->counted.slot))) {
+            result = executeCountedLoop(stmt, *loopEnv);
+            environment_ = previous;
+            releaseScope(loopEnv);
+            return result;
+        }
+        
         // Condition (default to true if omitted)
         auto checkCondition = [&]() {
             if (stmt->condition) {
-                return isTruthy(evaluate(stmt->condition.get()));
+                return isTruthy(evaluateExpr(stmt->condition.get()));
             }
             return true;
         };
         
         // Loop with break/continue support
+        std::shared_ptr<Environment> bodyEnv;
         while (checkCondition()) {
-            try {
-                execute(stmt->body.get());
-            } catch (const ContinueException&) {
-                // Continue - execute increment and check condition
-            } catch (const BreakException&) {
-                break; // Exit the loop
+            Completion completion = executeLoopBody(stmt->body.get(), bodyEnv);
+            if (completion == Completion::Break) break;
+            if (completion == Completion::Return) {
+                result = completion;
+                break;
             }
+            // Continue - execute increment and check condition
             
             // Execute increment
             if (stmt->increment) {
-                evaluate(stmt->increment.get());
+                evaluateExpr(stmt->increment.get());
             }
         }
+        releaseScope(bodyEnv);
         
         environment_ = previous;
+        releaseScope(loopEnv);
     } catch (...) {
         environment_ = previous;
         throw;
     }
+    return result;
+}
+
+// for (let i = a; i < b; i++) with a number counter nothing else assigns:
+// the counter lives in a double and is only stored back to its slot for
+// the body to read. The bound is still evaluated every iteration, as the
+// condition would be, unless it is a literal.
+Completion Interpreter::executeCountedLoop(ForStmt* stmt, Environment& loopEnv) {
+    const CountedLoop& loop = stmt->counted;
+    auto* condition = static_cast<BinaryExpr*>(stmt->condition.get());
+    Expr* boundExpr = condition->right.get();
+    bool constantBound = boundExpr->kind == ExprKind::Literal;
+    Value bound = constantBound ? evaluateExpr(boundExpr) : Value();
+    
+    double counter = asNumber(loopEnv.getAt(0, loop.slot));
+    std::shared_ptr<Environment> bodyEnv;
+    while (true) {
+        if (!constantBound) bound = evaluateExpr(boundExpr);
+        bool more;
+        if (isNumber(bound)) {
+            double limit = asNumber(bound);
+            switch (loop.compare) {
+                case TokenType::Less: more = counter < limit; break;
+                case TokenType::LessEqual: more = counter <= limit; break;
+                case TokenType::Greater: more = counter > limit; break;
+                default: more = counter >= limit; break;
+            }
+        } else {
+            more = isTruthy(binaryOp(condition->op, counter, bound));  // Reports the type error
+        }
+        if (!more) break;
+        
+        Completion completion = executeLoopBody(stmt->body.get(), bodyEnv);
+        if (completion == Completion::Break) break;
+        if (completion == Completion::Return) {
+            releaseScope(bodyEnv);
+            return completion;
+        }
+        
+        counter += loop.step;
+        loopEnv.defineAt(loop.slot, counter);
+    }
+    releaseScope(bodyEnv);
+    return Completion::Normal;
 }
 
 void Interpreter::executeFnStmt(FnStmt* stmt) {
-    // Create a function object that captures the current environment
-    // This is what makes closures work!
-    auto function = std::make_shared<VoltFunction>(stmt, environment_);
+    // Create a function object holding the cells of the enclosing
+    // variables it uses. This is what makes closures work!
+    std::vector<Ref<Cell>> captures;
+    captures.reserve(stmt->captures.size());
+    for (const Capture& capture : stmt->captures) {
+        captures.push_back(capture.local ? environment_->cellAt(capture.depth, capture.slot)
+                                         : (*captures_)[capture.index]);
+    }
+    auto function = makeRef<VoltFunction>(stmt, std::move(captures));
     
     // Define the function in the current scope
     // Note: We define it AFTER creating the closure, but that's okay
     // because the function name isn't in scope inside its own body
     // (unless you reference it for recursion, which we handle specially)
-    environment_->define(stmt->name, function);
+    if (stmt->slot < 0) {
+        globals_->define(stmt->name, function);
+    } else {
+        environment_->defineAt(stmt->slot, function);
+    }
 }
 
-void Interpreter::executeReturnStmt(ReturnStmt* stmt) {
+Completion Interpreter::executeReturnStmt(ReturnStmt* stmt) {
+    if (stmt->tailCall) {
+        return executeTailCall(static_cast<CallExpr*>(stmt->value.get()));
+    }
+    
     Value value = nullptr;
     if (stmt->value) {
-        value = evaluate(stmt->value.get());
+        value = evaluateExpr(stmt->value.get());
     }
     
-    // Throw a special exception to unwind the call stack
-    // This is caught in VoltFunction::call()
-    throw ReturnValue(value);
+    // Park the value; the Return completion unwinds to VoltFunction::call()
+    returnValue_ = std::move(value);
+    return Completion::Return;
 }
-// ========================================
-// EXPRESSION EVALUATION
-// ========================================
 
-Value Interpreter::evaluate(Expr* expr) {
-    if (auto* lit = dynamic_cast<LiteralExpr*>(expr)) {
-        return evaluateLiteral(lit);
-    }
-    
-    if (auto* var = dynamic_cast<VariableExpr*>(expr)) {
-        return evaluateVariable(var);
-    }
-    
-    if (auto* unary = dynamic_cast<UnaryExpr*>(expr)) {
-        return evaluateUnary(unary);
-    }
-    
-    if (auto* binary = dynamic_cast<BinaryExpr*>(expr)) {
-        return evaluateBinary(binary);
-    }
-    
-    if (auto* logical = dynamic_cast<LogicalExpr*>(expr)) {
-        return evaluateLogical(logical);
-    }
-    
-    if (auto* group = dynamic_cast<GroupingExpr*>(expr)) {
-        return evaluateGrouping(group);
+// 'return f(...)': a call to a script function is parked for the
+// VoltFunction::call below us to make, so tail recursion runs in one
+// native frame; natives are simply called
+Completion Interpreter::executeTailCall(CallExpr* expr) {
+    Value callee = evaluateExpr(expr->callee.get());
+    
+    // Arguments may make calls of their own, which park tail calls too,
+    // so collect them locally first
+    size_t argCount = expr->arguments.size();
+    std::vector<Value> spilled;
+    Value inlineArguments[kInlineArgs];
+    Value* arguments = inlineArguments;
+    if (argCount > kInlineArgs) {
+        spilled.resize(argCount);
+        arguments = spilled.data();
     }
-    
-    if (auto* call = dynamic_cast<CallExpr*>(expr)) {
-        return evaluateCall(call);
-    }
-    
-    if (auto* assign = dynamic_cast<AssignExpr*>(expr)) {
-        return evaluateAssign(assign);
+    for (size_t i = 0; i < argCount; i++) {
+        arguments[i] = evaluateExpr(expr->arguments[i].get());
     }
     
-    if (auto* compound = dynamic_cast<CompoundAssignExpr*>(expr)) {
-        return evaluateCompoundAssign(compound);
+    VoltFunction* function = isCallable(callee) ? dynamic_cast<VoltFunction*>(asCallable(callee).get())
+                                                : nullptr;
+    if (!function || function->arity() != static_cast<int>(argCount)) {
+        // Natives, and the usual errors
+        returnValue_ = callValue(expr->token, callee, std::span<const Value>(arguments, argCount));
+        return Completion::Return;
     }
     
-    if (auto* update = dynamic_cast<UpdateExpr*>(expr)) {
-        return evaluateUpdate(update);
-    }
-    
-    if (auto* ternary = dynamic_cast<TernaryExpr*>(expr)) {
-        return evaluateTernary(ternary);
-    }
-    
-    // ========================================
-    // ARRAY EXPRESSIONS - NEW!
-    // ========================================
-    
-    if (auto* array = dynamic_cast<ArrayExpr*>(expr)) {
-        return evaluateArray(array);
-    }
-    
-    if (auto* index = dynamic_cast<IndexExpr*>(expr)) {
-        return evaluateIndex(index);
-    }
-    
-    if (auto* indexAssign = dynamic_cast<IndexAssignExpr*>(expr)) {
-        return evaluateIndexAssign(indexAssign);
+    tailCallArguments_.clear();
+    for (size_t i = 0; i < argCount; i++) {
+        tailCallArguments_.push_back(std::move(arguments[i]));
     }
+    tailCall_ = Ref<VoltFunction>(function);
+    returnValue_ = nullptr;
+    return Completion::Return;
+}
+
+// ========================================
+// EXPRESSION EVALUATION
+// ========================================
+
+Value Interpreter::evaluate(Expr* expr) {
+    Resolver resolver([this](const std::string& name) { return globals_->exists(name); });
+    resolver.resolve(expr);
     
-    if (auto* member = dynamic_cast<MemberExpr*>(expr)) {
-        return evaluateMember(member);
+    if (engine_ == Engine::Vm) {
+        return vm().evaluate(expr);
     }
-    
-    // ========================================
-    // HASH MAP EXPRESSIONS - NEW!
-    // ========================================
-    
-    if (auto* hashMap = dynamic_cast<HashMapExpr*>(expr)) {
-        return evaluateHashMap(hashMap);
+    return evaluateExpr(expr);
+}
+
+Value Interpreter::evaluateExpr(Expr* expr) {
+    switch (expr->kind) {
+        case ExprKind::Literal:
+            return evaluateLiteral(static_cast<LiteralExpr*>(expr));
+        case ExprKind::Variable:
+            return evaluateVariable(static_cast<VariableExpr*>(expr));
+        case ExprKind::Unary:
+            return evaluateUnary(static_cast<UnaryExpr*>(expr));
+        case ExprKind::Binary:
+            return evaluateBinary(static_cast<BinaryExpr*>(expr));
+        case ExprKind::Logical:
+            return evaluateLogical(static_cast<LogicalExpr*>(expr));
+        case ExprKind::Grouping:
+            return evaluateGrouping(static_cast<GroupingExpr*>(expr));
+        case ExprKind::Call:
+            return evaluateCall(static_cast<CallExpr*>(expr));
+        case ExprKind::Assign:
+            return evaluateAssign(static_cast<AssignExpr*>(expr));
+        case ExprKind::CompoundAssign:
+            return evaluateCompoundAssign(static_cast<CompoundAssignExpr*>(expr));
+        case ExprKind::Update:
+            return evaluateUpdate(static_cast<UpdateExpr*>(expr));
+        case ExprKind::Ternary:
+            return evaluateTernary(static_cast<TernaryExpr*>(expr));
+        case ExprKind::Array:
+            return evaluateArray(static_cast<ArrayExpr*>(expr));
+        case ExprKind::Index:
+            return evaluateIndex(static_cast<IndexExpr*>(expr));
+        case ExprKind::IndexAssign:
+            return evaluateIndexAssign(static_cast<IndexAssignExpr*>(expr));
+        case ExprKind::Member:
+            return evaluateMember(static_cast<MemberExpr*>(expr));
+        case ExprKind::MemberAssign:
+            return evaluateMemberAssign(static_cast<MemberAssignExpr*>(expr));
+        case ExprKind::MethodCall:
+            return evaluateMethodCall(static_cast<MethodCallExpr*>(expr));
+        case ExprKind::HashMap:
+            return evaluateHashMap(static_cast<HashMapExpr*>(expr));
     }
     
     throw std::runtime_error("Unknown expression type");
 }
 
 Value Interpreter::evaluateLiteral(LiteralExpr* expr) {
-    switch (expr->type) {
-        case LiteralExpr::Type::Number:
-            return expr->numberValue;
-        case LiteralExpr::Type::String:
-            return expr->stringValue;
-        case LiteralExpr::Type::Bool:
-            return expr->boolValue;
-        case LiteralExpr::Type::Nil:
-            return nullptr;
-    }
-    return nullptr;
+    return expr->value;
 }
 
 Value Interpreter::evaluateVariable(VariableExpr* expr) {
-    try {
-        return environment_->get(expr->name);
-    } catch (const std::runtime_error& e) {
-        throw RuntimeError(expr->token, e.what());
+    return readVariable(expr->binding, expr->name, expr->token);
+}
+
+// Read/write for resolved names that must already exist (+=, ++, --)
+Value Interpreter::readVariable(Binding& binding, const std::string& name, const Token& token) {
+    if (binding.isLocal()) {
+        return environment_->getAt(binding.depth, binding.slot);
     }
+    if (binding.isCapture()) {
+        return (*captures_)[binding.capture]->value;
+    }
+    if (Value* slot = globals_->lookupGlobal(name, binding.cache)) {
+        return *slot;
+    }
+    throw RuntimeError(token, "Undefined variable: " + name);
+}
+
+void Interpreter::writeVariable(Binding& binding, const std::string& name, const Token& token, Value value) {
+    if (binding.isLocal()) {
+        environment_->assignAt(binding.depth, binding.slot, std::move(value));
+        return;
+    }
+    if (binding.isCapture()) {
+        (*captures_)[binding.capture]->value = std::move(value);
+        return;
+    }
+    if (Value* slot = globals_->lookupGlobal(name, binding.cache)) {
+        *slot = std::move(value);
+        return;
+    }
+    throw RuntimeError(token, "Undefined variable: " + name);
 }
 
 Value Interpreter::evaluateUnary(UnaryExpr* expr) {
-    Value right = evaluate(expr->right.get());
-    
-    switch (expr->op.type) {
+    Value right = evaluateExpr(expr->right.get());
+    return unaryOp(expr->op, right);
+}
+
+Value Interpreter::unaryOp(const Token& op, const Value& right) {
+    switch (op.type) {
         case TokenType::Minus:
-            checkNumberOperand(expr->op, right);
+            checkNumberOperand(op, right);
             return -asNumber(right);
         case TokenType::Bang:
             return !isTruthy(right);
         default:
-            throw RuntimeError(expr->op, "Unknown unary operator");
+            throw RuntimeError(op, "Unknown unary operator");
+    }
+}
+
+// ==================== QUICKENED FAST PATHS ====================
+
+namespace {
+
+// binaryOp for two numbers; false when the full path is needed (x / 0)
+inline bool numberBinaryOp(TokenType op, double a, double b, Value& result) {
+    switch (op) {
+        case TokenType::Plus: result = a + b; return true;
+        case TokenType::Minus: result = a - b; return true;
+        case TokenType::Star: result = a * b; return true;
+        case TokenType::Slash:
+            if (b == 0.0) return false;
+            result = a / b;
+            return true;
+        case TokenType::Percent: result = std::fmod(a, b); return true;
+        case TokenType::Greater: result = a > b; return true;
+        case TokenType::GreaterEqual: result = a >= b; return true;
+        case TokenType::Less: result = a < b; return true;
+        case TokenType::LessEqual: result = a <= b; return true;
+        case TokenType::EqualEqual: result = a == b; return true;
+        case TokenType::BangEqual: result = a != b; return true;
+        default: return false;
+    }
+}
+
+// compoundOp for two numbers; false when the full path is needed
+inline bool numberCompoundOp(TokenType op, double a, double b, Value& result) {
+    switch (op) {
+        case TokenType::PlusEqual: result = a + b; return true;
+        case TokenType::MinusEqual: result = a - b; return true;
+        case TokenType::StarEqual: result = a * b; return true;
+        case TokenType::SlashEqual:
+            if (b == 0.0) return false;
+            result = a / b;
+            return true;
+        default: return false;
     }
 }
 
+// What a binary or compound operator saw, for QuickenState::observe
+inline Quickened classifyOperands(const Value& left, const Value& right, bool isAdd) {
+    if (isNumber(left) && isNumber(right)) return Quickened::Numbers;
+    if (isAdd && isString(left) && isString(right)) return Quickened::Strings;
+    return Quickened::Generic;
+}
+
+} // anonymous namespace
+
 Value Interpreter::evaluateBinary(BinaryExpr* expr) {
-    Value left = evaluate(expr->left.get());
-    Value right = evaluate(expr->right.get());
+    Value left = evaluateExpr(expr->left.get());
+    Value right = evaluateExpr(expr->right.get());
     
-    switch (expr->op.type) {
+    switch (expr->quick.mode) {
+        case Quickened::Numbers:
+            if (isNumber(left) && isNumber(right)) {
+                Value result;
+                if (numberBinaryOp(expr->op.type, asNumber(left), asNumber(right), result)) {
+                    return result;
+                }
+                break;
+            }
+            expr->quick.deoptimize();
+            break;
+        case Quickened::Strings:
+            if (isString(left) && isString(right)) {
+                return asString(left) + asString(right);
+            }
+            expr->quick.deoptimize();
+            break;
+        case Quickened::Cold:
+            expr->quick.observe(classifyOperands(left, right, expr->op.type == TokenType::Plus));
+            break;
+        default:
+            break;
+    }
+    return binaryOp(expr->op, left, right);
+}
+
+Value Interpreter::binaryOp(const Token& op, const Value& left, const Value& right) {
+    switch (op.type) {
         case TokenType::Plus:
             if (isNumber(left) && isNumber(right)) {
                 return asNumber(left) + asNumber(right);
@@ -1100,35 +1403,35 @@ Value Interpreter::evaluateBinary(BinaryExpr* expr) {
             if (isNumber(left) && isString(right)) {
                 return valueToString(left) + asString(right);
             }
-            throw RuntimeError(expr->op, "Operands must be two numbers or two strings");
+            throw RuntimeError(op, "Operands must be two numbers or two strings");
             
         case TokenType::Minus:
-            checkNumberOperands(expr->op, left, right);
+            checkNumberOperands(op, left, right);
             return asNumber(left) - asNumber(right);
         case TokenType::Star:
-            checkNumberOperands(expr->op, left, right);
+            checkNumberOperands(op, left, right);
             return asNumber(left) * asNumber(right);
         case TokenType::Slash:
-            checkNumberOperands(expr->op, left, right);
+            checkNumberOperands(op, left, right);
             if (asNumber(right) == 0.0) {
-                throw RuntimeError(expr->op, "Division by zero");
+                throw RuntimeError(op, "Division by zero");
             }
             return asNumber(left) / asNumber(right);
         case TokenType::Percent:
-            checkNumberOperands(expr->op, left, right);
+            checkNumberOperands(op, left, right);
             return std::fmod(asNumber(left), asNumber(right));
             
         case TokenType::Greater:
-            checkNumberOperands(expr->op, left, right);
+            checkNumberOperands(op, left, right);
             return asNumber(left) > asNumber(right);
         case TokenType::GreaterEqual:
-            checkNumberOperands(expr->op, left, right);
+            checkNumberOperands(op, left, right);
             return asNumber(left) >= asNumber(right);
         case TokenType::Less:
-            checkNumberOperands(expr->op, left, right);
+            checkNumberOperands(op, left, right);
             return asNumber(left) < asNumber(right);
         case TokenType::LessEqual:
-            checkNumberOperands(expr->op, left, right);
+            checkNumberOperands(op, left, right);
             return asNumber(left) <= asNumber(right);
             
         case TokenType::EqualEqual:
@@ -1137,12 +1440,12 @@ Value Interpreter::evaluateBinary(BinaryExpr* expr) {
             return !isEqual(left, right);
             
         default:
-            throw RuntimeError(expr->op, "Unknown binary operator");
+            throw RuntimeError(op, "Unknown binary operator");
     }
 }
 
 Value Interpreter::evaluateLogical(LogicalExpr* expr) {
-    Value left = evaluate(expr->left.get());
+    Value left = evaluateExpr(expr->left.get());
     
     // Short-circuit evaluation
     if (expr->op.type == TokenType::Or) {
@@ -1151,37 +1454,52 @@ Value Interpreter::evaluateLogical(LogicalExpr* expr) {
         if (!isTruthy(left)) return left;
     }
     
-    return evaluate(expr->right.get());
+    return evaluateExpr(expr->right.get());
 }
 
 Value Interpreter::evaluateGrouping(GroupingExpr* expr) {
-    return evaluate(expr->expr.get());
+    return evaluateExpr(expr->expr.get());
 }
 
 Value Interpreter::evaluateCall(CallExpr* expr) {
     // Evaluate the callee (the thing being called)
-    Value callee = evaluate(expr->callee.get());
-    
-    // Evaluate all the arguments
-    std::vector<Value> arguments;
-    for (const auto& arg : expr->arguments) {
-        arguments.push_back(evaluate(arg.get()));
+    Value callee = evaluateExpr(expr->callee.get());
+    
+    // Evaluate all the arguments into a stack buffer; only calls with
+    // more than kInlineArgs arguments need the heap
+    size_t argCount = expr->arguments.size();
+    if (argCount > kInlineArgs) {
+        std::vector<Value> arguments;
+        arguments.reserve(argCount);
+        for (const auto& arg : expr->arguments) {
+            arguments.push_back(evaluateExpr(arg.get()));
+        }
+        return callValue(expr->token, callee, arguments);
     }
     
+    Value arguments[kInlineArgs];
+    for (size_t i = 0; i < argCount; i++) {
+        arguments[i] = evaluateExpr(expr->arguments[i].get());
+    }
+    return callValue(expr->token, callee, std::span<const Value>(arguments, argCount));
+}
+
+Value Interpreter::callValue(const Token& token, const Value& callee,
+                             std::span<const Value> arguments) {
     // Make sure it's actually a function
     if (!isCallable(callee)) {
         throw RuntimeError(
-            expr->token,
+            token,
             "Can only call functions and classes"
         );
     }
     
-    auto function = std::get<std::shared_ptr<Callable>>(callee);
+    auto function = asCallable(callee);
     
     // Check arity (number of arguments)
     if (static_cast<int>(arguments.size()) != function->arity()) {
         throw RuntimeError(
-            expr->token,
+            token,
             "Expected " + std::to_string(function->arity()) +
             " arguments but got " + std::to_string(arguments.size())
         );
@@ -1192,28 +1510,61 @@ Value Interpreter::evaluateCall(CallExpr* expr) {
 }
 
 Value Interpreter::evaluateAssign(AssignExpr* expr) {
-    Value value = evaluate(expr->value.get());
-    try {
-        environment_->assign(expr->name, value);
-    } catch (const std::runtime_error&) {
+    Value value = evaluateExpr(expr->value.get());
+    if (expr->binding.isLocal()) {
+        // Implicit declarations already have a slot from the Resolver
+        environment_->assignAt(expr->binding.depth, expr->binding.slot, value);
+    } else if (expr->binding.isCapture()) {
+        (*captures_)[expr->binding.capture]->value = value;
+    } else if (Value* slot = globals_->lookupGlobal(expr->name, expr->binding.cache)) {
+        *slot = value;
+    } else {
         // If variable doesn't exist, create it (implicit declaration)
-        environment_->define(expr->name, value);
+        globals_->define(expr->name, value);
     }
     return value;
 }
 
 Value Interpreter::evaluateCompoundAssign(CompoundAssignExpr* expr) {
-    Value current;
-    try {
-        current = environment_->get(expr->name);
-    } catch (const std::runtime_error& e) {
-        throw RuntimeError(expr->token, e.what());
+    Value current = readVariable(expr->binding, expr->name, expr->token);
+    Value operand = evaluateExpr(expr->value.get());
+    
+    Value result;
+    bool done = false;
+    switch (expr->quick.mode) {
+        case Quickened::Numbers:
+            if (isNumber(current) && isNumber(operand)) {
+                done = numberCompoundOp(expr->op.type, asNumber(current), asNumber(operand), result);
+            } else {
+                expr->quick.deoptimize();
+            }
+            break;
+        case Quickened::Strings:
+            if (isString(current) && isString(operand)) {
+                result = asString(current) + asString(operand);
+                done = true;
+            } else {
+                expr->quick.deoptimize();
+            }
+            break;
+        case Quickened::Cold:
+            expr->quick.observe(classifyOperands(current, operand, expr->op.type == TokenType::PlusEqual));
+            break;
+        default:
+            break;
+    }
+    if (!done) {
+        result = compoundOp(expr->op, current, operand);
     }
     
-    Value operand = evaluate(expr->value.get());
+    writeVariable(expr->binding, expr->name, expr->token, result);
+    return result;
+}
+
+Value Interpreter::compoundOp(const Token& op, const Value& current, const Value& operand) {
     Value result;
     
-    switch (expr->op.type) {
+    switch (op.type) {
         case TokenType::PlusEqual:
             if (isNumber(current) && isNumber(operand)) {
                 result = asNumber(current) + asNumber(operand);
@@ -1222,44 +1573,33 @@ Value Interpreter::evaluateCompoundAssign(CompoundAssignExpr* expr) {
             } else if (isString(current) && isNumber(operand)) {
                 result = asString(current) + valueToString(operand);
             } else {
-                throw RuntimeError(expr->op, "Operands must be compatible for +=");
+                throw RuntimeError(op, "Operands must be compatible for +=");
             }
             break;
         case TokenType::MinusEqual:
-            checkNumberOperands(expr->op, current, operand);
+            checkNumberOperands(op, current, operand);
             result = asNumber(current) - asNumber(operand);
             break;
         case TokenType::StarEqual:
-            checkNumberOperands(expr->op, current, operand);
+            checkNumberOperands(op, current, operand);
             result = asNumber(current) * asNumber(operand);
             break;
         case TokenType::SlashEqual:
-            checkNumberOperands(expr->op, current, operand);
+            checkNumberOperands(op, current, operand);
             if (asNumber(operand) == 0.0) {
-                throw RuntimeError(expr->op, "Division by zero");
+                throw RuntimeError(op, "Division by zero");
             }
             result = asNumber(current) / asNumber(operand);
             break;
         default:
-            throw RuntimeError(expr->op, "Unknown compound assignment operator");
+            throw RuntimeError(op, "Unknown compound assignment operator");
     }
     
-    try {
-        environment_->assign(expr->name, result);
-    } catch (const std::runtime_error& e) {
-        throw RuntimeError(expr->token, e.what());
-    }
     return result;
 }
 
 Value Interpreter::evaluateUpdate(UpdateExpr* expr) {
-    Value current;
-    try {
-        current = environment_->get(expr->name);
-    } catch (const std::runtime_error& e) {
-        throw RuntimeError(expr->token, e.what());
-    }
-    
+    Value current = readVariable(expr->binding, expr->name, expr->token);
     if (!isNumber(current)) {
         throw RuntimeError(expr->op, "Operand must be a number for increment/decrement");
     }
@@ -1272,21 +1612,17 @@ Value Interpreter::evaluateUpdate(UpdateExpr* expr) {
         newValue = oldValue - 1;
     }
     
-    try {
-        environment_->assign(expr->name, newValue);
-    } catch (const std::runtime_error& e) {
-        throw RuntimeError(expr->token, e.what());
-    }
+    writeVariable(expr->binding, expr->name, expr->token, newValue);
     
     // Return old value for postfix, new value for prefix
     return expr->prefix ? newValue : oldValue;
 }
 
 Value Interpreter::evaluateTernary(TernaryExpr* expr) {
-    if (isTruthy(evaluate(expr->condition.get()))) {
-        return evaluate(expr->thenBranch.get());
+    if (isTruthy(evaluateExpr(expr->condition.get()))) {
+        return evaluateExpr(expr->thenBranch.get());
     }
-    return evaluate(expr->elseBranch.get());
+    return evaluateExpr(expr->elseBranch.get());
 }
 
 // ========================================
@@ -1294,35 +1630,65 @@ Value Interpreter::evaluateTernary(TernaryExpr* expr) {
 // ========================================
 
 Value Interpreter::evaluateArray(ArrayExpr* expr) {
+    // All-literal arrays were built once by the Optimizer
+    if (isArray(expr->constant)) {
+        return makeRef<VoltArray>(asArray(expr->constant)->elements());
+    }
+    
     std::vector<Value> elements;
     
     // Evaluate all element expressions
     for (const auto& elem : expr->elements) {
-        elements.push_back(evaluate(elem.get()));
+        elements.push_back(evaluateExpr(elem.get()));
     }
     
     // Create and return array
-    return std::make_shared<VoltArray>(elements);
+    return makeRef<VoltArray>(elements);
 }
 
 Value Interpreter::evaluateIndex(IndexExpr* expr) {
-    Value object = evaluate(expr->object.get());
-    Value index = evaluate(expr->index.get());
-    
+    Value object = evaluateExpr(expr->object.get());
+    Value index = evaluateExpr(expr->index.get());
+    
+    switch (expr->quick.mode) {
+        case Quickened::ArrayIndex:
+            if (isArray(object) && isNumber(index)) {
+                // In-range reads only; anything else takes the full path
+                // for its error message
+                const auto& elements = asArray(object)->elements();
+                double i = asNumber(index);
+                if (i >= 0 && i < static_cast<double>(elements.size())) {
+                    return elements[static_cast<size_t>(i)];
+                }
+                break;
+            }
+            expr->quick.deoptimize();
+            break;
+        case Quickened::Cold:
+            expr->quick.observe(isArray(object) && isNumber(index) ? Quickened::ArrayIndex
+                                                                   : Quickened::Generic);
+            break;
+        default:
+            break;
+    }
+    return indexGet(expr->token, object, index);
+}
+
+Value Interpreter::indexGet(const Token& token, const Value& object, const Value& index) {
     // Handle arrays
     if (isArray(object)) {
         auto array = asArray(object);
         
         // Index must be a number
         if (!isNumber(index)) {
-            throw RuntimeError(expr->token, "Array index must be a number");
+            throw RuntimeError(token, "Array index must be a number");
         }
         
         int idx = static_cast<int>(asNumber(index));
         
         // Check bounds
         if (idx < 0 || idx >= array->length()) {
-            throw RuntimeError(expr->token, "Array index out of bounds: " + std::to_string(idx));
+            throw RuntimeError(token, "Array index out of bounds: " + std::to_string(idx));
         }
         
         return array->get(idx);
@@ -1332,54 +1698,39 @@ Value Interpreter::evaluateIndex(IndexExpr* expr) {
     if (isHashMap(object)) {
         auto map = asHashMap(object);
         
-        // Convert index to string key
-        std::string key;
-        if (isString(index)) {
-            key = asString(index);
-        } else if (isNumber(index)) {
-            // Convert number to string representation
-            double num = asNumber(index);
-            if (num == static_cast<long long>(num)) {
-                key = std::to_string(static_cast<long long>(num));
-            } else {
-                key = std::to_string(num);
-                // Remove trailing zeros after decimal point
-                key.erase(key.find_last_not_of('0') + 1, std::string::npos);
-                key.erase(key.find_last_not_of('.') + 1, std::string::npos);
-            }
-        } else if (isNil(index)) {
-            key = "nil";
-        } else if (isBool(index)) {
-            key = asBool(index) ? "true" : "false";
-        } else {
-            throw RuntimeError(expr->token, "Hash map index must be a string, number, boolean, or nil");
+        // Keys keep their type: a number hashes as a number, no formatting
+        if (!VoltHashMap::isKeyType(index)) {
+            throw RuntimeError(token, "Hash map index must be a string, number, boolean, or nil");
         }
-        
-        return map->get(key);
+        return map->get(index);
     }
     
-    throw RuntimeError(expr->token, "Can only index arrays and hash maps");
+    throw RuntimeError(token, "Can only index arrays and hash maps");
 }
 
 Value Interpreter::evaluateIndexAssign(IndexAssignExpr* expr) {
-    Value object = evaluate(expr->object.get());
-    Value index = evaluate(expr->index.get());
-    Value value = evaluate(expr->value.get());
-    
+    Value object = evaluateExpr(expr->object.get());
+    Value index = evaluateExpr(expr->index.get());
+    Value value = evaluateExpr(expr->value.get());
+    return indexSet(expr->token, object, index, value);
+}
+
+Value Interpreter::indexSet(const Token& token, const Value& object,
+                            const Value& index, const Value& value) {
     // Handle arrays
     if (isArray(object)) {
         auto array = asArray(object);
         
         // Index must be a number
         if (!isNumber(index)) {
-            throw RuntimeError(expr->token, "Array index must be a number");
+            throw RuntimeError(token, "Array index must be a number");
         }
         
         int idx = static_cast<int>(asNumber(index));
         
         // Check bounds
         if (idx < 0 || idx >= array->length()) {
-            throw RuntimeError(expr->token, "Array index out of bounds: " + std::to_string(idx));
+            throw RuntimeError(token, "Array index out of bounds: " + std::to_string(idx));
         }
         
         array->set(idx, value);
@@ -1390,180 +1741,632 @@ Value Interpreter::evaluateIndexAssign(IndexAssignExpr* expr) {
     if (isHashMap(object)) {
         auto map = asHashMap(object);
         
-        // Convert index to string key
-        std::string key;
-        if (isString(index)) {
-            key = asString(index);
-        } else if (isNumber(index)) {
-            // Convert number to string representation
-            if (asNumber(index) == static_cast<long long>(asNumber(index))) {
-                key = std::to_string(static_cast<long long>(asNumber(index)));
-            } else {
-                key = std::to_string(asNumber(index));
-            }
-        } else if (isNil(index)) {
-            key = "nil";
-        } else if (isBool(index)) {
-            key = asBool(index) ? "true" : "false";
-        } else {
-            throw RuntimeError(expr->token, "Hash map index must be a string, number, boolean, or nil");
+        // Same canonical key as reads (see VoltHashMap::keyFor)
+        if (!VoltHashMap::isKeyType(index)) {
+            throw RuntimeError(token, "Hash map index must be a string, number, boolean, or nil");
         }
-        
-        map->set(key, value);
+        map->set(index, value);
         return value;
     }
     
-    throw RuntimeError(expr->token, "Can only index arrays and hash maps");
+    throw RuntimeError(token, "Can only index arrays and hash maps");
 }
 
-Value Interpreter::evaluateMember(MemberExpr* expr) {
-    Value object = evaluate(expr->object.get());
-    
-    // Handle arrays
-    if (isArray(object)) {
-        auto array = asArray(object);
-        
-        // Handle array.length
-        if (expr->member == "length") {
-            return static_cast<double>(array->length());
+// ==================== BUILT-IN METHODS ====================
+
+namespace {
+
+Value arrayPush(Interpreter&, const Value& self, std::span<const Value> args) {
+    asArray(self)->push(args[0]);
+    return nullptr; // returns nil
+}
+
+Value arrayPop(Interpreter&, const Value& self, std::span<const Value>) {
+    return asArray(self)->pop();
+}
+
+Value arrayReverse(Interpreter&, const Value& self, std::span<const Value>) {
+    asArray(self)->reverse();
+    return nullptr;
+}
+
+// Numeric bulk operations (see VoltArray)
+Value arraySum(Interpreter&, const Value& self, std::span<const Value>) {
+    return asArray(self)->sum();
+}
+
+Value arrayMin(Interpreter&, const Value& self, std::span<const Value>) {
+    return asArray(self)->min();
+}
+
+Value arrayMax(Interpreter&, const Value& self, std::span<const Value>) {
+    return asArray(self)->max();
+}
+
+const VoltArray& arrayArgument(const Value& arg, const char* method) {
+    if (!isArray(arg)) {
+        throw std::runtime_error(std::string(method) + "() expects an array");
+    }
+    return *static_cast<VoltArray*>(arg.object());
+}
+
+Value arrayDot(Interpreter&, const Value& self, std::span<const Value> args) {
+    return asArray(self)->dot(arrayArgument(args[0], "dot"));
+}
+
+Value arrayScale(Interpreter&, const Value& self, std::span<const Value> args) {
+    if (!isNumber(args[0])) {
+        throw std::runtime_error("scale() expects a number");
+    }
+    return asArray(self)->scale(asNumber(args[0]));
+}
+
+Value arrayAdd(Interpreter&, const Value& self, std::span<const Value> args) {
+    return asArray(self)->add(arrayArgument(args[0], "add"));
+}
+
+// A position argument of slice/splice/insert: an integer, counted from
+// the end when negative, clamped to [0, length]
+size_t arrayPosition(const Value& arg, size_t length, const char* method) {
+    if (!isNumber(arg) || std::floor(asNumber(arg)) != asNumber(arg)) {
+        throw std::runtime_error(std::string(method) + "() expects an integer index");
+    }
+    double position = asNumber(arg);
+    if (position < 0) position += static_cast<double>(length);
+    return static_cast<size_t>(std::clamp(position, 0.0, static_cast<double>(length)));
+}
+
+Value arraySlice(Interpreter&, const Value& self, std::span<const Value> args) {
+    auto array = asArray(self);
+    size_t start = arrayPosition(args[0], array->length(), "slice");
+    size_t end = arrayPosition(args[1], array->length(), "slice");
+    return array->slice(start, end);
+}
+
+Value arrayConcat(Interpreter&, const Value& self, std::span<const Value> args) {
+    return asArray(self)->concat(arrayArgument(args[0], "concat"));
+}
+
+Value arrayIndexOf(Interpreter&, const Value& self, std::span<const Value> args) {
+    return static_cast<double>(asArray(self)->indexOf(args[0]));
+}
+
+Value arrayIncludes(Interpreter&, const Value& self, std::span<const Value> args) {
+    return asArray(self)->indexOf(args[0]) >= 0;
+}
+
+Value arrayJoin(Interpreter&, const Value& self, std::span<const Value> args) {
+    if (!isString(args[0])) {
+        throw std::runtime_error("join() expects a string separator");
+    }
+    return asArray(self)->join(asString(args[0]));
+}
+
+// array.splice(start, count): removes and returns up to 'count' elements
+Value arraySplice(Interpreter&, const Value& self, std::span<const Value> args) {
+    auto array = asArray(self);
+    size_t start = arrayPosition(args[0], array->length(), "splice");
+    if (!isNumber(args[1]) || asNumber(args[1]) < 0 ||
+        std::floor(asNumber(args[1])) != asNumber(args[1])) {
+        throw std::runtime_error("splice() expects a non-negative integer count");
+    }
+    size_t available = array->length() - start;
+    size_t count = asNumber(args[1]) < static_cast<double>(available)
+        ? static_cast<size_t>(asNumber(args[1])) : available;
+    return array->splice(start, count);
+}
+
+Value arrayInsert(Interpreter&, const Value& self, std::span<const Value> args) {
+    auto array = asArray(self);
+    array->insert(arrayPosition(args[0], array->length(), "insert"), args[1]);
+    return nullptr;
+}
+
+Value arrayFill(Interpreter&, const Value& self, std::span<const Value> args) {
+    asArray(self)->fill(args[0]);
+    return self;
+}
+
+// Higher-order methods. The callback is a script function (or native)
+// taking the element, or the element and its index. Its arguments live in
+// one small buffer reused for every element, and the array is re-read by
+// index after each call, since the callback may push to or pop from it
+// (elements added during the walk are not visited).
+class ElementCallback {
+public:
+    ElementCallback(Interpreter& interpreter, const Value& function, const char* method,
+                    int leading = 0)
+        : interpreter_(interpreter), leading_(leading) {
+        if (!isCallable(function)) {
+            throw std::runtime_error(std::string(method) + "() expects a function");
         }
-        
-        // Handle array.push - return a callable
-        if (expr->member == "push") {
-            return std::make_shared<NativeFunction>(
-                1,
-                [array](const std::vector<Value>& args) -> Value {
-                    array->push(args[0]);
-                    return nullptr; // returns nil
-                },
-                "push"
-            );
+        function_ = asCallable(function);
+        arity_ = function_->arity();
+        if (arity_ != leading + 1 && arity_ != leading + 2) {
+            throw std::runtime_error(std::string(method) + "() callback must take " +
+                                     std::to_string(leading + 1) + " or " +
+                                     std::to_string(leading + 2) + " arguments");
         }
-        
-        // Handle array.pop
-        if (expr->member == "pop") {
-            return std::make_shared<NativeFunction>(
-                0,
-                [array](const std::vector<Value>&) -> Value {
-                    return array->pop();
-                },
-                "pop"
-            );
+    }
+    
+    // For reduce: the accumulator passed in front of the element
+    Value& leading() { return arguments_[0]; }
+    
+    Value operator()(const Value& element, size_t index) {
+        arguments_[leading_] = element;
+        if (arity_ > leading_ + 1) arguments_[leading_ + 1] = static_cast<double>(index);
+        return function_->call(interpreter_, std::span<const Value>(arguments_, arity_));
+    }
+    
+private:
+    Interpreter& interpreter_;
+    Ref<Callable> function_;  // Owned: the method's argument span may not outlive a callback
+    int leading_;
+    int arity_ = 0;
+    Value arguments_[3];
+};
+
+// Calls fn(element, index) for each element present when the walk
+// started, until fn returns true
+template <typename Fn>
+void eachElement(const Value& self, Fn&& fn) {
+    Ref<VoltArray> array = asArray(self);
+    const size_t length = array->length();
+    for (size_t i = 0; i < length && i < array->length(); i++) {
+        Value element = array->elements()[i];
+        if (fn(element, i)) return;
+    }
+}
+
+Value arrayMap(Interpreter& interpreter, const Value& self, std::span<const Value> args) {
+    ElementCallback callback(interpreter, args[0], "map");
+    std::vector<Value> result;
+    result.reserve(asArray(self)->length());
+    eachElement(self, [&](const Value& element, size_t i) {
+        result.push_back(callback(element, i));
+        return false;
+    });
+    return makeRef<VoltArray>(std::move(result));
+}
+
+Value arrayFilter(Interpreter& interpreter, const Value& self, std::span<const Value> args) {
+    ElementCallback callback(interpreter, args[0], "filter");
+    std::vector<Value> result;
+    result.reserve(asArray(self)->length());
+    eachElement(self, [&](const Value& element, size_t i) {
+        if (isTruthy(callback(element, i))) result.push_back(element);
+        return false;
+    });
+    return makeRef<VoltArray>(std::move(result));
+}
+
+// array.reduce(fn, initial) with fn(accumulator, element[, index])
+Value arrayReduce(Interpreter& interpreter, const Value& self, std::span<const Value> args) {
+    ElementCallback callback(interpreter, args[0], "reduce", 1);
+    callback.leading() = args[1];
+    eachElement(self, [&](const Value& element, size_t i) {
+        callback.leading() = callback(element, i);
+        return false;
+    });
+    return std::move(callback.leading());
+}
+
+Value arrayForEach(Interpreter& interpreter, const Value& self, std::span<const Value> args) {
+    ElementCallback callback(interpreter, args[0], "forEach");
+    eachElement(self, [&](const Value& element, size_t i) {
+        callback(element, i);
+        return false;
+    });
+    return nullptr;
+}
+
+// First element the callback accepts, or nil
+Value arrayFind(Interpreter& interpreter, const Value& self, std::span<const Value> args) {
+    ElementCallback callback(interpreter, args[0], "find");
+    Value found;
+    eachElement(self, [&](const Value& element, size_t i) {
+        if (!isTruthy(callback(element, i))) return false;
+        found = element;
+        return true;
+    });
+    return found;
+}
+
+// Index of the first element the callback accepts, or -1
+Value arrayFindIndex(Interpreter& interpreter, const Value& self, std::span<const Value> args) {
+    ElementCallback callback(interpreter, args[0], "findIndex");
+    double found = -1;
+    eachElement(self, [&](const Value& element, size_t i) {
+        if (!isTruthy(callback(element, i))) return false;
+        found = static_cast<double>(i);
+        return true;
+    });
+    return found;
+}
+
+Value arraySome(Interpreter& interpreter, const Value& self, std::span<const Value> args) {
+    ElementCallback callback(interpreter, args[0], "some");
+    bool any = false;
+    eachElement(self, [&](const Value& element, size_t i) {
+        any = isTruthy(callback(element, i));
+        return any;
+    });
+    return any;
+}
+
+Value arrayEvery(Interpreter& interpreter, const Value& self, std::span<const Value> args) {
+    ElementCallback callback(interpreter, args[0], "every");
+    bool all = true;
+    eachElement(self, [&](const Value& element, size_t i) {
+        all = isTruthy(callback(element, i));
+        return !all;
+    });
+    return all;
+}
+
+// Sorting. Numbers and strings sort natively; sort(cmp) and sortBy(key)
+// sort a copy (the callbacks may look at or change the array meanwhile)
+// with a stable merge sort, then store it back. All three are stable.
+
+// Bottom-up merge sort that stays in bounds even when 'less' is not a
+// strict weak ordering: a script comparator can return anything, and
+// std::sort/std::stable_sort may run off the end when it does
+template <typename Less>
+void mergeSort(std::vector<Value>& values, Less less) {
+    constexpr size_t kRun = 8;  // Insertion-sorted before merging
+    const size_t n = values.size();
+    for (size_t start = 0; start < n; start += kRun) {
+        size_t end = std::min(start + kRun, n);
+        for (size_t i = start + 1; i < end; i++) {
+            for (size_t j = i; j > start && less(values[j], values[j - 1]); j--) {
+                std::swap(values[j], values[j - 1]);
+            }
         }
-        
-        // Handle array.reverse
-        if (expr->member == "reverse") {
-            return std::make_shared<NativeFunction>(
-                0,
-                [array](const std::vector<Value>&) -> Value {
-                    array->reverse();
-                    return nullptr;
-                },
-                "reverse"
-            );
+    }
+    std::vector<Value> merged(n);
+    for (size_t width = kRun; width < n; width *= 2) {
+        for (size_t low = 0; low < n; low += 2 * width) {
+            size_t mid = std::min(low + width, n);
+            size_t high = std::min(low + 2 * width, n);
+            size_t i = low, j = mid, k = low;
+            while (i < mid && j < high) {
+                // Ties take the left run, which keeps equal elements in order
+                merged[k++] = less(values[j], values[i]) ? std::move(values[j++]) : std::move(values[i++]);
+            }
+            while (i < mid) merged[k++] = std::move(values[i++]);
+            while (j < high) merged[k++] = std::move(values[j++]);
         }
-        
-        throw RuntimeError(expr->token, "Unknown array member: " + expr->member);
+        values.swap(merged);
     }
+}
+
+Value arraySort(Interpreter&, const Value& self, std::span<const Value>) {
+    if (!asArray(self)->sortNatural()) {
+        throw std::runtime_error("sort() without a comparator needs all numbers or all strings");
+    }
+    return self;
+}
+
+// array.sort(cmp): cmp(a, b) returns a negative number when a goes first
+Value arraySortWith(Interpreter& interpreter, const Value& self, std::span<const Value> args) {
+    if (!isCallable(args[0]) || asCallable(args[0])->arity() != 2) {
+        throw std::runtime_error("sort() expects a comparator taking 2 arguments");
+    }
+    Ref<Callable> comparator = asCallable(args[0]);
+    auto array = asArray(self);
+    std::vector<Value> sorted = array->elements();
+    Value pair[2];
+    mergeSort(sorted, [&](const Value& a, const Value& b) {
+        pair[0] = a;
+        pair[1] = b;
+        Value order = comparator->call(interpreter, pair);
+        if (!isNumber(order)) throw std::runtime_error("sort() comparator must return a number");
+        return asNumber(order) < 0;
+    });
+    array->assign(std::move(sorted));
+    return self;
+}
+
+// array.sortBy(key): orders by key(element), computed once per element;
+// keys must be all numbers or all strings
+Value arraySortBy(Interpreter& interpreter, const Value& self, std::span<const Value> args) {
+    ElementCallback key(interpreter, args[0], "sortBy");
+    auto array = asArray(self);
+    std::vector<std::pair<Value, Value>> decorated;
+    decorated.reserve(array->length());
+    bool numbers = true;
+    bool strings = true;
+    eachElement(self, [&](const Value& element, size_t i) {
+        decorated.emplace_back(key(element, i), element);
+        numbers = numbers && isNumber(decorated.back().first);
+        strings = strings && isString(decorated.back().first);
+        return false;
+    });
+    if (numbers) {
+        // NaN keys go last, as in sort()
+        std::stable_sort(decorated.begin(), decorated.end(), [](const auto& a, const auto& b) {
+            double x = asNumber(a.first), y = asNumber(b.first);
+            return x < y || (!std::isnan(x) && std::isnan(y));
+        });
+    } else if (strings) {
+        std::stable_sort(decorated.begin(), decorated.end(), [](const auto& a, const auto& b) {
+            return asString(a.first) < asString(b.first);
+        });
+    } else {
+        throw std::runtime_error("sortBy() keys must be all numbers or all strings");
+    }
+    std::vector<Value> sorted;
+    sorted.reserve(decorated.size());
+    for (auto& [_, element] : decorated) sorted.push_back(std::move(element));
+    array->assign(std::move(sorted));
+    return self;
+}
+
+Value mapKeys(Interpreter&, const Value& self, std::span<const Value>) {
+    auto keysVec = asHashMap(self)->getKeys();
     
-    // Handle hash maps
+    // Create an array with the keys
+    auto resultArray = makeRef<VoltArray>();
+    for (const auto& key : keysVec) {
+        resultArray->push(key);
+    }
+    
+    return resultArray;
+}
+
+Value mapValues(Interpreter&, const Value& self, std::span<const Value>) {
+    auto valuesVec = asHashMap(self)->getValues();
+    
+    // Create an array with the values
+    auto resultArray = makeRef<VoltArray>();
+    for (const auto& value : valuesVec) {
+        resultArray->push(value);
+    }
+    
+    return resultArray;
+}
+
+Value mapHas(Interpreter&, const Value& self, std::span<const Value> args) {
+    return asHashMap(self)->contains(args[0]);
+}
+
+Value mapRemove(Interpreter&, const Value& self, std::span<const Value> args) {
+    return asHashMap(self)->remove(args[0]);  // Returns true if removed, false if not found
+}
+
+struct BuiltinMethod {
+    int arity;
+    NativeFunction::MethodFn function;
+    const char* name;  // Shown when the method is printed
+    const BuiltinMethod* overload = nullptr;  // Same name, another arity
+};
+
+// The callable methods of a value, or nullptr (properties like length
+// aren't methods)
+const BuiltinMethod* findMethod(const Value& object, MethodId method) {
+    static const BuiltinMethod push{1, arrayPush, "push"};
+    static const BuiltinMethod pop{0, arrayPop, "pop"};
+    static const BuiltinMethod reverse{0, arrayReverse, "reverse"};
+    static const BuiltinMethod sum{0, arraySum, "sum"};
+    static const BuiltinMethod min{0, arrayMin, "min"};
+    static const BuiltinMethod max{0, arrayMax, "max"};
+    static const BuiltinMethod dot{1, arrayDot, "dot"};
+    static const BuiltinMethod scale{1, arrayScale, "scale"};
+    static const BuiltinMethod add{1, arrayAdd, "add"};
+    static const BuiltinMethod slice{2, arraySlice, "slice"};
+    static const BuiltinMethod concat{1, arrayConcat, "concat"};
+    static const BuiltinMethod indexOf{1, arrayIndexOf, "indexOf"};
+    static const BuiltinMethod includes{1, arrayIncludes, "includes"};
+    static const BuiltinMethod join{1, arrayJoin, "join"};
+    static const BuiltinMethod splice{2, arraySplice, "splice"};
+    static const BuiltinMethod insert{2, arrayInsert, "insert"};
+    static const BuiltinMethod fill{1, arrayFill, "fill"};
+    static const BuiltinMethod sortWith{1, arraySortWith, "sort"};
+    static const BuiltinMethod sort{0, arraySort, "sort", &sortWith};
+    static const BuiltinMethod sortBy{1, arraySortBy, "sortBy"};
+    static const BuiltinMethod map{1, arrayMap, "map"};
+    static const BuiltinMethod filter{1, arrayFilter, "filter"};
+    static const BuiltinMethod reduce{2, arrayReduce, "reduce"};
+    static const BuiltinMethod forEach{1, arrayForEach, "forEach"};
+    static const BuiltinMethod find{1, arrayFind, "find"};
+    static const BuiltinMethod findIndex{1, arrayFindIndex, "findIndex"};
+    static const BuiltinMethod some{1, arraySome, "some"};
+    static const BuiltinMethod every{1, arrayEvery, "every"};
+    static const BuiltinMethod keys{0, mapKeys, "hashmap.keys"};
+    static const BuiltinMethod values{0, mapValues, "hashmap.values"};
+    static const BuiltinMethod has{1, mapHas, "hashmap.has"};
+    static const BuiltinMethod remove{1, mapRemove, "hashmap.remove"};
+    
+    if (isArray(object)) {
+        switch (method) {
+            case MethodId::Push: return &push;
+            case MethodId::Pop: return &pop;
+            case MethodId::Reverse: return &reverse;
+            case MethodId::Sum: return &sum;
+            case MethodId::Min: return &min;
+            case MethodId::Max: return &max;
+            case MethodId::Dot: return &dot;
+            case MethodId::Scale: return &scale;
+            case MethodId::Add: return &add;
+            case MethodId::Slice: return &slice;
+            case MethodId::Concat: return &concat;
+            case MethodId::IndexOf: return &indexOf;
+            case MethodId::Includes: return &includes;
+            case MethodId::Join: return &join;
+            case MethodId::Splice: return &splice;
+            case MethodId::Insert: return &insert;
+            case MethodId::Fill: return &fill;
+            case MethodId::Sort: return &sort;
+            case MethodId::SortBy: return &sortBy;
+            case MethodId::Map: return &map;
+            case MethodId::Filter: return &filter;
+            case MethodId::Reduce: return &reduce;
+            case MethodId::ForEach: return &forEach;
+            case MethodId::Find: return &find;
+            case MethodId::FindIndex: return &findIndex;
+            case MethodId::Some: return &some;
+            case MethodId::Every: return &every;
+            default: return nullptr;
+        }
+    }
     if (isHashMap(object)) {
-        auto map = asHashMap(object);
-        
-        // Handle hash map properties/methods
-        if (expr->member == "size") {
-            return static_cast<double>(map->size());
+        switch (method) {
+            case MethodId::Keys: return &keys;
+            case MethodId::Values: return &values;
+            case MethodId::Has: return &has;
+            case MethodId::Remove: return &remove;
+            default: return nullptr;
         }
-        
-        if (expr->member == "keys") {
-            return std::make_shared<NativeFunction>(
-                0,
-                [map](const std::vector<Value>&) -> Value {
-                    auto keysVec = map->getKeys();
-                    
-                    // Create an array with the keys
-                    auto resultArray = std::make_shared<VoltArray>();
-                    for (const auto& key : keysVec) {
-                        resultArray->push(key);
-                    }
-                    
-                    return resultArray;
-                },
-                "hashmap.keys"
-            );
+    }
+    return nullptr;
+}
+
+} // anonymous namespace
+
+Value Interpreter::evaluateMember(MemberExpr* expr) {
+    Value object = evaluateExpr(expr->object.get());
+    return memberGet(expr->token, object, expr->method, expr->member, expr->cache);
+}
+
+Value Interpreter::evaluateMemberAssign(MemberAssignExpr* expr) {
+    Value object = evaluateExpr(expr->object.get());
+    Value value = evaluateExpr(expr->value.get());
+    return memberSet(expr->token, object, expr->method, expr->member, value, expr->cache);
+}
+
+Value Interpreter::evaluateMethodCall(MethodCallExpr* expr) {
+    Value object = evaluateExpr(expr->object.get());
+    
+    // Same stack buffer as evaluateCall
+    size_t argCount = expr->arguments.size();
+    if (argCount > kInlineArgs) {
+        std::vector<Value> arguments;
+        arguments.reserve(argCount);
+        for (const auto& arg : expr->arguments) {
+            arguments.push_back(evaluateExpr(arg.get()));
         }
-        
-        if (expr->member == "values") {
-            return std::make_shared<NativeFunction>(
-                0,
-                [map](const std::vector<Value>&) -> Value {
-                    auto valuesVec = map->getValues();
-                    
-                    // Create an array with the values
-                    auto resultArray = std::make_shared<VoltArray>();
-                    for (const auto& value : valuesVec) {
-                        resultArray->push(value);
-                    }
-                    
-                    return resultArray;
-                },
-                "hashmap.values"
-            );
+        return callMethod(expr->token, object, expr->method, expr->member, arguments, expr->cache);
+    }
+    
+    Value arguments[kInlineArgs];
+    for (size_t i = 0; i < argCount; i++) {
+        arguments[i] = evaluateExpr(expr->arguments[i].get());
+    }
+    return callMethod(expr->token, object, expr->method, expr->member,
+                      std::span<const Value>(arguments, argCount), expr->cache);
+}
+
+Value Interpreter::callMethod(const Token& token, const Value& object, MethodId method,
+                              const std::string& member, std::span<const Value> arguments,
+                              FieldCache& cache) {
+    // Built-in methods run directly on the receiver
+    for (auto* builtin = findMethod(object, method); builtin; builtin = builtin->overload) {
+        if (static_cast<int>(arguments.size()) == builtin->arity) {
+            return builtin->function(*this, object, arguments);
         }
-        
-        if (expr->member == "has") {  // NEW!
-            return std::make_shared<NativeFunction>(
-                1,
-                [map](const std::vector<Value>& args) -> Value {
-                    // Convert key to string
-                    std::string keyStr = valueToString(args[0]);
-                    return map->contains(keyStr);
-                },
-                "hashmap.has"
-            );
+    }
+    
+    // Anything else behaves like reading the member and calling it,
+    // which also reports the usual errors
+    return callValue(token, memberGet(token, object, method, member, cache), arguments);
+}
+
+Value Interpreter::memberGet(const Token& token, const Value& object, MethodId method,
+                             const std::string& member, FieldCache& cache) {
+    // Record fields: names that aren't built-in members of anything
+    if (method == MethodId::None && isHashMap(object)) {
+        return static_cast<VoltHashMap*>(object.object())->getField(cache, member);
+    }
+    
+    // Methods used as values: a callable bound to the receiver (the
+    // first overload)
+    if (const BuiltinMethod* builtin = findMethod(object, method)) {
+        return makeRef<NativeFunction>(builtin->arity, builtin->function, object, builtin->name);
+    }
+    
+    // Handle arrays
+    if (isArray(object)) {
+        // Handle array.length
+        if (method == MethodId::Length) {
+            return static_cast<double>(asArray(object)->length());
         }
         
-        if (expr->member == "remove") {  // NEW!
-            return std::make_shared<NativeFunction>(
-                1,
-                [map](const std::vector<Value>& args) -> Value {
-                    // Convert key to string
-                    std::string keyStr = valueToString(args[0]);
-                    return map->remove(keyStr);  // Returns true if removed, false if not found
-                },
-                "hashmap.remove"
-            );
+        throw RuntimeError(token, "Unknown array member: " + member);
+    }
+    
+    // Handle hash maps
+    if (isHashMap(object)) {
+        // Handle hash map properties
+        auto* map = static_cast<VoltHashMap*>(object.object());
+        if (method == MethodId::Size) {
+            return static_cast<double>(map->size());
         }
         
-        throw RuntimeError(expr->token, "Unknown hash map member: " + expr->member);
+        // Any other name is a field: record.name is record["name"]
+        return map->getField(cache, member);
+    }
+    
+    throw RuntimeError(token, "Only arrays and hash maps have members");
+}
+
+Value Interpreter::memberSet(const Token& token, const Value& object, MethodId method,
+                             const std::string& member, const Value& value, FieldCache& cache) {
+    if (!isHashMap(object)) {
+        throw RuntimeError(token, "Only hash maps have fields");
+    }
+    
+    // Built-in members keep their meaning; map["size"] still sets the key
+    if (method == MethodId::Size || findMethod(object, method)) {
+        throw RuntimeError(token, "Cannot assign to built-in hash map member: " + member);
     }
     
-    throw RuntimeError(expr->token, "Only arrays and hash maps have members");
+    static_cast<VoltHashMap*>(object.object())->setField(cache, member, value);
+    return value;
 }
 
 // Evaluate hash map literal expression  // NEW!
 Value Interpreter::evaluateHashMap(HashMapExpr* expr) {
-    auto hashMap = std::make_shared<VoltHashMap>();
+    auto hashMap = makeRef<VoltHashMap>();
+    
+    // All-literal maps were built once by the Optimizer
+    if (isHashMap(expr->constant)) {
+        hashMap->data = asHashMap(expr->constant)->data;
+        return hashMap;
+    }
+    
+    // Literal keys give the same layout every time: take the shape the
+    // first evaluation built and only fill in the values
+    if (expr->layout) {
+        std::vector<Value> values;
+        values.reserve(expr->keyValuePairs.size());
+        for (const auto& pair : expr->keyValuePairs) {
+            values.push_back(evaluateExpr(pair.second.get()));
+        }
+        hashMap->data.assign(expr->layout, std::move(values));
+        return hashMap;
+    }
     
+    bool literalKeys = true;
     for (const auto& [keyExpr, valueExpr] : expr->keyValuePairs) {
-        Value key = evaluate(keyExpr.get());
-        Value value = evaluate(valueExpr.get());
-        
-        // Convert key to string representation (for storage in hash map)
-        std::string keyStr = valueToString(key);  // Use the same string representation as valueToString
+        Value key = evaluateExpr(keyExpr.get());
+        Value value = evaluateExpr(valueExpr.get());
+        literalKeys = literalKeys && keyExpr->kind == ExprKind::Literal;
         
-        hashMap->set(keyStr, value);
+        // Same canonical key as map[key] = value
+        hashMap->set(key, value);
     }
     
+    if (literalKeys) expr->layout = hashMap->layoutFor(expr->keyValuePairs.size());
+    
     return hashMap;
 }
 
-void Interpreter::executeBreakStmt(BreakStmt*) {
-    throw BreakException();
+Completion Interpreter::executeBreakStmt(BreakStmt*) {
+    return Completion::Break;
 }
 
-void Interpreter::executeContinueStmt(ContinueStmt*) {
-    throw ContinueException();
+Completion Interpreter::executeContinueStmt(ContinueStmt*) {
+    return Completion::Continue;
 }
 
 void Interpreter::checkNumberOperand(const Token& op, const Value& operand) {
@@ -5,6 +5,7 @@
 #include "value.h"
 #include "environment.h"
 #include <memory>
+#include <span>
 #include <vector>
 #include <string>
 #include <exception>
@@ -12,28 +13,27 @@
 
 namespace volt {
 
-/**
- * ReturnValue - Special exception for implementing return statements
- * 
- * When you hit a 'return' in VoltScript, we throw this to unwind
- * the call stack back to where the function was called.
- * It's cleaner than checking every statement for "did we return yet?"
- */
-class ReturnValue : public std::exception {
-public:
-    Value value;
-    explicit ReturnValue(Value val) : value(val) {}
-};
+class VM;
+class VoltFunction;
 
 /**
- * BreakException - Exception thrown when break statement is executed
+ * Engine - Which execution engine runs a program
+ * 
+ * Ast walks the syntax tree directly (the original interpreter).
+ * Vm compiles the statements to bytecode first and runs them on the
+ * stack-based virtual machine in src/vm.
  */
-class BreakException : public std::exception {};
+enum class Engine { Ast, Vm };
 
 /**
- * ContinueException - Exception thrown when continue statement is executed
+ * Completion - How a statement finished executing
+ * 
+ * execute() hands this back up through blocks, loops and function calls
+ * instead of throwing, so 'return', 'break' and 'continue' cost an
+ * ordinary return. The value of a Return completion is parked in the
+ * interpreter until VoltFunction::call picks it up.
  */
-class ContinueException : public std::exception {};
+enum class Completion : uint8_t { Normal, Return, Break, Continue };
 
 /**
  * Interpreter - Executes statements and evaluates expressions
@@ -44,17 +44,47 @@ class ContinueException : public std::exception {};
 class Interpreter {
 public:
     Interpreter();
+    explicit Interpreter(Engine engine);
+    ~Interpreter();
+    
+    // Engine selection (defaults to $VOLT_ENGINE, or Ast when unset)
+    static Engine defaultEngine();
+    void setEngine(Engine engine) { engine_ = engine; }
+    Engine getEngine() const { return engine_; }
+    
+    // The bytecode VM backing Engine::Vm (created on first use)
+    VM& vm();
     
     // Execute statements
-    void execute(Stmt* stmt);
+    // The vector overload resolves variables first; execute(Stmt*) expects
+    // statements that have already been through the Resolver
+    Completion execute(Stmt* stmt);
     void execute(const std::vector<StmtPtr>& statements);
     
     // Execute a block with a specific environment
     // This is public so VoltFunction can call it
-    void executeBlock(const std::vector<StmtPtr>& statements,
-                      std::shared_ptr<Environment> environment);
+    Completion executeBlock(const std::vector<StmtPtr>& statements,
+                            std::shared_ptr<Environment> environment);
     
-    // Evaluate expressions
+    // Block, loop and call scopes come from a free list: a scope that no
+    // closure kept when it was released is cleared and handed out again
+    // instead of being freed, so calls that create no closures allocate
+    // nothing. Release only scopes from acquireScope.
+    std::shared_ptr<Environment> acquireScope(std::shared_ptr<Environment> enclosing,
+                                              const ScopeLayout& layout);
+    void releaseScope(std::shared_ptr<Environment>& scope);
+    size_t pooledScopeCount() const { return scopePool_.size(); }  // For tests
+    
+    // Value of the last Return completion (moved out)
+    Value takeReturnValue() { return std::move(returnValue_); }
+    
+    // A Return completion from 'return f(...)' with f a VoltFunction parks
+    // the call here instead of making it; VoltFunction::call runs it in
+    // place of the current call. Null when the return carried a value.
+    Ref<VoltFunction> takeTailCall() { return std::move(tailCall_); }
+    std::vector<Value>& tailCallArguments() { return tailCallArguments_; }
+    
+    // Evaluate a standalone expression (resolved against the globals)
     Value evaluate(Expr* expr);
     
     // Get current environment
@@ -64,21 +94,28 @@ public:
     void reset();
     
 private:
+    // Calls with up to this many arguments evaluate them on the C++ stack
+    static constexpr size_t kInlineArgs = 8;
+    
     // Statement execution
     void executeExprStmt(ExprStmt* stmt);
     void executePrintStmt(PrintStmt* stmt);
     void executeLetStmt(LetStmt* stmt);
-    void executeBlockStmt(BlockStmt* stmt);
-    void executeIfStmt(IfStmt* stmt);
-    void executeWhileStmt(WhileStmt* stmt);
-    void executeRunUntilStmt(RunUntilStmt* stmt);
-    void executeForStmt(ForStmt* stmt);
+    Completion executeBlockStmt(BlockStmt* stmt);
+    Completion executeIfStmt(IfStmt* stmt);
+    Completion executeWhileStmt(WhileStmt* stmt);
+    Completion executeRunUntilStmt(RunUntilStmt* stmt);
+    Completion executeForStmt(ForStmt* stmt);
+    Completion executeCountedLoop(ForStmt* stmt, Environment& loopEnv);
+    Completion executeLoopBody(Stmt* body, std::shared_ptr<Environment>& scope);
     void executeFnStmt(FnStmt* stmt);
-    void executeReturnStmt(ReturnStmt* stmt);
-    void executeBreakStmt(BreakStmt* stmt);
-    void executeContinueStmt(ContinueStmt* stmt);
+    Completion executeReturnStmt(ReturnStmt* stmt);
+    Completion executeTailCall(CallExpr* expr);
+    Completion executeBreakStmt(BreakStmt* stmt);
+    Completion executeContinueStmt(ContinueStmt* stmt);
     
     // Expression evaluation
+    Value evaluateExpr(Expr* expr);
     Value evaluateLiteral(LiteralExpr* expr);
     Value evaluateVariable(VariableExpr* expr);
     Value evaluateUnary(UnaryExpr* expr);
@@ -90,19 +127,40 @@ private:
     Value evaluateCompoundAssign(CompoundAssignExpr* expr);
     Value evaluateUpdate(UpdateExpr* expr);
     Value evaluateTernary(TernaryExpr* expr);
+    Value readVariable(Binding& binding, const std::string& name, const Token& token);
+    void writeVariable(Binding& binding, const std::string& name, const Token& token, Value value);
     
     // ARRAY EVALUATION - NEW!
     Value evaluateArray(ArrayExpr* expr);
     Value evaluateIndex(IndexExpr* expr);
     Value evaluateIndexAssign(IndexAssignExpr* expr);
+    Value evaluateMemberAssign(MemberAssignExpr* expr);
     Value evaluateMember(MemberExpr* expr);
+    Value evaluateMethodCall(MethodCallExpr* expr);
     
     // HASH MAP EVALUATION - NEW!
     Value evaluateHashMap(HashMapExpr* expr);
     
+    // Runtime operations shared by both engines
+    // (the VM calls these so the two engines behave identically)
+    static Value unaryOp(const Token& op, const Value& right);
+    static Value binaryOp(const Token& op, const Value& left, const Value& right);
+    Value compoundOp(const Token& op, const Value& current, const Value& operand);
+    Value indexGet(const Token& token, const Value& object, const Value& index);
+    Value indexSet(const Token& token, const Value& object, const Value& index, const Value& value);
+    // Member sites pass their own FieldCache (hash map fields)
+    Value memberGet(const Token& token, const Value& object, MethodId method,
+                    const std::string& member, FieldCache& cache);
+    Value memberSet(const Token& token, const Value& object, MethodId method,
+                    const std::string& member, const Value& value, FieldCache& cache);
+    Value callMethod(const Token& token, const Value& object, MethodId method,
+                     const std::string& member, std::span<const Value> arguments, FieldCache& cache);
+    // The arguments are only valid for the duration of the call
+    Value callValue(const Token& token, const Value& callee, std::span<const Value> arguments);
+    
     // Helper methods
-    void checkNumberOperand(const Token& op, const Value& operand);
-    void checkNumberOperands(const Token& op, const Value& left, const Value& right);
+    static void checkNumberOperand(const Token& op, const Value& operand);
+    static void checkNumberOperands(const Token& op, const Value& left, const Value& right);
     
     // Register built-in functions (like clock(), input(), etc.)
     void defineNatives();
@@ -114,6 +172,20 @@ private:
     
     std::shared_ptr<Environment> environment_;
     std::shared_ptr<Environment> globals_;
+    Value returnValue_;  // Set by 'return', read by VoltFunction::call
+    Ref<VoltFunction> tailCall_;            // Set by 'return f(...)'
+    std::vector<Value> tailCallArguments_;  // Its arguments (capacity is reused)
+    
+    static constexpr size_t kScopePoolSize = 256;
+    std::vector<std::shared_ptr<Environment>> scopePool_;  // Retired scopes, see acquireScope
+    const std::vector<Ref<Cell>>* captures_ = nullptr;     // Cells of the running function
+    
+    Engine engine_;
+    std::unique_ptr<VM> vm_;
+    
+    friend class VM;
+    friend class VoltFunction;  // Runs in globals_, points captures_ at itself
+    friend class Optimizer;  // Folds constants with unaryOp/binaryOp
 };
 
 // Runtime error with location info
@@ -0,0 +1,102 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace volt {
+
+/**
+ * Object - Header of every heap value (strings, functions, arrays, maps)
+ *
+ * Values only store a pointer to this header, so the reference count
+ * lives inside the object instead of in a separate shared_ptr control
+ * block. The interpreter is single-threaded, so counting is not atomic.
+ *
+ * Object must be the first (and only polymorphic) base of every heap
+ * type: Value and Ref keep an Object* and cast it back to the concrete
+ * type, which relies on the Object sitting at offset 0. Types that hold
+ * references to other objects derive from GcObject (gc.h), so the cycle
+ * collector can free what counting alone can't.
+ */
+class Object {
+public:
+    Object() = default;
+    Object(const Object&) : refCount_(0) {}
+    Object& operator=(const Object&) { return *this; }
+    virtual ~Object() = default;
+
+    void retain() { ++refCount_; }
+    void release() {
+        if (--refCount_ == 0) delete this;
+    }
+    uint32_t refCount() const { return refCount_; }
+
+    // Objects that can hold references to others are GcObjects, which
+    // the cycle collector traces (see gc.h)
+    bool isTraced() const { return traced_; }
+
+private:
+    friend class Collector;
+
+    uint32_t refCount_ = 0;
+    bool traced_ = false;  // Set once by Collector::track
+};
+
+/**
+ * Ref - Owning pointer to a heap Object (intrusive reference count)
+ *
+ * Plays the role std::shared_ptr used to: makeRef<VoltArray>() instead of
+ * std::make_shared<VoltArray>(). It works with incomplete types, which is
+ * what lets value.h hand out Ref<VoltArray> without including array.h.
+ */
+template <typename T>
+class Ref {
+public:
+    Ref() = default;
+    Ref(std::nullptr_t) {}
+
+    // Adopts a freshly allocated object or shares an existing one
+    explicit Ref(Object* object) : object_(object) {
+        if (object_) object_->retain();
+    }
+
+    Ref(const Ref& other) : Ref(other.object_) {}
+    Ref(Ref&& other) noexcept : object_(other.object_) { other.object_ = nullptr; }
+
+    // Ref<Derived> -> Ref<Base>
+    template <typename U>
+        requires std::is_convertible_v<U*, T*>
+    Ref(const Ref<U>& other) : Ref(other.object()) {}
+
+    ~Ref() {
+        if (object_) object_->release();
+    }
+
+    Ref& operator=(Ref other) noexcept {
+        std::swap(object_, other.object_);
+        return *this;
+    }
+
+    T* get() const { return reinterpret_cast<T*>(object_); }
+    T* operator->() const { return get(); }
+    T& operator*() const { return *get(); }
+    explicit operator bool() const { return object_ != nullptr; }
+
+    Object* object() const { return object_; }
+
+    bool operator==(const Ref& other) const { return object_ == other.object_; }
+    bool operator!=(const Ref& other) const { return object_ != other.object_; }
+
+private:
+    Object* object_ = nullptr;
+};
+
+// Allocate a heap object: makeRef<VoltArray>(elements)
+template <typename T, typename... Args>
+Ref<T> makeRef(Args&&... args) {
+    T* object = new T(std::forward<Args>(args)...);
+    return Ref<T>(static_cast<Object*>(object));
+}
+
+} // namespace volt
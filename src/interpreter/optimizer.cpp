@@ -0,0 +1,365 @@
+#include "optimizer.h"
+#include "interpreter.h"
+#include "features/array.h"
+#include "features/hashmap.h"
+
+namespace volt {
+
+namespace {
+
+// A literal node holding 'value', or nullptr for non-literal values
+ExprPtr makeLiteral(const Token& token, const Value& value) {
+    if (isNumber(value)) return std::make_unique<LiteralExpr>(token, asNumber(value));
+    if (isString(value)) return std::make_unique<LiteralExpr>(token, asString(value));
+    if (isBool(value)) return std::make_unique<LiteralExpr>(token, asBool(value));
+    if (isNil(value)) return LiteralExpr::nil(token);
+    return nullptr;
+}
+
+bool isTerminator(Stmt* stmt) {
+    return stmt->kind == StmtKind::Return ||
+           stmt->kind == StmtKind::Break ||
+           stmt->kind == StmtKind::Continue;
+}
+
+} // anonymous namespace
+
+// ========================================
+// ENTRY POINTS
+// ========================================
+
+void Optimizer::optimize(std::vector<StmtPtr>& statements) {
+    optimizeStatements(statements);
+}
+
+void Optimizer::optimize(ExprPtr& expr) {
+    optimizeExpr(expr);
+}
+
+void Optimizer::note(const Token& token, const std::string& change) {
+    changes_.push_back("[line " + std::to_string(token.line) + "] " + change);
+}
+
+const Value& Optimizer::literalValue(const ExprPtr& expr) {
+    return static_cast<LiteralExpr*>(expr.get())->value;
+}
+
+// Would removing this statement change which names its scope declares?
+// Mirrors the Resolver: if/while bodies declare into the enclosing scope,
+// blocks, loops and functions have their own.
+bool Optimizer::declaresNames(Stmt* stmt) {
+    if (!stmt) return false;
+    switch (stmt->kind) {
+        case StmtKind::Let:
+        case StmtKind::Fn:
+            return true;
+        case StmtKind::Expr:
+            // A top-level assignment to a new name declares a global
+            return static_cast<ExprStmt*>(stmt)->expr->kind == ExprKind::Assign;
+        case StmtKind::If: {
+            auto* ifStmt = static_cast<IfStmt*>(stmt);
+            return declaresNames(ifStmt->thenBranch.get()) || declaresNames(ifStmt->elseBranch.get());
+        }
+        case StmtKind::While:
+            return declaresNames(static_cast<WhileStmt*>(stmt)->body.get());
+        case StmtKind::RunUntil:
+            return declaresNames(static_cast<RunUntilStmt*>(stmt)->body.get());
+        default:
+            return false;
+    }
+}
+
+// ========================================
+// STATEMENTS
+// ========================================
+
+void Optimizer::optimizeStatements(std::vector<StmtPtr>& statements) {
+    std::vector<StmtPtr> kept;
+    kept.reserve(statements.size());
+    bool reachable = true;
+
+    for (auto& stmt : statements) {
+        if (!reachable) {
+            // Only declarations survive after return/break/continue
+            if (declaresNames(stmt.get())) {
+                kept.push_back(std::move(stmt));
+            } else {
+                note(stmt->token, "removed unreachable statement");
+            }
+            continue;
+        }
+        StmtPtr optimized = optimizeStmt(std::move(stmt));
+        if (!optimized) continue;
+        if (isTerminator(optimized.get())) reachable = false;
+        kept.push_back(std::move(optimized));
+    }
+
+    statements = std::move(kept);
+}
+
+StmtPtr Optimizer::optimizeStmt(StmtPtr stmt) {
+    switch (stmt->kind) {
+        case StmtKind::Expr:
+            optimizeExpr(static_cast<ExprStmt*>(stmt.get())->expr);
+            return stmt;
+        case StmtKind::Print:
+            optimizeExpr(static_cast<PrintStmt*>(stmt.get())->expr);
+            return stmt;
+        case StmtKind::Let: {
+            auto* let = static_cast<LetStmt*>(stmt.get());
+            if (let->initializer) optimizeExpr(let->initializer);
+            return stmt;
+        }
+        case StmtKind::Block:
+            optimizeStatements(static_cast<BlockStmt*>(stmt.get())->statements);
+            return stmt;
+        case StmtKind::If:
+            return optimizeIf(std::unique_ptr<IfStmt>(static_cast<IfStmt*>(stmt.release())));
+        case StmtKind::While: {
+            auto* whileStmt = static_cast<WhileStmt*>(stmt.get());
+            optimizeExpr(whileStmt->condition);
+            if (isLiteral(whileStmt->condition) && !isTruthy(literalValue(whileStmt->condition)) &&
+                !declaresNames(whileStmt->body.get())) {
+                note(whileStmt->token, "removed loop that never runs");
+                return nullptr;
+            }
+            whileStmt->body = optimizeStmt(std::move(whileStmt->body));
+            if (!whileStmt->body) {
+                whileStmt->body = std::make_unique<BlockStmt>(whileStmt->token, std::vector<StmtPtr>{});
+            }
+            return stmt;
+        }
+        case StmtKind::RunUntil: {
+            auto* runUntil = static_cast<RunUntilStmt*>(stmt.get());
+            runUntil->body = optimizeStmt(std::move(runUntil->body));
+            if (!runUntil->body) {
+                runUntil->body = std::make_unique<BlockStmt>(runUntil->token, std::vector<StmtPtr>{});
+            }
+            optimizeExpr(runUntil->condition);
+            return stmt;
+        }
+        case StmtKind::For: {
+            auto* forStmt = static_cast<ForStmt*>(stmt.get());
+            if (forStmt->initializer) forStmt->initializer = optimizeStmt(std::move(forStmt->initializer));
+            if (forStmt->condition) optimizeExpr(forStmt->condition);
+            if (forStmt->increment) optimizeExpr(forStmt->increment);
+            // The initializer runs even if the body never does
+            if (!forStmt->initializer && isLiteral(forStmt->condition) &&
+                !isTruthy(literalValue(forStmt->condition))) {
+                note(forStmt->token, "removed loop that never runs");
+                return nullptr;
+            }
+            forStmt->body = optimizeStmt(std::move(forStmt->body));
+            if (!forStmt->body) {
+                forStmt->body = std::make_unique<BlockStmt>(forStmt->token, std::vector<StmtPtr>{});
+            }
+            return stmt;
+        }
+        case StmtKind::Fn:
+            optimizeStatements(static_cast<FnStmt*>(stmt.get())->body);
+            return stmt;
+        case StmtKind::Return: {
+            auto* ret = static_cast<ReturnStmt*>(stmt.get());
+            if (ret->value) optimizeExpr(ret->value);
+            return stmt;
+        }
+        case StmtKind::Break:
+        case StmtKind::Continue:
+            return stmt;
+    }
+    return stmt;
+}
+
+// if/else branches are not scopes, so a taken branch can replace the
+// whole statement as is
+StmtPtr Optimizer::optimizeIf(std::unique_ptr<IfStmt> stmt) {
+    optimizeExpr(stmt->condition);
+
+    if (isLiteral(stmt->condition)) {
+        bool taken = isTruthy(literalValue(stmt->condition));
+        StmtPtr& live = taken ? stmt->thenBranch : stmt->elseBranch;
+        StmtPtr& dead = taken ? stmt->elseBranch : stmt->thenBranch;
+        if (!declaresNames(dead.get())) {
+            if (!live) {
+                note(stmt->token, "removed if statement whose condition is always false");
+                return nullptr;
+            }
+            note(stmt->token, std::string("if condition is always ") + (taken ? "true" : "false") +
+                              ": kept only the " + (taken ? "then" : "else") + " branch");
+            return optimizeStmt(std::move(live));
+        }
+    }
+
+    stmt->thenBranch = optimizeStmt(std::move(stmt->thenBranch));
+    if (!stmt->thenBranch) {
+        stmt->thenBranch = std::make_unique<BlockStmt>(stmt->token, std::vector<StmtPtr>{});
+    }
+    if (stmt->elseBranch) stmt->elseBranch = optimizeStmt(std::move(stmt->elseBranch));
+    return stmt;
+}
+
+// ========================================
+// EXPRESSIONS
+// ========================================
+
+void Optimizer::optimizeExpr(ExprPtr& expr) {
+    switch (expr->kind) {
+        case ExprKind::Literal:
+        case ExprKind::Variable:
+        case ExprKind::Update:
+            return;
+        case ExprKind::Unary:
+            return foldUnary(expr);
+        case ExprKind::Binary:
+            return foldBinary(expr);
+        case ExprKind::Logical:
+            return foldLogical(expr);
+        case ExprKind::Grouping: {
+            // Parentheses only mattered to the parser
+            ExprPtr inner = std::move(static_cast<GroupingExpr*>(expr.get())->expr);
+            expr = std::move(inner);
+            return optimizeExpr(expr);
+        }
+        case ExprKind::Call: {
+            auto* call = static_cast<CallExpr*>(expr.get());
+            optimizeExpr(call->callee);
+            for (auto& arg : call->arguments) optimizeExpr(arg);
+            return;
+        }
+        case ExprKind::Assign:
+            return optimizeExpr(static_cast<AssignExpr*>(expr.get())->value);
+        case ExprKind::CompoundAssign:
+            return optimizeExpr(static_cast<CompoundAssignExpr*>(expr.get())->value);
+        case ExprKind::Ternary:
+            return foldTernary(expr);
+        case ExprKind::Array: {
+            auto* array = static_cast<ArrayExpr*>(expr.get());
+            for (auto& element : array->elements) optimizeExpr(element);
+            return buildConstantArray(array);
+        }
+        case ExprKind::Index: {
+            auto* index = static_cast<IndexExpr*>(expr.get());
+            optimizeExpr(index->object);
+            optimizeExpr(index->index);
+            return;
+        }
+        case ExprKind::IndexAssign: {
+            auto* indexAssign = static_cast<IndexAssignExpr*>(expr.get());
+            optimizeExpr(indexAssign->object);
+            optimizeExpr(indexAssign->index);
+            optimizeExpr(indexAssign->value);
+            return;
+        }
+        case ExprKind::HashMap: {
+            auto* hashMap = static_cast<HashMapExpr*>(expr.get());
+            for (auto& [key, value] : hashMap->keyValuePairs) {
+                optimizeExpr(key);
+                optimizeExpr(value);
+            }
+            return buildConstantHashMap(hashMap);
+        }
+        case ExprKind::Member:
+            return optimizeExpr(static_cast<MemberExpr*>(expr.get())->object);
+        case ExprKind::MemberAssign: {
+            auto* assign = static_cast<MemberAssignExpr*>(expr.get());
+            optimizeExpr(assign->object);
+            optimizeExpr(assign->value);
+            return;
+        }
+        case ExprKind::MethodCall: {
+            auto* call = static_cast<MethodCallExpr*>(expr.get());
+            optimizeExpr(call->object);
+            for (auto& arg : call->arguments) optimizeExpr(arg);
+            return;
+        }
+    }
+}
+
+void Optimizer::foldUnary(ExprPtr& expr) {
+    auto* unary = static_cast<UnaryExpr*>(expr.get());
+    optimizeExpr(unary->right);
+    if (!isLiteral(unary->right)) return;
+
+    try {
+        Value result = Interpreter::unaryOp(unary->op, literalValue(unary->right));
+        if (ExprPtr literal = makeLiteral(unary->token, result)) {
+            note(unary->token, "folded " + printAST(unary) + " -> " + printAST(literal.get()));
+            expr = std::move(literal);
+        }
+    } catch (const RuntimeError&) {
+        // Leave it to fail at runtime, with the same error
+    }
+}
+
+void Optimizer::foldBinary(ExprPtr& expr) {
+    auto* binary = static_cast<BinaryExpr*>(expr.get());
+    optimizeExpr(binary->left);
+    optimizeExpr(binary->right);
+    if (!isLiteral(binary->left) || !isLiteral(binary->right)) return;
+
+    try {
+        Value result = Interpreter::binaryOp(binary->op, literalValue(binary->left),
+                                             literalValue(binary->right));
+        if (ExprPtr literal = makeLiteral(binary->token, result)) {
+            note(binary->token, "folded " + printAST(binary) + " -> " + printAST(literal.get()));
+            expr = std::move(literal);
+        }
+    } catch (const RuntimeError&) {
+        // Leave it to fail at runtime, with the same error
+    }
+}
+
+// 'and'/'or' evaluate to one of their operands, so a literal left side
+// decides which one
+void Optimizer::foldLogical(ExprPtr& expr) {
+    auto* logical = static_cast<LogicalExpr*>(expr.get());
+    optimizeExpr(logical->left);
+    optimizeExpr(logical->right);
+    if (!isLiteral(logical->left)) return;
+
+    bool truthy = isTruthy(literalValue(logical->left));
+    bool keepLeft = logical->op.type == TokenType::Or ? truthy : !truthy;
+    note(logical->token, "short-circuited " + printAST(logical));
+    ExprPtr result = std::move(keepLeft ? logical->left : logical->right);
+    expr = std::move(result);
+}
+
+void Optimizer::foldTernary(ExprPtr& expr) {
+    auto* ternary = static_cast<TernaryExpr*>(expr.get());
+    optimizeExpr(ternary->condition);
+    optimizeExpr(ternary->thenBranch);
+    optimizeExpr(ternary->elseBranch);
+    if (!isLiteral(ternary->condition)) return;
+
+    bool taken = isTruthy(literalValue(ternary->condition));
+    note(ternary->token, std::string("ternary with literal condition: kept the ") +
+                         (taken ? "then" : "else") + " branch");
+    ExprPtr result = std::move(taken ? ternary->thenBranch : ternary->elseBranch);
+    expr = std::move(result);
+}
+
+// Literal elements are immutable, so sharing them between copies is safe
+void Optimizer::buildConstantArray(ArrayExpr* expr) {
+    if (expr->elements.empty()) return;
+    std::vector<Value> elements;
+    elements.reserve(expr->elements.size());
+    for (const auto& element : expr->elements) {
+        if (!isLiteral(element)) return;
+        elements.push_back(literalValue(element));
+    }
+    expr->constant = makeRef<VoltArray>(std::move(elements));
+    note(expr->token, "prebuilt constant array of " + std::to_string(expr->elements.size()) + " elements");
+}
+
+void Optimizer::buildConstantHashMap(HashMapExpr* expr) {
+    if (expr->keyValuePairs.empty()) return;
+    auto hashMap = makeRef<VoltHashMap>();
+    for (const auto& [key, value] : expr->keyValuePairs) {
+        if (!isLiteral(key) || !isLiteral(value)) return;
+        hashMap->set(literalValue(key), literalValue(value));
+    }
+    expr->constant = hashMap;
+    note(expr->token, "prebuilt constant hash map of " + std::to_string(expr->keyValuePairs.size()) + " entries");
+}
+
+} // namespace volt
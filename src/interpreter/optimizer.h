@@ -0,0 +1,56 @@
+#pragma once
+#include "stmt.h"
+#include "ast.h"
+#include <string>
+#include <vector>
+
+namespace volt {
+
+/**
+ * Optimizer - Simplifies the parsed program before it runs
+ *
+ * Runs after parsing and before the Resolver:
+ * - Folds operators whose operands are literals (1 + 2, "a" + "b", -3,
+ *   !true) and picks the branch of a ternary or and/or whose condition is
+ *   a literal. Folding calls the interpreter's own operator code, so the
+ *   result is exactly what the program would have computed; an operation
+ *   that fails (1 / 0, "a" - 1) is left in place to fail at runtime.
+ * - Removes if/while branches whose literal condition never selects them
+ *   and statements after return/break/continue. Dead declarations stay:
+ *   the Resolver still gives them a slot and code may refer to them.
+ * - Builds array and hash map literals made only of literals once, as a
+ *   prototype that each evaluation copies.
+ */
+class Optimizer {
+public:
+    void optimize(std::vector<StmtPtr>& statements);
+    void optimize(ExprPtr& expr);
+
+    // One line per change, for --dump-optimized
+    const std::vector<std::string>& changes() const { return changes_; }
+
+private:
+    // Statements; a null result removes the statement
+    void optimizeStatements(std::vector<StmtPtr>& statements);
+    StmtPtr optimizeStmt(StmtPtr stmt);
+    StmtPtr optimizeIf(std::unique_ptr<IfStmt> stmt);
+
+    // Expressions, replaced in place
+    void optimizeExpr(ExprPtr& expr);
+    void foldUnary(ExprPtr& expr);
+    void foldBinary(ExprPtr& expr);
+    void foldLogical(ExprPtr& expr);
+    void foldTernary(ExprPtr& expr);
+    void buildConstantArray(ArrayExpr* expr);
+    void buildConstantHashMap(HashMapExpr* expr);
+
+    static bool isLiteral(const ExprPtr& expr) { return expr && expr->kind == ExprKind::Literal; }
+    static const Value& literalValue(const ExprPtr& expr);
+    static bool declaresNames(Stmt* stmt);
+
+    void note(const Token& token, const std::string& change);
+
+    std::vector<std::string> changes_;
+};
+
+} // namespace volt
@@ -0,0 +1,545 @@
+#include "resolver.h"
+#include "interpreter.h"
+
+namespace volt {
+
+Resolver::Resolver(GlobalLookup globalExists)
+    : globalExists_(std::move(globalExists)) {}
+
+// ========================================
+// ENTRY POINTS
+// ========================================
+
+void Resolver::resolve(const std::vector<StmtPtr>& statements) {
+    // Globals can be used by functions declared before them
+    for (const auto& stmt : statements) {
+        collectGlobals(stmt.get());
+    }
+    for (const auto& stmt : statements) {
+        resolveStmt(stmt.get());
+    }
+    reportUnresolved();
+}
+
+void Resolver::resolve(Expr* expr) {
+    resolveExpr(expr);
+    reportUnresolved();
+}
+
+// A global read is only an error if nothing ever declares that name;
+// reading it before its 'let' has run is still a runtime error
+void Resolver::reportUnresolved() {
+    for (const auto& ref : unresolved_) {
+        if (!isKnownGlobal(ref.name)) {
+            throw RuntimeError(ref.token, "Undefined variable: " + ref.name);
+        }
+    }
+    unresolved_.clear();
+}
+
+bool Resolver::isKnownGlobal(const std::string& name) const {
+    return globals_.count(name) > 0 || globalExists_(name);
+}
+
+// ========================================
+// STATEMENTS
+// ========================================
+
+void Resolver::resolveStmt(Stmt* stmt) {
+    switch (stmt->kind) {
+        case StmtKind::Expr:
+            return resolveExpr(static_cast<ExprStmt*>(stmt)->expr.get());
+        case StmtKind::Print:
+            return resolveExpr(static_cast<PrintStmt*>(stmt)->expr.get());
+        case StmtKind::Let: {
+            auto* let = static_cast<LetStmt*>(stmt);
+            // The initializer still sees an outer variable of the same name
+            if (let->initializer) resolveExpr(let->initializer.get());
+            if (scopes_.empty()) {
+                globals_.insert(let->name);
+                let->slot = -1;
+            } else {
+                let->slot = declare(let->name, true);
+                scopes_.back().written[let->slot] = true;
+            }
+            return;
+        }
+        case StmtKind::Block:
+            return resolveBlock(static_cast<BlockStmt*>(stmt));
+        case StmtKind::If: {
+            auto* ifStmt = static_cast<IfStmt*>(stmt);
+            resolveExpr(ifStmt->condition.get());
+            resolveStmt(ifStmt->thenBranch.get());
+            if (ifStmt->elseBranch) resolveStmt(ifStmt->elseBranch.get());
+            return;
+        }
+        case StmtKind::While: {
+            auto* whileStmt = static_cast<WhileStmt*>(stmt);
+            resolveExpr(whileStmt->condition.get());
+            resolveLoopBody(whileStmt->body.get());
+            return;
+        }
+        case StmtKind::RunUntil: {
+            auto* runUntil = static_cast<RunUntilStmt*>(stmt);
+            resolveLoopBody(runUntil->body.get());
+            resolveExpr(runUntil->condition.get());
+            return;
+        }
+        case StmtKind::For:
+            return resolveFor(static_cast<ForStmt*>(stmt));
+        case StmtKind::Fn:
+            return resolveFunction(static_cast<FnStmt*>(stmt));
+        case StmtKind::Return: {
+            auto* ret = static_cast<ReturnStmt*>(stmt);
+            if (ret->value) resolveExpr(ret->value.get());
+            // The call's result is the function's result, so the call can
+            // replace the current one (a top-level return ends the script)
+            ret->tailCall = !functions_.empty() && ret->value && ret->value->kind == ExprKind::Call;
+            return;
+        }
+        case StmtKind::Break:
+            if (loopDepth_ == 0) {
+                throw RuntimeError(stmt->token, "Can't use 'break' outside of a loop");
+            }
+            return;
+        case StmtKind::Continue:
+            if (loopDepth_ == 0) {
+                throw RuntimeError(stmt->token, "Can't use 'continue' outside of a loop");
+            }
+            return;
+    }
+}
+
+void Resolver::resolveLoopBody(Stmt* body) {
+    loopDepth_++;
+    resolveStmt(body);
+    loopDepth_--;
+}
+
+void Resolver::resolveBlock(BlockStmt* stmt) {
+    std::vector<Stmt*> declarations;
+    for (const auto& inner : stmt->statements) {
+        collectDeclarations(inner.get(), declarations);
+    }
+    beginScope(declarations);
+    for (const auto& inner : stmt->statements) {
+        resolveStmt(inner.get());
+    }
+    stmt->layout = endScope();
+}
+
+void Resolver::resolveFor(ForStmt* stmt) {
+    // One scope for the loop variable; a block body gets its own
+    std::vector<Stmt*> declarations;
+    collectDeclarations(stmt->initializer.get(), declarations);
+    collectDeclarations(stmt->body.get(), declarations);
+    beginScope(declarations);
+
+    if (stmt->initializer) resolveStmt(stmt->initializer.get());
+
+    // A counter declared by the initializer that the condition and body
+    // never assign can run as a counted loop
+    int counter = -1;
+    if (stmt->initializer && stmt->initializer->kind == StmtKind::Let) {
+        counter = static_cast<LetStmt*>(stmt->initializer.get())->slot;
+        scopes_.back().written[counter] = false;
+    }
+    if (stmt->condition) resolveExpr(stmt->condition.get());
+    resolveLoopBody(stmt->body.get());
+    bool counterWritten = counter >= 0 && scopes_.back().written[counter];
+    if (stmt->increment) resolveExpr(stmt->increment.get());
+
+    stmt->counted = counter >= 0 && !counterWritten ? countedLoop(stmt, counter) : CountedLoop{};
+    stmt->layout = endScope();
+}
+
+// The condition and increment shapes a counted loop accepts (see CountedLoop)
+CountedLoop Resolver::countedLoop(ForStmt* stmt, int counter) {
+    auto isCounter = [counter](const ExprPtr& expr) {
+        if (expr->kind != ExprKind::Variable) return false;
+        const Binding& binding = static_cast<VariableExpr*>(expr.get())->binding;
+        return binding.depth == 0 && binding.slot == counter;
+    };
+    auto isCounterBinding = [counter](const Binding& binding) {
+        return binding.depth == 0 && binding.slot == counter;
+    };
+    auto numberLiteral = [](const ExprPtr& expr, double& out) {
+        if (expr->kind != ExprKind::Literal) return false;
+        const Value& value = static_cast<LiteralExpr*>(expr.get())->value;
+        if (!isNumber(value)) return false;
+        out = asNumber(value);
+        return true;
+    };
+
+    CountedLoop loop;
+    if (!stmt->condition || stmt->condition->kind != ExprKind::Binary || !stmt->increment) {
+        return loop;
+    }
+    auto* condition = static_cast<BinaryExpr*>(stmt->condition.get());
+    switch (condition->op.type) {
+        case TokenType::Less:
+        case TokenType::LessEqual:
+        case TokenType::Greater:
+        case TokenType::GreaterEqual:
+            break;
+        default:
+            return loop;
+    }
+    if (!isCounter(condition->left)) return loop;
+
+    double step = 0;
+    Expr* increment = stmt->increment.get();
+    switch (increment->kind) {
+        case ExprKind::Update: {
+            auto* update = static_cast<UpdateExpr*>(increment);
+            if (!isCounterBinding(update->binding)) return loop;
+            step = update->op.type == TokenType::PlusPlus ? 1 : -1;
+            break;
+        }
+        case ExprKind::CompoundAssign: {
+            auto* compound = static_cast<CompoundAssignExpr*>(increment);
+            if (!isCounterBinding(compound->binding) || !numberLiteral(compound->value, step)) return loop;
+            if (compound->op.type == TokenType::MinusEqual) step = -step;
+            else if (compound->op.type != TokenType::PlusEqual) return loop;
+            break;
+        }
+        case ExprKind::Assign: {
+            // i = i + k, i = k + i or i = i - k
+            auto* assign = static_cast<AssignExpr*>(increment);
+            if (!isCounterBinding(assign->binding) || assign->value->kind != ExprKind::Binary) return loop;
+            auto* sum = static_cast<BinaryExpr*>(assign->value.get());
+            if (sum->op.type == TokenType::Plus) {
+                if (!(isCounter(sum->left) && numberLiteral(sum->right, step)) &&
+                    !(isCounter(sum->right) && numberLiteral(sum->left, step))) {
+                    return loop;
+                }
+            } else if (sum->op.type == TokenType::Minus) {
+                if (!isCounter(sum->left) || !numberLiteral(sum->right, step)) return loop;
+                step = -step;
+            } else {
+                return loop;
+            }
+            break;
+        }
+        default:
+            return loop;
+    }
+
+    loop.slot = counter;
+    loop.compare = condition->op.type;
+    loop.step = step;
+    return loop;
+}
+
+void Resolver::resolveFunction(FnStmt* stmt) {
+    if (scopes_.empty()) {
+        globals_.insert(stmt->name);
+        stmt->slot = -1;
+    } else {
+        stmt->slot = declare(stmt->name, true);
+    }
+
+    size_t enclosingFunction = functionStart_;
+    int enclosingLoops = loopDepth_;
+    functionStart_ = scopes_.size();
+    loopDepth_ = 0;  // 'break' can't leave the function
+    functions_.push_back({stmt, functionStart_});
+    stmt->captures.clear();
+
+    // Parameters take slots 0..n-1, in order, then the body's locals
+    scopes_.push_back(Scope{});
+    for (const auto& param : stmt->parameters) {
+        scopes_.back().names.push_back(param);
+        scopes_.back().declared.push_back(true);
+        scopes_.back().written.push_back(false);
+        scopes_.back().captured.push_back(false);
+    }
+    std::vector<Stmt*> declarations;
+    for (const auto& inner : stmt->body) {
+        collectDeclarations(inner.get(), declarations);
+    }
+    for (Stmt* decl : declarations) {
+        declare(declaredName(decl), false);
+    }
+
+    for (const auto& inner : stmt->body) {
+        resolveStmt(inner.get());
+    }
+
+    stmt->layout = endScope();
+    functionStart_ = enclosingFunction;
+    loopDepth_ = enclosingLoops;
+    functions_.pop_back();
+}
+
+// ========================================
+// EXPRESSIONS
+// ========================================
+
+void Resolver::resolveExpr(Expr* expr) {
+    switch (expr->kind) {
+        case ExprKind::Literal:
+            return;
+        case ExprKind::Variable: {
+            auto* var = static_cast<VariableExpr*>(expr);
+            var->binding = resolveRead(var->name, var->token);
+            return;
+        }
+        case ExprKind::Unary:
+            return resolveExpr(static_cast<UnaryExpr*>(expr)->right.get());
+        case ExprKind::Binary: {
+            auto* binary = static_cast<BinaryExpr*>(expr);
+            resolveExpr(binary->left.get());
+            resolveExpr(binary->right.get());
+            return;
+        }
+        case ExprKind::Logical: {
+            auto* logical = static_cast<LogicalExpr*>(expr);
+            resolveExpr(logical->left.get());
+            resolveExpr(logical->right.get());
+            return;
+        }
+        case ExprKind::Grouping:
+            return resolveExpr(static_cast<GroupingExpr*>(expr)->expr.get());
+        case ExprKind::Call: {
+            auto* call = static_cast<CallExpr*>(expr);
+            resolveExpr(call->callee.get());
+            for (const auto& arg : call->arguments) resolveExpr(arg.get());
+            return;
+        }
+        case ExprKind::Assign: {
+            auto* assign = static_cast<AssignExpr*>(expr);
+            resolveExpr(assign->value.get());
+            assign->binding = resolveWrite(assign->name);
+            return;
+        }
+        case ExprKind::CompoundAssign: {
+            auto* compound = static_cast<CompoundAssignExpr*>(expr);
+            compound->binding = resolveRead(compound->name, compound->token, true);
+            resolveExpr(compound->value.get());
+            return;
+        }
+        case ExprKind::Update: {
+            auto* update = static_cast<UpdateExpr*>(expr);
+            update->binding = resolveRead(update->name, update->token, true);
+            return;
+        }
+        case ExprKind::Ternary: {
+            auto* ternary = static_cast<TernaryExpr*>(expr);
+            resolveExpr(ternary->condition.get());
+            resolveExpr(ternary->thenBranch.get());
+            resolveExpr(ternary->elseBranch.get());
+            return;
+        }
+        case ExprKind::Array:
+            for (const auto& element : static_cast<ArrayExpr*>(expr)->elements) {
+                resolveExpr(element.get());
+            }
+            return;
+        case ExprKind::Index: {
+            auto* index = static_cast<IndexExpr*>(expr);
+            resolveExpr(index->object.get());
+            resolveExpr(index->index.get());
+            return;
+        }
+        case ExprKind::IndexAssign: {
+            auto* indexAssign = static_cast<IndexAssignExpr*>(expr);
+            resolveExpr(indexAssign->object.get());
+            resolveExpr(indexAssign->index.get());
+            resolveExpr(indexAssign->value.get());
+            return;
+        }
+        case ExprKind::HashMap:
+            for (const auto& [key, value] : static_cast<HashMapExpr*>(expr)->keyValuePairs) {
+                resolveExpr(key.get());
+                resolveExpr(value.get());
+            }
+            return;
+        case ExprKind::Member:
+            return resolveExpr(static_cast<MemberExpr*>(expr)->object.get());
+        case ExprKind::MemberAssign: {
+            auto* assign = static_cast<MemberAssignExpr*>(expr);
+            resolveExpr(assign->object.get());
+            resolveExpr(assign->value.get());
+            return;
+        }
+        case ExprKind::MethodCall: {
+            auto* call = static_cast<MethodCallExpr*>(expr);
+            resolveExpr(call->object.get());
+            for (const auto& arg : call->arguments) resolveExpr(arg.get());
+            return;
+        }
+    }
+}
+
+Binding Resolver::resolveRead(const std::string& name, const Token& token, bool write) {
+    Location location = lookup(name);
+    if (location.scope < 0) {
+        unresolved_.push_back({name, token});
+    }
+    return bind(location, write);
+}
+
+// Assigning to an unknown name declares it in the current scope
+Binding Resolver::resolveWrite(const std::string& name) {
+    Location location = lookup(name);
+    if (location.scope >= 0) return bind(location, true);
+
+    if (scopes_.empty()) {
+        globals_.insert(name);
+        return Binding{};
+    }
+    if (isKnownGlobal(name)) return Binding{};
+
+    int slot = declare(name, true);
+    return bind(Location{static_cast<int>(scopes_.size()) - 1, slot}, true);
+}
+
+// Variables of the current function are slots in its scopes; those of an
+// enclosing function are reached through a capture
+Binding Resolver::bind(const Location& location, bool write) {
+    Binding binding;
+    if (location.scope < 0) return binding;
+
+    if (write) scopes_[location.scope].written[location.slot] = true;
+    if (static_cast<size_t>(location.scope) >= functionStart_) {
+        binding.depth = static_cast<int>(scopes_.size()) - 1 - location.scope;
+        binding.slot = location.slot;
+    } else {
+        binding.capture = capture(functions_.size() - 1, location);
+    }
+    return binding;
+}
+
+// Index of 'location' among the captures of functions_[level], adding it
+// (and the captures of every function in between) as needed
+int Resolver::capture(size_t level, const Location& location) {
+    const FunctionContext& context = functions_[level];
+    size_t outerStart = level == 0 ? 0 : functions_[level - 1].firstScope;
+
+    Capture capture;
+    if (static_cast<size_t>(location.scope) >= outerStart) {
+        // Declared in the function (or script) around this one
+        capture.depth = static_cast<int>(context.firstScope) - 1 - location.scope;
+        capture.slot = location.slot;
+        scopes_[location.scope].captured[location.slot] = true;
+    } else {
+        capture.local = false;
+        capture.index = this->capture(level - 1, location);
+    }
+
+    std::vector<Capture>& captures = context.function->captures;
+    for (size_t i = 0; i < captures.size(); i++) {
+        const Capture& existing = captures[i];
+        if (existing.local == capture.local && existing.depth == capture.depth &&
+            existing.slot == capture.slot && existing.index == capture.index) {
+            return static_cast<int>(i);
+        }
+    }
+    captures.push_back(capture);
+    return static_cast<int>(captures.size() - 1);
+}
+
+// ========================================
+// SCOPES
+// ========================================
+
+void Resolver::beginScope(const std::vector<Stmt*>& declarations) {
+    scopes_.push_back(Scope{});
+    for (Stmt* decl : declarations) {
+        declare(declaredName(decl), false);
+    }
+}
+
+// Hands the scope's layout to the node that owns the scope
+ScopeLayout Resolver::endScope() {
+    Scope& scope = scopes_.back();
+    ScopeLayout layout;
+    for (size_t slot = 0; slot < scope.captured.size(); slot++) {
+        if (scope.captured[slot]) layout.cells.push_back(static_cast<int>(slot));
+    }
+    layout.names = std::move(scope.names);
+    scopes_.pop_back();
+    return layout;
+}
+
+// Redeclaring a name in the same scope reuses its slot
+int Resolver::declare(const std::string& name, bool declared) {
+    Scope& scope = scopes_.back();
+    for (size_t i = 0; i < scope.names.size(); i++) {
+        if (scope.names[i] == name) {
+            if (declared) scope.declared[i] = true;
+            return static_cast<int>(i);
+        }
+    }
+    scope.names.push_back(name);
+    scope.declared.push_back(declared);
+    scope.written.push_back(false);
+    scope.captured.push_back(false);
+    return static_cast<int>(scope.names.size() - 1);
+}
+
+Resolver::Location Resolver::lookup(const std::string& name) const {
+    for (size_t i = scopes_.size(); i-- > 0;) {
+        const Scope& scope = scopes_[i];
+        // Code in a nested function runs later, so it may already see
+        // hoisted declarations of the functions around it
+        bool seesHoisted = i < functionStart_;
+        for (size_t slot = scope.names.size(); slot-- > 0;) {
+            if (scope.names[slot] == name && (scope.declared[slot] || seesHoisted)) {
+                return Location{static_cast<int>(i), static_cast<int>(slot)};
+            }
+        }
+    }
+    return Location{};
+}
+
+// Declarations that land in the enclosing scope: direct statements plus
+// the bodies of if/while/run that are not blocks themselves
+void Resolver::collectDeclarations(Stmt* stmt, std::vector<Stmt*>& out) {
+    if (!stmt) return;
+    switch (stmt->kind) {
+        case StmtKind::Let:
+        case StmtKind::Fn:
+            out.push_back(stmt);
+            break;
+        case StmtKind::If: {
+            auto* ifStmt = static_cast<IfStmt*>(stmt);
+            collectDeclarations(ifStmt->thenBranch.get(), out);
+            collectDeclarations(ifStmt->elseBranch.get(), out);
+            break;
+        }
+        case StmtKind::While:
+            collectDeclarations(static_cast<WhileStmt*>(stmt)->body.get(), out);
+            break;
+        case StmtKind::RunUntil:
+            collectDeclarations(static_cast<RunUntilStmt*>(stmt)->body.get(), out);
+            break;
+        default:
+            break;
+    }
+}
+
+const std::string& Resolver::declaredName(Stmt* decl) {
+    if (decl->kind == StmtKind::Let) {
+        return static_cast<LetStmt*>(decl)->name;
+    }
+    return static_cast<FnStmt*>(decl)->name;
+}
+
+// Names the program declares at the top level, including 'x = 1;'
+void Resolver::collectGlobals(Stmt* stmt) {
+    std::vector<Stmt*> declarations;
+    collectDeclarations(stmt, declarations);
+    for (Stmt* decl : declarations) {
+        globals_.insert(declaredName(decl));
+    }
+    if (stmt->kind == StmtKind::Expr) {
+        Expr* expr = static_cast<ExprStmt*>(stmt)->expr.get();
+        if (expr->kind == ExprKind::Assign) {
+            globals_.insert(static_cast<AssignExpr*>(expr)->name);
+        }
+    }
+}
+
+} // namespace volt
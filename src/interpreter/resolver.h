@@ -0,0 +1,97 @@
+#pragma once
+#include "stmt.h"
+#include "ast.h"
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace volt {
+
+/**
+ * Resolver - Binds every variable reference to a scope slot
+ *
+ * Runs after parsing and before execution. It mirrors the scopes the
+ * interpreter creates at runtime (blocks, for-loops, function calls) and
+ * annotates each variable reference with how many scopes up it lives and
+ * at which slot, so the interpreter can index straight into the right
+ * Environment instead of hashing the name once per scope level.
+ *
+ * Declarations are hoisted to the top of their scope, which lets nested
+ * functions call siblings declared after them. Names that are never
+ * declared anywhere, and 'break'/'continue' outside a loop, are reported
+ * before the program runs.
+ */
+class Resolver {
+public:
+    // Tells the resolver which globals already exist (natives, earlier REPL input)
+    using GlobalLookup = std::function<bool(const std::string&)>;
+
+    explicit Resolver(GlobalLookup globalExists);
+
+    // Resolve a whole program; throws RuntimeError on undefined variables
+    void resolve(const std::vector<StmtPtr>& statements);
+
+    // Resolve a standalone expression (evaluated in the global scope)
+    void resolve(Expr* expr);
+
+private:
+    struct Scope {
+        std::vector<std::string> names;  // Slot -> name
+        std::vector<bool> declared;      // Visible to direct references yet?
+        std::vector<bool> written;       // Assigned or redeclared since the flag was cleared?
+        std::vector<bool> captured;      // Used by a nested function?
+    };
+
+    // Where a name is declared: scopes_[scope], at 'slot' (scope -1: global)
+    struct Location {
+        int scope = -1;
+        int slot = -1;
+    };
+
+    struct FunctionContext {
+        FnStmt* function;
+        size_t firstScope;  // Its parameter scope
+    };
+
+    struct Unresolved {
+        std::string name;
+        Token token;
+    };
+
+    // Statements
+    void resolveStmt(Stmt* stmt);
+    void resolveBlock(BlockStmt* stmt);
+    void resolveFor(ForStmt* stmt);
+    void resolveFunction(FnStmt* stmt);
+    void resolveLoopBody(Stmt* body);
+    static CountedLoop countedLoop(ForStmt* stmt, int counter);
+
+    // Expressions
+    void resolveExpr(Expr* expr);
+    Binding resolveRead(const std::string& name, const Token& token, bool write = false);
+    Binding resolveWrite(const std::string& name);
+    Binding bind(const Location& location, bool write);
+    int capture(size_t level, const Location& location);
+
+    // Scopes
+    void beginScope(const std::vector<Stmt*>& declarations);
+    ScopeLayout endScope();
+    int declare(const std::string& name, bool declared);
+    Location lookup(const std::string& name) const;
+    static void collectDeclarations(Stmt* stmt, std::vector<Stmt*>& out);
+    static const std::string& declaredName(Stmt* decl);
+    void collectGlobals(Stmt* stmt);
+    bool isKnownGlobal(const std::string& name) const;
+    void reportUnresolved();
+
+    GlobalLookup globalExists_;
+    std::vector<Scope> scopes_;
+    size_t functionStart_ = 0;  // First scope of the function being resolved
+    int loopDepth_ = 0;         // Loops around the current statement (within the function)
+    std::vector<FunctionContext> functions_;  // Functions around the current statement, outermost first
+    std::unordered_set<std::string> globals_;
+    std::vector<Unresolved> unresolved_;
+};
+
+} // namespace volt
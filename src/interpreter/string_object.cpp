@@ -0,0 +1,90 @@
+#include "string_object.h"
+#include <cctype>
+#include <unordered_set>
+
+namespace volt {
+
+namespace {
+
+// A string that isn't in the table, looked up by content with its cached hash
+struct ContentOf {
+    const StringObject* string;
+};
+
+// Looks strings up by content, whether stored or passed as a view
+struct InternHash {
+    using is_transparent = void;
+    size_t operator()(const StringObject* s) const { return s->hash(); }
+    size_t operator()(std::string_view s) const { return StringObject::hashOf(s); }
+    size_t operator()(ContentOf s) const { return s.string->hash(); }
+};
+
+struct InternEqual {
+    using is_transparent = void;
+    bool operator()(const StringObject* a, const StringObject* b) const { return a == b; }
+    bool operator()(const StringObject* a, std::string_view b) const { return a->view() == b; }
+    bool operator()(std::string_view a, const StringObject* b) const { return a == b->view(); }
+    bool operator()(const StringObject* a, ContentOf b) const { return a->view() == b.string->view(); }
+    bool operator()(ContentOf a, const StringObject* b) const { return a.string->view() == b->view(); }
+};
+
+using InternTable = std::unordered_set<StringObject*, InternHash, InternEqual>;
+
+// Never destroyed: strings held by other statics may die after it would
+InternTable& internTable() {
+    static InternTable* table = new InternTable();
+    return *table;
+}
+
+bool looksLikeIdentifier(std::string_view s) {
+    if (s.empty() || s.size() > 32) return false;
+    if (!std::isalpha(static_cast<unsigned char>(s[0])) && s[0] != '_') return false;
+    for (char c : s) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_') return false;
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+StringObject::~StringObject() {
+    if (interned_) {
+        internTable().erase(this);
+    }
+}
+
+Ref<StringObject> StringObject::create(std::string chars) {
+    return makeRef<StringObject>(std::move(chars));
+}
+
+Ref<StringObject> StringObject::intern(std::string_view chars) {
+    if (StringObject* existing = findInterned(chars)) {
+        return Ref<StringObject>(existing);
+    }
+    auto string = makeRef<StringObject>(std::string(chars));
+    string->interned_ = true;
+    internTable().insert(string.get());
+    return string;
+}
+
+StringObject* StringObject::findInterned(std::string_view chars) {
+    auto& table = internTable();
+    auto it = table.find(chars);
+    return it != table.end() ? *it : nullptr;
+}
+
+StringObject* StringObject::findInterned(const StringObject* string) {
+    if (string->interned_) return const_cast<StringObject*>(string);
+    auto& table = internTable();
+    auto it = table.find(ContentOf{string});
+    return it != table.end() ? *it : nullptr;
+}
+
+Ref<StringObject> StringObject::fromLiteral(std::string_view chars) {
+    if (looksLikeIdentifier(chars)) {
+        return intern(chars);
+    }
+    return create(std::string(chars));
+}
+
+} // namespace volt
@@ -0,0 +1,66 @@
+#pragma once
+#include "object.h"
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace volt {
+
+/**
+ * StringObject - Immutable, shared storage behind a string Value
+ *
+ * Copying a string Value only bumps the reference count; the characters
+ * are never copied again after creation. The hash is computed on first
+ * use and cached, so hash map lookups don't rescan the characters.
+ *
+ * Strings can be interned: intern() returns the one shared object for a
+ * given content. String literals that look like identifiers and every
+ * hash map key are interned, so equal keys are the same object and
+ * compare by pointer. The intern table doesn't own its strings; an
+ * interned string removes itself when its last reference goes away.
+ */
+class StringObject : public Object {
+public:
+    explicit StringObject(std::string chars) : chars_(std::move(chars)) {}
+    ~StringObject() override;
+
+    // A new (not interned) string
+    static Ref<StringObject> create(std::string chars);
+
+    // The shared string with this content, created if needed
+    static Ref<StringObject> intern(std::string_view chars);
+
+    // The interned string with this content, or nullptr (never allocates)
+    static StringObject* findInterned(std::string_view chars);
+    
+    // Same for an existing string, reusing its cached hash
+    static StringObject* findInterned(const StringObject* string);
+
+    // Interned if it looks like an identifier ("name", "x1"), else new
+    static Ref<StringObject> fromLiteral(std::string_view chars);
+
+    const std::string& str() const { return chars_; }
+    std::string_view view() const { return chars_; }
+    size_t length() const { return chars_.size(); }
+    bool isInterned() const { return interned_; }
+
+    size_t hash() const {
+        if (!hashed_) {
+            hash_ = hashOf(chars_);
+            hashed_ = true;
+        }
+        return hash_;
+    }
+
+    static size_t hashOf(std::string_view chars) {
+        return std::hash<std::string_view>{}(chars);
+    }
+
+private:
+    const std::string chars_;
+    mutable size_t hash_ = 0;
+    mutable bool hashed_ = false;
+    bool interned_ = false;
+};
+
+} // namespace volt
@@ -32,8 +32,8 @@ bool isEqual(const Value& a, const Value& b) {
         return asBool(a) == asBool(b);
     }
     if (isCallable(a) && isCallable(b)) {
-        return std::get<std::shared_ptr<Callable>>(a) ==
-               std::get<std::shared_ptr<Callable>>(b);
+        return asCallable(a) ==
+               asCallable(b);
     }
     // Arrays compare by reference
     if (isArray(a) && isArray(b)) {
@@ -69,7 +69,7 @@ std::string valueToString(const Value& v) {
     } else if (isBool(v)) {
         return asBool(v) ? "true" : "false";
     } else if (isCallable(v)) {
-        auto func = std::get<std::shared_ptr<Callable>>(v);
+        auto func = asCallable(v);
         return func->toString();
     } else if (isArray(v)) {
         return asArray(v)->toString();
@@ -80,7 +80,7 @@ std::string valueToString(const Value& v) {
         bool first = true;
         for (const auto& [key, value] : map->data) {
             if (!first) oss << ", ";
-            oss << "\"" << key << "\": " << valueToString(value);
+            oss << "\"" << valueToString(key) << "\": " << valueToString(value);
             first = false;
         }
         oss << "}";
@@ -1,5 +1,8 @@
 #pragma once
-#include <variant>
+#include "object.h"
+#include "string_object.h"
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <memory>
 #include <vector>
@@ -10,66 +13,196 @@ namespace volt {
 class Callable;
 class VoltArray;  // NEW!
 struct VoltHashMap;  // NEW! - Changed from class to struct to match definition
-
-// Runtime value types
-using Value = std::variant<
-    std::nullptr_t,              // nil
-    bool,                        // boolean
-    double,                      // number
-    std::string,                 // string
-    std::shared_ptr<Callable>,   // function
-    std::shared_ptr<VoltArray>,  // array - NEW!
-    std::shared_ptr<VoltHashMap> // hash map - NEW!
->;
+struct Cell;
+
+/**
+ * Value - A VoltScript runtime value in 8 bytes (NaN-boxed)
+ *
+ * Numbers are stored as plain doubles. Every other value hides in the
+ * payload of a quiet NaN that arithmetic never produces:
+ *
+ *   number   any double (NaNs are canonicalized on the way in)
+ *   nil      kQuietNaN | 1
+ *   false    kQuietNaN | 2
+ *   true     kQuietNaN | 3
+ *   object   kSignBit | kQuietNaN | pointer | type tag (low 3 bits)
+ *
+ * Objects (strings, functions, arrays, hash maps) are reference counted
+ * through their Object header. The type tag in the pointer's low bits
+ * lets isArray() & co. answer without touching the heap.
+ *
+ * Use the isX()/asX() helpers below rather than the raw bits.
+ */
+class Value {
+public:
+    // Low 3 bits of an object value (objects are 8-byte aligned). A Cell
+    // only ever sits in an Environment slot and never reaches a program.
+    enum class Tag : uint64_t { String = 0, Callable = 1, Array = 2, HashMap = 3, Cell = 4 };
+
+    static constexpr uint64_t kSignBit = 0x8000000000000000ull;
+    static constexpr uint64_t kQuietNaN = 0x7ffc000000000000ull;
+    static constexpr uint64_t kCanonicalNaN = 0x7ff8000000000000ull;
+    static constexpr uint64_t kNil = kQuietNaN | 1;
+    static constexpr uint64_t kFalse = kQuietNaN | 2;
+    static constexpr uint64_t kTrue = kQuietNaN | 3;
+    static constexpr uint64_t kObjectBits = kSignBit | kQuietNaN;
+    static constexpr uint64_t kTagMask = 7;
+    static constexpr uint64_t kPointerMask = ~(kObjectBits | kTagMask);
+
+    Value() : bits_(kNil) {}
+    Value(std::nullptr_t) : bits_(kNil) {}
+    Value(bool b) : bits_(b ? kTrue : kFalse) {}
+    Value(double d) {
+        if (d != d) {
+            bits_ = kCanonicalNaN;  // Keep NaN payloads from looking like objects
+        } else {
+            std::memcpy(&bits_, &d, sizeof d);
+        }
+    }
+    Value(std::string s) : Value(StringObject::create(std::move(s)), Tag::String) {}
+    Value(const char* s) : Value(std::string(s)) {}
+
+    // Functions, arrays and hash maps (any subclass of Callable works)
+    template <typename T>
+    Value(const Ref<T>& ref) : Value(ref, tagFor<T>()) {}
+
+    Value(const Value& other) : bits_(other.bits_) {
+        if (isObject()) object()->retain();
+    }
+    Value(Value&& other) noexcept : bits_(other.bits_) { other.bits_ = kNil; }
+    ~Value() {
+        if (isObject()) object()->release();
+    }
+
+    Value& operator=(const Value& other) {
+        if (other.isObject()) other.object()->retain();
+        if (isObject()) object()->release();
+        bits_ = other.bits_;
+        return *this;
+    }
+    Value& operator=(Value&& other) noexcept {
+        if (this != &other) {
+            if (isObject()) object()->release();
+            bits_ = other.bits_;
+            other.bits_ = kNil;
+        }
+        return *this;
+    }
+
+    // Raw classification (see the free helpers below for the public API)
+    bool isNumber() const { return (bits_ & kQuietNaN) != kQuietNaN; }
+    bool isObject() const { return (bits_ & kObjectBits) == kObjectBits; }
+    bool isObject(Tag tag) const {
+        return (bits_ & (kObjectBits | kTagMask)) == (kObjectBits | static_cast<uint64_t>(tag));
+    }
+    uint64_t bits() const { return bits_; }
+
+    double number() const {
+        double d;
+        std::memcpy(&d, &bits_, sizeof d);
+        return d;
+    }
+    Object* object() const { return reinterpret_cast<Object*>(bits_ & kPointerMask); }
+
+    // Strings compare by content, numbers by value, objects by identity
+    bool operator==(const Value& other) const;
+    bool operator!=(const Value& other) const { return !(*this == other); }
+
+private:
+    template <typename T>
+    Value(const Ref<T>& ref, Tag tag) {
+        Object* obj = ref.object();
+        if (!obj) {
+            bits_ = kNil;
+            return;
+        }
+        obj->retain();
+        bits_ = kObjectBits | reinterpret_cast<uint64_t>(obj) | static_cast<uint64_t>(tag);
+    }
+
+    template <typename T>
+    static constexpr Tag tagFor() {
+        if constexpr (std::is_base_of_v<Callable, T>) return Tag::Callable;
+        else if constexpr (std::is_same_v<T, VoltArray>) return Tag::Array;
+        else if constexpr (std::is_same_v<T, VoltHashMap>) return Tag::HashMap;
+        else if constexpr (std::is_same_v<T, Cell>) return Tag::Cell;
+        else {
+            static_assert(std::is_same_v<T, StringObject>, "not a VoltScript value type");
+            return Tag::String;
+        }
+    }
+
+    uint64_t bits_;
+};
+
+static_assert(sizeof(Value) == 8, "Value must stay NaN-boxed");
 
 // Type checking helpers
 inline bool isNil(const Value& v) {
-    return std::holds_alternative<std::nullptr_t>(v);
+    return v.bits() == Value::kNil;
 }
 
 inline bool isBool(const Value& v) {
-    return std::holds_alternative<bool>(v);
+    return (v.bits() | 1) == Value::kTrue;
 }
 
 inline bool isNumber(const Value& v) {
-    return std::holds_alternative<double>(v);
+    return v.isNumber();
 }
 
 inline bool isString(const Value& v) {
-    return std::holds_alternative<std::string>(v);
+    return v.isObject(Value::Tag::String);
 }
 
 inline bool isCallable(const Value& v) {
-    return std::holds_alternative<std::shared_ptr<Callable>>(v);
+    return v.isObject(Value::Tag::Callable);
 }
 
 inline bool isArray(const Value& v) {  // NEW!
-    return std::holds_alternative<std::shared_ptr<VoltArray>>(v);
+    return v.isObject(Value::Tag::Array);
 }
 
 inline bool isHashMap(const Value& v) {  // NEW!
-    return std::holds_alternative<std::shared_ptr<VoltHashMap>>(v);
+    return v.isObject(Value::Tag::HashMap);
 }
 
 // Get typed values
 inline double asNumber(const Value& v) {
-    return std::get<double>(v);
+    return v.number();
 }
 
 inline bool asBool(const Value& v) {
-    return std::get<bool>(v);
+    return v.bits() == Value::kTrue;
+}
+
+// Borrowed: valid as long as the Value it came from
+inline const std::string& asString(const Value& v) {
+    return static_cast<StringObject*>(v.object())->str();
+}
+
+inline StringObject* asStringObject(const Value& v) {
+    return static_cast<StringObject*>(v.object());
+}
+
+inline Ref<Callable> asCallable(const Value& v) {
+    return Ref<Callable>(v.object());
 }
 
-inline std::string asString(const Value& v) {
-    return std::get<std::string>(v);
+inline Ref<VoltArray> asArray(const Value& v) {  // NEW!
+    return Ref<VoltArray>(v.object());
 }
 
-inline std::shared_ptr<VoltArray> asArray(const Value& v) {  // NEW!
-    return std::get<std::shared_ptr<VoltArray>>(v);
+inline Ref<VoltHashMap> asHashMap(const Value& v) {  // NEW!
+    return Ref<VoltHashMap>(v.object());
 }
 
-inline std::shared_ptr<VoltHashMap> asHashMap(const Value& v) {  // NEW!
-    return std::get<std::shared_ptr<VoltHashMap>>(v);
+inline bool Value::operator==(const Value& other) const {
+    if (isNumber() && other.isNumber()) return number() == other.number();
+    if (bits_ == other.bits_) return true;  // Same object (interned strings too)
+    if (isObject(Tag::String) && other.isObject(Tag::String)) {
+        return asStringObject(*this)->str() == asStringObject(other)->str();
+    }
+    return false;
 }
 
 // Truthiness (for conditionals)
@@ -81,4 +214,4 @@ bool isEqual(const Value& a, const Value& b);
 // String representation
 std::string valueToString(const Value& v);
 
-} // namespace volt
\ No newline at end of file
+} // namespace volt
@@ -1,9 +1,13 @@
 #include "lexer.h"
 #include "parser.h"
 #include "interpreter.h"
+#include "optimizer.h"
+#include "gc.h"
+#include "vm/vm.h"
 #include "ast.h"
 #include "stmt.h"
 #include "token.h"
+#include <deque>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -26,48 +30,68 @@ void dumpTokens(const std::vector<volt::Token>& tokens) {
 
 // Helper to print statements for debug mode
 void dumpStatements(const std::vector<volt::StmtPtr>& statements) {
+    using volt::StmtKind;
     std::cout << "\n=== AST ===\n";
     for (size_t i = 0; i < statements.size(); i++) {
+        volt::Stmt* stmt = statements[i].get();
         std::cout << i + 1 << ": ";
-        if (auto* exprStmt = dynamic_cast<volt::ExprStmt*>(statements[i].get())) {
-            std::cout << "ExprStmt: " << volt::printAST(exprStmt->expr.get());
-        } else if (auto* printStmt = dynamic_cast<volt::PrintStmt*>(statements[i].get())) {
-            std::cout << "PrintStmt: " << volt::printAST(printStmt->expr.get());
-        } else if (auto* letStmt = dynamic_cast<volt::LetStmt*>(statements[i].get())) {
-            std::cout << "LetStmt: " << letStmt->name;
-            if (letStmt->initializer) {
-                std::cout << " = " << volt::printAST(letStmt->initializer.get());
+        switch (stmt->kind) {
+            case StmtKind::Expr:
+                std::cout << "ExprStmt: " << volt::printAST(static_cast<volt::ExprStmt*>(stmt)->expr.get());
+                break;
+            case StmtKind::Print:
+                std::cout << "PrintStmt: " << volt::printAST(static_cast<volt::PrintStmt*>(stmt)->expr.get());
+                break;
+            case StmtKind::Let: {
+                auto* letStmt = static_cast<volt::LetStmt*>(stmt);
+                std::cout << "LetStmt: " << letStmt->name;
+                if (letStmt->initializer) {
+                    std::cout << " = " << volt::printAST(letStmt->initializer.get());
+                }
+                break;
             }
-        } else if (dynamic_cast<volt::IfStmt*>(statements[i].get())) {
-            std::cout << "IfStmt";
-        } else if (dynamic_cast<volt::WhileStmt*>(statements[i].get())) {
-            std::cout << "WhileStmt";
-        } else if (dynamic_cast<volt::ForStmt*>(statements[i].get())) {
-            std::cout << "ForStmt";
-        } else if (auto* fnStmt = dynamic_cast<volt::FnStmt*>(statements[i].get())) {
-            std::cout << "FnStmt: " << fnStmt->name << "(";
-            for (size_t j = 0; j < fnStmt->parameters.size(); j++) {
-                if (j > 0) std::cout << ", ";
-                std::cout << fnStmt->parameters[j];
+            case StmtKind::If:
+                std::cout << "IfStmt";
+                break;
+            case StmtKind::While:
+                std::cout << "WhileStmt";
+                break;
+            case StmtKind::For:
+                std::cout << "ForStmt";
+                break;
+            case StmtKind::Fn: {
+                auto* fnStmt = static_cast<volt::FnStmt*>(stmt);
+                std::cout << "FnStmt: " << fnStmt->name << "(";
+                for (size_t j = 0; j < fnStmt->parameters.size(); j++) {
+                    if (j > 0) std::cout << ", ";
+                    std::cout << fnStmt->parameters[j];
+                }
+                std::cout << ")";
+                break;
             }
-            std::cout << ")";
-        } else if (dynamic_cast<volt::ReturnStmt*>(statements[i].get())) {
-            std::cout << "ReturnStmt";
-        } else if (dynamic_cast<volt::BreakStmt*>(statements[i].get())) {
-            std::cout << "BreakStmt";
-        } else if (dynamic_cast<volt::ContinueStmt*>(statements[i].get())) {
-            std::cout << "ContinueStmt";
-        } else if (dynamic_cast<volt::BlockStmt*>(statements[i].get())) {
-            std::cout << "BlockStmt";
-        } else {
-            std::cout << "Unknown";
+            case StmtKind::Return:
+                std::cout << "ReturnStmt";
+                break;
+            case StmtKind::Break:
+                std::cout << "BreakStmt";
+                break;
+            case StmtKind::Continue:
+                std::cout << "ContinueStmt";
+                break;
+            case StmtKind::Block:
+                std::cout << "BlockStmt";
+                break;
+            default:
+                std::cout << "Unknown";
+                break;
         }
         std::cout << "\n";
     }
     std::cout << "===========\n\n";
 }
 
-void runFile(const std::string& path, volt::Interpreter& interpreter, bool debugMode = false) {
+void runFile(const std::string& path, volt::Interpreter& interpreter, bool debugMode = false,
+             bool dumpOptimized = false) {
     std::ifstream file(path);
     if (!file) {
         std::cerr << "Could not open file: " << path << "\n";
@@ -98,11 +122,32 @@ void runFile(const std::string& path, volt::Interpreter& interpreter, bool debug
         exit(65);
     }
     
-    // Debug: print AST
+    // Debug: print the AST as parsed
     if (debugMode) {
         dumpStatements(statements);
     }
     
+    volt::Optimizer optimizer;
+    optimizer.optimize(statements);
+    if (dumpOptimized) {
+        std::cout << "\n=== OPTIMIZATIONS ===\n";
+        for (const auto& change : optimizer.changes()) {
+            std::cout << change << "\n";
+        }
+        if (optimizer.changes().empty()) {
+            std::cout << "(none)\n";
+        }
+        std::cout << "=====================\n";
+        dumpStatements(statements);
+    }
+    
+    // Debug: print bytecode when running on the VM
+    if (debugMode) {
+        if (interpreter.getEngine() == volt::Engine::Vm) {
+            interpreter.vm().setDumpBytecode(true);
+        }
+    }
+    
     // Execute
     try {
         interpreter.execute(statements);
@@ -139,11 +184,17 @@ bool isIncomplete(const std::string& input) {
     return braces > 0 || parens > 0 || inString;
 }
 
-void runPrompt() {
-    volt::Interpreter interpreter;
+void runPrompt(volt::Engine engine) {
+    volt::Interpreter interpreter(engine);
     std::vector<std::string> history;
     std::string buffer;
     
+    // Functions defined on one line are called on later ones, and they
+    // point into the AST (and tokens into the source), so every executed
+    // line stays alive for the whole session
+    std::deque<std::string> sources;
+    std::vector<std::vector<volt::StmtPtr>> programs;
+    
     std::cout << "VoltScript v0.7.0 REPL\n";
     std::cout << "Type 'exit' to quit, 'history' to show command history\n\n";
     
@@ -188,7 +239,8 @@ void runPrompt() {
         
         try {
             // Tokenize
-            volt::Lexer lexer(buffer);
+            const std::string& source = sources.emplace_back(buffer);
+            volt::Lexer lexer(source);
             auto tokens = lexer.tokenize();
             
             // Parse
@@ -199,12 +251,16 @@ void runPrompt() {
                 for (const auto& error : parser.getErrors()) {
                     std::cerr << error << "\n";
                 }
+                sources.pop_back();
                 buffer.clear();
                 continue;
             }
             
+            volt::Optimizer().optimize(statements);
+            
             // Execute
-            interpreter.execute(statements);
+            programs.push_back(std::move(statements));
+            interpreter.execute(programs.back());
             
         } catch (const volt::RuntimeError& e) {
             std::cerr << "Runtime Error [Line " << e.token.line 
@@ -220,6 +276,8 @@ void runPrompt() {
 
 int main(int argc, char** argv) {
     bool debugMode = false;
+    bool dumpOptimized = false;
+    volt::Engine engine = volt::Interpreter::defaultEngine();
     std::string scriptPath;
     
     // Parse command-line arguments
@@ -227,11 +285,41 @@ int main(int argc, char** argv) {
         std::string arg = argv[i];
         if (arg == "--debug" || arg == "-d") {
             debugMode = true;
+        } else if (arg == "--dump-optimized") {
+            dumpOptimized = true;
+        } else if (arg.rfind("--engine=", 0) == 0) {
+            std::string name = arg.substr(9);
+            if (name == "vm") {
+                engine = volt::Engine::Vm;
+            } else if (name == "ast") {
+                engine = volt::Engine::Ast;
+            } else {
+                std::cerr << "Unknown engine: " << name << " (expected 'vm' or 'ast')\n";
+                return 64;
+            }
+        } else if (arg.rfind("--gc-pause-ms=", 0) == 0) {
+            std::string budget = arg.substr(14);
+            double ms = 0;
+            try {
+                size_t used = 0;
+                ms = std::stod(budget, &used);
+                if (used != budget.size()) ms = -1;
+            } catch (...) {
+                ms = -1;
+            }
+            if (!(ms > 0)) {
+                std::cerr << "Invalid GC pause budget: " << budget << " (expected milliseconds > 0)\n";
+                return 64;
+            }
+            volt::Collector::setPauseBudget(ms);
         } else if (arg == "--help" || arg == "-h") {
             std::cout << "VoltScript v0.7.0\n";
             std::cout << "Usage: volt [options] [script]\n\n";
             std::cout << "Options:\n";
-            std::cout << "  --debug, -d    Print tokens and AST before execution\n";
+            std::cout << "  --debug, -d    Print tokens and AST (and bytecode) before execution\n";
+            std::cout << "  --dump-optimized  Print what the optimizer changed and the optimized AST\n";
+            std::cout << "  --engine=NAME  Execution engine: 'ast' (tree-walk, default) or 'vm' (bytecode)\n";
+            std::cout << "  --gc-pause-ms=MS  Collect the old generation in slices of about MS milliseconds\n";
             std::cout << "  --help, -h     Show this help message\n";
             return 0;
         } else if (arg[0] == '-') {
@@ -246,14 +334,14 @@ int main(int argc, char** argv) {
         }
     }
     
-    volt::Interpreter interpreter;
+    volt::Interpreter interpreter(engine);
     
     if (!scriptPath.empty()) {
         // Run file
-        runFile(scriptPath, interpreter, debugMode);
+        runFile(scriptPath, interpreter, debugMode, dumpOptimized);
     } else {
         // Interactive REPL
-        runPrompt();
+        runPrompt(engine);
     }
     
     return 0;
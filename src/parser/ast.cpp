@@ -3,109 +3,180 @@
 
 namespace volt {
 
+MethodId methodIdFor(std::string_view name) {
+    if (name == "length") return MethodId::Length;
+    if (name == "push") return MethodId::Push;
+    if (name == "pop") return MethodId::Pop;
+    if (name == "reverse") return MethodId::Reverse;
+    if (name == "sum") return MethodId::Sum;
+    if (name == "min") return MethodId::Min;
+    if (name == "max") return MethodId::Max;
+    if (name == "dot") return MethodId::Dot;
+    if (name == "scale") return MethodId::Scale;
+    if (name == "add") return MethodId::Add;
+    if (name == "slice") return MethodId::Slice;
+    if (name == "concat") return MethodId::Concat;
+    if (name == "indexOf") return MethodId::IndexOf;
+    if (name == "includes") return MethodId::Includes;
+    if (name == "join") return MethodId::Join;
+    if (name == "splice") return MethodId::Splice;
+    if (name == "insert") return MethodId::Insert;
+    if (name == "fill") return MethodId::Fill;
+    if (name == "sort") return MethodId::Sort;
+    if (name == "sortBy") return MethodId::SortBy;
+    if (name == "map") return MethodId::Map;
+    if (name == "filter") return MethodId::Filter;
+    if (name == "reduce") return MethodId::Reduce;
+    if (name == "forEach") return MethodId::ForEach;
+    if (name == "find") return MethodId::Find;
+    if (name == "findIndex") return MethodId::FindIndex;
+    if (name == "some") return MethodId::Some;
+    if (name == "every") return MethodId::Every;
+    if (name == "size") return MethodId::Size;
+    if (name == "keys") return MethodId::Keys;
+    if (name == "values") return MethodId::Values;
+    if (name == "has") return MethodId::Has;
+    if (name == "remove") return MethodId::Remove;
+    return MethodId::None;
+}
+
 std::string printAST(Expr* expr) {
-    if (auto* lit = dynamic_cast<LiteralExpr*>(expr)) {
-        switch (lit->type) {
-            case LiteralExpr::Type::Number:
-                return std::to_string(lit->numberValue);
-            case LiteralExpr::Type::String:
-                return "\"" + lit->stringValue + "\"";
-            case LiteralExpr::Type::Bool:
-                return lit->boolValue ? "true" : "false";
-            case LiteralExpr::Type::Nil:
-                return "nil";
+    switch (expr->kind) {
+        case ExprKind::Literal: {
+            auto* lit = static_cast<LiteralExpr*>(expr);
+            switch (lit->type) {
+                case LiteralExpr::Type::Number:
+                    return std::to_string(lit->numberValue);
+                case LiteralExpr::Type::String:
+                    return "\"" + lit->stringValue + "\"";
+                case LiteralExpr::Type::Bool:
+                    return lit->boolValue ? "true" : "false";
+                case LiteralExpr::Type::Nil:
+                    return "nil";
+            }
+            break;
         }
-    }
-    
-    if (auto* var = dynamic_cast<VariableExpr*>(expr)) {
-        return var->name;
-    }
-    
-    if (auto* unary = dynamic_cast<UnaryExpr*>(expr)) {
-        std::ostringstream oss;
-        oss << "(" << unary->op.lexeme << " " << printAST(unary->right.get()) << ")";
-        return oss.str();
-    }
-    
-    if (auto* bin = dynamic_cast<BinaryExpr*>(expr)) {
-        std::ostringstream oss;
-        oss << "(" << bin->op.lexeme << " " 
-            << printAST(bin->left.get()) << " " 
-            << printAST(bin->right.get()) << ")";
-        return oss.str();
-    }
-    
-    if (auto* logical = dynamic_cast<LogicalExpr*>(expr)) {
-        std::ostringstream oss;
-        oss << "(" << logical->op.lexeme << " " 
-            << printAST(logical->left.get()) << " " 
-            << printAST(logical->right.get()) << ")";
-        return oss.str();
-    }
-    
-    if (auto* group = dynamic_cast<GroupingExpr*>(expr)) {
-        return "(group " + printAST(group->expr.get()) + ")";
-    }
-    
-    if (auto* call = dynamic_cast<CallExpr*>(expr)) {
-        std::ostringstream oss;
-        oss << "(call " << printAST(call->callee.get());
-        for (auto& arg : call->arguments) {
-            oss << " " << printAST(arg.get());
+        
+        case ExprKind::Variable:
+            return static_cast<VariableExpr*>(expr)->name;
+        
+        case ExprKind::Unary: {
+            auto* unary = static_cast<UnaryExpr*>(expr);
+            std::ostringstream oss;
+            oss << "(" << unary->op.lexeme << " " << printAST(unary->right.get()) << ")";
+            return oss.str();
         }
-        oss << ")";
-        return oss.str();
-    }
-    
-    if (auto* assign = dynamic_cast<AssignExpr*>(expr)) {
-        return "(= " + assign->name + " " + printAST(assign->value.get()) + ")";
-    }
-    
-    if (auto* compound = dynamic_cast<CompoundAssignExpr*>(expr)) {
-        return "(" + std::string(compound->op.lexeme) + " " + compound->name + " " + printAST(compound->value.get()) + ")";
-    }
-    
-    if (auto* update = dynamic_cast<UpdateExpr*>(expr)) {
-        std::string op = std::string(update->op.lexeme);
-        if (update->prefix) {
-            return "(" + op + " " + update->name + ")";
+        
+        case ExprKind::Binary: {
+            auto* bin = static_cast<BinaryExpr*>(expr);
+            std::ostringstream oss;
+            oss << "(" << bin->op.lexeme << " " 
+                << printAST(bin->left.get()) << " " 
+                << printAST(bin->right.get()) << ")";
+            return oss.str();
         }
-        return "(" + update->name + " " + op + ")";
-    }
-    
-    if (auto* ternary = dynamic_cast<TernaryExpr*>(expr)) {
-        return "(?: " + printAST(ternary->condition.get()) + " " + 
-               printAST(ternary->thenBranch.get()) + " " + 
-               printAST(ternary->elseBranch.get()) + ")";
-    }
-    
-    // ========================================
-    // ARRAY EXPRESSIONS - NEW!
-    // ========================================
-    
-    if (auto* array = dynamic_cast<ArrayExpr*>(expr)) {
-        std::ostringstream oss;
-        oss << "[";
-        for (size_t i = 0; i < array->elements.size(); i++) {
-            if (i > 0) oss << ", ";
-            oss << printAST(array->elements[i].get());
+        
+        case ExprKind::Logical: {
+            auto* logical = static_cast<LogicalExpr*>(expr);
+            std::ostringstream oss;
+            oss << "(" << logical->op.lexeme << " " 
+                << printAST(logical->left.get()) << " " 
+                << printAST(logical->right.get()) << ")";
+            return oss.str();
         }
-        oss << "]";
-        return oss.str();
-    }
-    
-    if (auto* index = dynamic_cast<IndexExpr*>(expr)) {
-        return printAST(index->object.get()) + "[" + printAST(index->index.get()) + "]";
-    }
-    
-    if (auto* indexAssign = dynamic_cast<IndexAssignExpr*>(expr)) {
-        return "([]= " + printAST(indexAssign->object.get()) + " " + 
-               printAST(indexAssign->index.get()) + " " + 
-               printAST(indexAssign->value.get()) + ")";
-    }
-    
-    if (auto* member = dynamic_cast<MemberExpr*>(expr)) {
-        return printAST(member->object.get()) + "." + member->member;
+        
+        case ExprKind::Grouping:
+            return "(group " + printAST(static_cast<GroupingExpr*>(expr)->expr.get()) + ")";
+        
+        case ExprKind::Call: {
+            auto* call = static_cast<CallExpr*>(expr);
+            std::ostringstream oss;
+            oss << "(call " << printAST(call->callee.get());
+            for (auto& arg : call->arguments) {
+                oss << " " << printAST(arg.get());
+            }
+            oss << ")";
+            return oss.str();
+        }
+        
+        case ExprKind::Assign: {
+            auto* assign = static_cast<AssignExpr*>(expr);
+            return "(= " + assign->name + " " + printAST(assign->value.get()) + ")";
+        }
+        
+        case ExprKind::CompoundAssign: {
+            auto* compound = static_cast<CompoundAssignExpr*>(expr);
+            return "(" + std::string(compound->op.lexeme) + " " + compound->name + " " + printAST(compound->value.get()) + ")";
+        }
+        
+        case ExprKind::Update: {
+            auto* update = static_cast<UpdateExpr*>(expr);
+            std::string op = std::string(update->op.lexeme);
+            if (update->prefix) {
+                return "(" + op + " " + update->name + ")";
+            }
+            return "(" + update->name + " " + op + ")";
+        }
+        
+        case ExprKind::Ternary: {
+            auto* ternary = static_cast<TernaryExpr*>(expr);
+            return "(?: " + printAST(ternary->condition.get()) + " " + 
+                   printAST(ternary->thenBranch.get()) + " " + 
+                   printAST(ternary->elseBranch.get()) + ")";
+        }
+        
+        // ========================================
+        // ARRAY EXPRESSIONS - NEW!
+        // ========================================
+        
+        case ExprKind::Array: {
+            auto* array = static_cast<ArrayExpr*>(expr);
+            std::ostringstream oss;
+            oss << "[";
+            for (size_t i = 0; i < array->elements.size(); i++) {
+                if (i > 0) oss << ", ";
+                oss << printAST(array->elements[i].get());
+            }
+            oss << "]";
+            return oss.str();
+        }
+        
+        case ExprKind::Index: {
+            auto* index = static_cast<IndexExpr*>(expr);
+            return printAST(index->object.get()) + "[" + printAST(index->index.get()) + "]";
+        }
+        
+        case ExprKind::IndexAssign: {
+            auto* indexAssign = static_cast<IndexAssignExpr*>(expr);
+            return "([]= " + printAST(indexAssign->object.get()) + " " + 
+                   printAST(indexAssign->index.get()) + " " + 
+                   printAST(indexAssign->value.get()) + ")";
+        }
+        
+        case ExprKind::Member: {
+            auto* member = static_cast<MemberExpr*>(expr);
+            return printAST(member->object.get()) + "." + member->member;
+        }
+        
+        case ExprKind::MemberAssign: {
+            auto* assign = static_cast<MemberAssignExpr*>(expr);
+            return "(.= " + printAST(assign->object.get()) + " " + assign->member + " " +
+                   printAST(assign->value.get()) + ")";
+        }
+        
+        case ExprKind::MethodCall: {
+            auto* call = static_cast<MethodCallExpr*>(expr);
+            std::ostringstream oss;
+            oss << "(call " << printAST(call->object.get()) << "." << call->member;
+            for (auto& arg : call->arguments) {
+                oss << " " << printAST(arg.get());
+            }
+            oss << ")";
+            return oss.str();
+        }
+        
+        case ExprKind::HashMap:
+            break;
     }
     
     return "?";
@@ -1,8 +1,13 @@
 #pragma once
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 #include "token.h"
+#include "value.h"
+#include "environment.h"
+#include "hashmap.h"
 
 namespace volt {
 
@@ -10,10 +15,120 @@ namespace volt {
 struct Expr;
 using ExprPtr = std::unique_ptr<Expr>;
 
+// Concrete node type, so consumers can switch instead of dynamic_cast
+enum class ExprKind : uint8_t {
+    Literal,
+    Variable,
+    Unary,
+    Binary,
+    Logical,
+    Grouping,
+    Call,
+    Assign,
+    CompoundAssign,
+    Update,
+    Ternary,
+    Array,
+    Index,
+    IndexAssign,
+    HashMap,
+    Member,
+    MemberAssign,
+    MethodCall
+};
+
+// Built-in members of arrays and hash maps, resolved from the name once
+// at parse time so evaluation switches on an ID instead of comparing
+// strings. None means the name isn't a built-in member.
+enum class MethodId : uint8_t {
+    None,
+    Length,   // array.length
+    Push,     // array.push(x)
+    Pop,      // array.pop()
+    Reverse,  // array.reverse()
+    Sum,      // array.sum()
+    Min,      // array.min()
+    Max,      // array.max()
+    Dot,      // array.dot(other)
+    Scale,    // array.scale(k)
+    Add,      // array.add(other)
+    Slice,    // array.slice(start, end)
+    Concat,   // array.concat(other)
+    IndexOf,  // array.indexOf(x)
+    Includes, // array.includes(x)
+    Join,     // array.join(separator)
+    Splice,   // array.splice(start, count)
+    Insert,   // array.insert(index, x)
+    Fill,     // array.fill(x)
+    Sort,     // array.sort() / array.sort(cmp)
+    SortBy,   // array.sortBy(key)
+    Map,      // array.map(fn)
+    Filter,   // array.filter(fn)
+    Reduce,   // array.reduce(fn, initial)
+    ForEach,  // array.forEach(fn)
+    Find,     // array.find(fn)
+    FindIndex, // array.findIndex(fn)
+    Some,     // array.some(fn)
+    Every,    // array.every(fn)
+    Size,     // map.size
+    Keys,     // map.keys()
+    Values,   // map.values()
+    Has,      // map.has(key)
+    Remove    // map.remove(key)
+};
+
+MethodId methodIdFor(std::string_view name);
+
+// Where a variable reference lives, filled in by the Resolver:
+// 'depth' scopes up from the current one, at index 'slot' there, or the
+// running function's capture 'capture' (see FnStmt::captures).
+// Otherwise it is a global, looked up by name through 'cache'.
+struct Binding {
+    int depth = -1;
+    int slot = -1;
+    int capture = -1;
+    GlobalCache cache;
+    bool isLocal() const { return depth >= 0; }
+    bool isCapture() const { return capture >= 0; }
+    bool isGlobal() const { return depth < 0 && capture < 0; }
+};
+
+// Type feedback for self-specializing ("quickened") nodes. A node starts
+// Cold and watches the operand types of its first evaluations; once they
+// agree kWarmup times in a row it commits to a fast path for those types,
+// guarded by a cheap type check. A guard failure drops it to Generic for
+// good, so a site that sees mixed types never flip-flops.
+enum class Quickened : uint8_t {
+    Cold,        // Still observing
+    Numbers,     // number op number
+    Strings,     // string + string
+    ArrayIndex,  // array[number]
+    Generic      // Mixed types: always the full path
+};
+
+struct QuickenState {
+    static constexpr uint8_t kWarmup = 2;
+
+    Quickened mode = Quickened::Cold;
+    Quickened candidate = Quickened::Cold;
+    uint8_t observed = 0;
+
+    void observe(Quickened seen) {
+        if (seen == Quickened::Generic || (observed > 0 && seen != candidate)) {
+            mode = Quickened::Generic;
+            return;
+        }
+        candidate = seen;
+        if (++observed >= kWarmup) mode = seen;
+    }
+    void deoptimize() { mode = Quickened::Generic; }
+};
+
 // Base expression node
 struct Expr {
+    const ExprKind kind;
     Token token; // Representative token for error reporting
-    explicit Expr(Token tok) : token(tok) {}
+    Expr(ExprKind k, Token tok) : kind(k), token(tok) {}
     virtual ~Expr() = default;
 };
 
@@ -25,19 +140,24 @@ struct LiteralExpr : Expr {
     double numberValue;
     std::string stringValue;
     bool boolValue;
+    Value value;  // The runtime value, built once so evaluating never allocates
     
     LiteralExpr(Token tok, double value)
-        : Expr(tok), type(Type::Number), numberValue(value), boolValue(false) {}
+        : Expr(ExprKind::Literal, tok), type(Type::Number), numberValue(value), boolValue(false),
+          value(value) {}
     
     LiteralExpr(Token tok, const std::string& value)
-        : Expr(tok), type(Type::String), numberValue(0.0), stringValue(value), boolValue(false) {}
+        : Expr(ExprKind::Literal, tok), type(Type::String), numberValue(0.0), stringValue(value), boolValue(false),
+          value(StringObject::fromLiteral(value)) {}
     
     LiteralExpr(Token tok, bool value)
-        : Expr(tok), type(Type::Bool), numberValue(0.0), boolValue(value) {}
+        : Expr(ExprKind::Literal, tok), type(Type::Bool), numberValue(0.0), boolValue(value),
+          value(value) {}
     
     static ExprPtr nil(Token tok) {
         auto expr = std::make_unique<LiteralExpr>(tok, 0.0);
         expr->type = Type::Nil;
+        expr->value = nullptr;
         return expr;
     }
 };
@@ -45,7 +165,8 @@ struct LiteralExpr : Expr {
 // Variable: x, myVar
 struct VariableExpr : Expr {
     std::string name;
-    VariableExpr(Token tok, std::string n) : Expr(tok), name(std::move(n)) {}
+    Binding binding;
+    VariableExpr(Token tok, std::string n) : Expr(ExprKind::Variable, tok), name(std::move(n)) {}
 };
 
 // Unary: -x, !flag
@@ -53,7 +174,7 @@ struct UnaryExpr : Expr {
     Token op;
     ExprPtr right;
     UnaryExpr(Token o, ExprPtr r)
-        : Expr(o), op(o), right(std::move(r)) {}
+        : Expr(ExprKind::Unary, o), op(o), right(std::move(r)) {}
 };
 
 // Binary: 1 + 2, x * y, a == b
@@ -61,8 +182,9 @@ struct BinaryExpr : Expr {
     ExprPtr left;
     Token op;
     ExprPtr right;
+    QuickenState quick;
     BinaryExpr(ExprPtr l, Token o, ExprPtr r)
-        : Expr(o), left(std::move(l)), op(o), right(std::move(r)) {}
+        : Expr(ExprKind::Binary, o), left(std::move(l)), op(o), right(std::move(r)) {}
 };
 
 // Logical: a && b, x || y
@@ -71,13 +193,13 @@ struct LogicalExpr : Expr {
     Token op;
     ExprPtr right;
     LogicalExpr(ExprPtr l, Token o, ExprPtr r)
-        : Expr(o), left(std::move(l)), op(o), right(std::move(r)) {}
+        : Expr(ExprKind::Logical, o), left(std::move(l)), op(o), right(std::move(r)) {}
 };
 
 // Grouping: (expr)
 struct GroupingExpr : Expr {
     ExprPtr expr;
-    GroupingExpr(Token tok, ExprPtr e) : Expr(tok), expr(std::move(e)) {}
+    GroupingExpr(Token tok, ExprPtr e) : Expr(ExprKind::Grouping, tok), expr(std::move(e)) {}
 };
 
 // Call: foo(a, b, c)
@@ -85,33 +207,37 @@ struct CallExpr : Expr {
     ExprPtr callee;
     std::vector<ExprPtr> arguments;
     CallExpr(Token paren, ExprPtr c, std::vector<ExprPtr> args)
-        : Expr(paren), callee(std::move(c)), arguments(std::move(args)) {}
+        : Expr(ExprKind::Call, paren), callee(std::move(c)), arguments(std::move(args)) {}
 };
 
 // Assignment: x = 10
 struct AssignExpr : Expr {
     std::string name;
+    Binding binding;
     ExprPtr value;
     AssignExpr(Token nameTok, ExprPtr v)
-        : Expr(nameTok), name(std::string(nameTok.lexeme)), value(std::move(v)) {}
+        : Expr(ExprKind::Assign, nameTok), name(std::string(nameTok.lexeme)), value(std::move(v)) {}
 };
 
 // Compound Assignment: x += 10, x -= 5, etc.
 struct CompoundAssignExpr : Expr {
     std::string name;
+    Binding binding;
     Token op;
     ExprPtr value;
+    QuickenState quick;
     CompoundAssignExpr(Token nameTok, Token o, ExprPtr v)
-        : Expr(o), name(std::string(nameTok.lexeme)), op(o), value(std::move(v)) {}
+        : Expr(ExprKind::CompoundAssign, o), name(std::string(nameTok.lexeme)), op(o), value(std::move(v)) {}
 };
 
 // Update Expression: ++x, x++, --x, x--
 struct UpdateExpr : Expr {
     std::string name;
+    Binding binding;
     Token op;
     bool prefix; // true for ++x, false for x++
     UpdateExpr(Token nameTok, Token o, bool pre)
-        : Expr(o), name(std::string(nameTok.lexeme)), op(o), prefix(pre) {}
+        : Expr(ExprKind::Update, o), name(std::string(nameTok.lexeme)), op(o), prefix(pre) {}
 };
 
 // Ternary: condition ? thenExpr : elseExpr
@@ -120,7 +246,7 @@ struct TernaryExpr : Expr {
     ExprPtr thenBranch;
     ExprPtr elseBranch;
     TernaryExpr(Token quest, ExprPtr cond, ExprPtr then_, ExprPtr else_)
-        : Expr(quest),
+        : Expr(ExprKind::Ternary, quest),
           condition(std::move(cond)),
           thenBranch(std::move(then_)),
           elseBranch(std::move(else_)) {}
@@ -133,17 +259,20 @@ struct TernaryExpr : Expr {
 // Array Literal: [1, 2, 3, "hello"]
 struct ArrayExpr : Expr {
     std::vector<ExprPtr> elements;
+    Value constant;  // Set by the Optimizer when every element is a literal:
+                     // a prototype array, copied on each evaluation
     ArrayExpr(Token bracket, std::vector<ExprPtr> elems)
-        : Expr(bracket), elements(std::move(elems)) {}
+        : Expr(ExprKind::Array, bracket), elements(std::move(elems)) {}
 };
 
 // Array Index Access: arr[0], matrix[i][j]
 struct IndexExpr : Expr {
     ExprPtr object;  // The array being indexed
     ExprPtr index;   // The index expression
+    QuickenState quick;
     
     IndexExpr(Token bracket, ExprPtr obj, ExprPtr idx)
-        : Expr(bracket), object(std::move(obj)), index(std::move(idx)) {}
+        : Expr(ExprKind::Index, bracket), object(std::move(obj)), index(std::move(idx)) {}
 };
 
 // Array Index Assignment: arr[0] = 42
@@ -153,7 +282,7 @@ struct IndexAssignExpr : Expr {
     ExprPtr value;   // The value to assign
     
     IndexAssignExpr(Token bracket, ExprPtr obj, ExprPtr idx, ExprPtr val)
-        : Expr(bracket), object(std::move(obj)), index(std::move(idx)), value(std::move(val)) {}
+        : Expr(ExprKind::IndexAssign, bracket), object(std::move(obj)), index(std::move(idx)), value(std::move(val)) {}
 };
 
 // ========================================
@@ -163,17 +292,51 @@ struct IndexAssignExpr : Expr {
 // Hash Map Literal: {"key": "value", "age": 25}
 struct HashMapExpr : Expr {
     std::vector<std::pair<ExprPtr, ExprPtr>> keyValuePairs;  // Key-value pairs
+    Value constant;  // Prototype map when every key and value is a literal
+    Ref<Shape> layout;  // Shared shape of the result when every key is a literal
     HashMapExpr(Token brace, std::vector<std::pair<ExprPtr, ExprPtr>> pairs)
-        : Expr(brace), keyValuePairs(std::move(pairs)) {}
+        : Expr(ExprKind::HashMap, brace), keyValuePairs(std::move(pairs)) {}
 };
 
 // Member Access: array.length, array.push
 struct MemberExpr : Expr {
     ExprPtr object;      // The object (array, etc.)
     std::string member;  // The member name (length, push, etc.)
+    MethodId method;     // Pre-resolved built-in member
+    FieldCache cache;    // Hash map fields: this site's inline cache
     
     MemberExpr(Token name, ExprPtr obj, std::string mem)
-        : Expr(name), object(std::move(obj)), member(std::move(mem)) {}
+        : Expr(ExprKind::Member, name), object(std::move(obj)), member(std::move(mem)),
+          method(methodIdFor(member)) {}
+};
+
+// Field Assignment: record.balance = 100
+// Only hash maps have fields; the token is the member name.
+struct MemberAssignExpr : Expr {
+    ExprPtr object;
+    std::string member;
+    MethodId method;  // Built-in names can't be assigned
+    ExprPtr value;
+    FieldCache cache;
+    
+    MemberAssignExpr(Token name, ExprPtr obj, std::string mem, ExprPtr val)
+        : Expr(ExprKind::MemberAssign, name), object(std::move(obj)), member(std::move(mem)),
+          method(methodIdFor(member)), value(std::move(val)) {}
+};
+
+// Method Call: array.push(x), map.has(key)
+// A member access that is called right away, so no bound method object
+// has to be created. The token is the member name.
+struct MethodCallExpr : Expr {
+    ExprPtr object;
+    std::string member;
+    MethodId method;
+    std::vector<ExprPtr> arguments;
+    FieldCache cache;  // record.fn(x) on a hash map reads the field first
+    
+    MethodCallExpr(Token name, ExprPtr obj, std::string mem, std::vector<ExprPtr> args)
+        : Expr(ExprKind::MethodCall, name), object(std::move(obj)), member(std::move(mem)),
+          method(methodIdFor(member)), arguments(std::move(args)) {}
 };
 
 // AST Pretty Printer
@@ -246,12 +246,13 @@ ExprPtr Parser::assignment() {
         ExprPtr value = assignment();
         
         // Variable assignment: x = 10
-        if (auto* var = dynamic_cast<VariableExpr*>(expr.get())) {
-            return std::make_unique<AssignExpr>(var->token, std::move(value));
+        if (expr->kind == ExprKind::Variable) {
+            return std::make_unique<AssignExpr>(expr->token, std::move(value));
         }
         
         // Array index assignment: arr[0] = 42  // NEW!
-        if (auto* index = dynamic_cast<IndexExpr*>(expr.get())) {
+        if (expr->kind == ExprKind::Index) {
+            auto* index = static_cast<IndexExpr*>(expr.get());
             return std::make_unique<IndexAssignExpr>(
                 index->token,
                 std::move(index->object),
@@ -260,6 +261,17 @@ ExprPtr Parser::assignment() {
             );
         }
         
+        // Field assignment: account.balance = 100
+        if (expr->kind == ExprKind::Member) {
+            auto* member = static_cast<MemberExpr*>(expr.get());
+            return std::make_unique<MemberAssignExpr>(
+                member->token,
+                std::move(member->object),
+                std::move(member->member),
+                std::move(value)
+            );
+        }
+        
         error("Invalid assignment target");
     }
     
@@ -269,8 +281,8 @@ ExprPtr Parser::assignment() {
         Token op = previous();
         ExprPtr value = assignment();
         
-        if (auto* var = dynamic_cast<VariableExpr*>(expr.get())) {
-            return std::make_unique<CompoundAssignExpr>(var->token, op, std::move(value));
+        if (expr->kind == ExprKind::Variable) {
+            return std::make_unique<CompoundAssignExpr>(expr->token, op, std::move(value));
         }
         
         error("Invalid compound assignment target");
@@ -396,8 +408,8 @@ ExprPtr Parser::postfix() {
     // Postfix increment/decrement: x++, x--
     if (match({TokenType::PlusPlus, TokenType::MinusMinus})) {
         Token op = previous();
-        if (auto* var = dynamic_cast<VariableExpr*>(expr.get())) {
-            return std::make_unique<UpdateExpr>(var->token, op, false);
+        if (expr->kind == ExprKind::Variable) {
+            return std::make_unique<UpdateExpr>(expr->token, op, false);
         }
         error("Invalid postfix operand");
     }
@@ -439,6 +451,13 @@ ExprPtr Parser::finishCall(ExprPtr callee) {
     
     consume(TokenType::RightParen, "Expected ')' after arguments");
     
+    // obj.method(args) calls the member directly
+    if (callee->kind == ExprKind::Member) {
+        auto* member = static_cast<MemberExpr*>(callee.get());
+        return std::make_unique<MethodCallExpr>(member->token, std::move(member->object),
+                                                std::move(member->member), std::move(arguments));
+    }
+    
     return std::make_unique<CallExpr>(paren, std::move(callee), std::move(arguments));
 }
 
@@ -10,10 +10,27 @@ namespace volt {
 struct Stmt;
 using StmtPtr = std::unique_ptr<Stmt>;
 
+// Concrete statement type, mirrors ExprKind
+enum class StmtKind : uint8_t {
+    Expr,
+    Print,
+    Let,
+    Block,
+    If,
+    While,
+    RunUntil,
+    For,
+    Fn,
+    Return,
+    Break,
+    Continue
+};
+
 // Base statement node
 struct Stmt {
+    const StmtKind kind;
     Token token; // Representative token for errors
-    explicit Stmt(Token tok) : token(tok) {}
+    Stmt(StmtKind k, Token tok) : kind(k), token(tok) {}
     virtual ~Stmt() = default;
 };
 
@@ -21,31 +38,33 @@ struct Stmt {
 struct ExprStmt : Stmt {
     ExprPtr expr;
     
-    ExprStmt(Token tok, ExprPtr e) : Stmt(tok), expr(std::move(e)) {}
+    ExprStmt(Token tok, ExprPtr e) : Stmt(StmtKind::Expr, tok), expr(std::move(e)) {}
 };
 
 // Print statement: print expr;
 struct PrintStmt : Stmt {
     ExprPtr expr;
     
-    PrintStmt(Token tok, ExprPtr e) : Stmt(tok), expr(std::move(e)) {}
+    PrintStmt(Token tok, ExprPtr e) : Stmt(StmtKind::Print, tok), expr(std::move(e)) {}
 };
 
 // Variable declaration: let name = expr;
 struct LetStmt : Stmt {
     std::string name;
     ExprPtr initializer;
+    int slot = -1;  // Resolved slot in the enclosing scope (-1: global)
     
     LetStmt(Token nameTok, ExprPtr init)
-        : Stmt(nameTok), name(std::string(nameTok.lexeme)), initializer(std::move(init)) {}
+        : Stmt(StmtKind::Let, nameTok), name(std::string(nameTok.lexeme)), initializer(std::move(init)) {}
 };
 
 // Block statement: { stmts... }
 struct BlockStmt : Stmt {
     std::vector<StmtPtr> statements;
+    ScopeLayout layout;  // This block's variables
     
     BlockStmt(Token brace, std::vector<StmtPtr> stmts)
-        : Stmt(brace), statements(std::move(stmts)) {}
+        : Stmt(StmtKind::Block, brace), statements(std::move(stmts)) {}
 };
 
 // If statement: if (condition) thenBranch [else elseBranch]
@@ -55,7 +74,7 @@ struct IfStmt : Stmt {
     StmtPtr elseBranch;  // can be null
     
     IfStmt(Token ifTok, ExprPtr cond, StmtPtr thenB, StmtPtr elseB = nullptr)
-        : Stmt(ifTok), condition(std::move(cond)), 
+        : Stmt(StmtKind::If, ifTok), condition(std::move(cond)), 
           thenBranch(std::move(thenB)),
           elseBranch(std::move(elseB)) {}
 };
@@ -66,7 +85,7 @@ struct WhileStmt : Stmt {
     StmtPtr body;
     
     WhileStmt(Token whileTok, ExprPtr cond, StmtPtr b)
-        : Stmt(whileTok), condition(std::move(cond)), body(std::move(b)) {}
+        : Stmt(StmtKind::While, whileTok), condition(std::move(cond)), body(std::move(b)) {}
 };
 
 // Run-Until statement: run { body } until (condition);
@@ -76,7 +95,18 @@ struct RunUntilStmt : Stmt {
     ExprPtr condition;
     
     RunUntilStmt(Token runTok, StmtPtr b, ExprPtr cond)
-        : Stmt(runTok), body(std::move(b)), condition(std::move(cond)) {}
+        : Stmt(StmtKind::RunUntil, runTok), body(std::move(b)), condition(std::move(cond)) {}
+};
+
+// A for-loop of the form for (let i = a; i < b; i++) whose counter
+// nothing but the increment assigns, found by the Resolver. The
+// interpreter keeps such a counter in a plain double. '<' may also be
+// <=, > or >=; the increment may be i++, i--, i += k, i -= k, i = i + k
+// or i = i - k for a number literal k.
+struct CountedLoop {
+    int slot = -1;  // The counter's slot in the loop scope (-1: not counted)
+    TokenType compare = TokenType::Less;
+    double step = 0;
 };
 
 // For statement: for (init; condition; increment) body
@@ -85,25 +115,42 @@ struct ForStmt : Stmt {
     ExprPtr condition;     // can be null
     ExprPtr increment;     // can be null
     StmtPtr body;
+    ScopeLayout layout;  // Variables of the loop scope
+    CountedLoop counted;
     
     ForStmt(Token forTok, StmtPtr init, ExprPtr cond, ExprPtr incr, StmtPtr b)
-        : Stmt(forTok),
+        : Stmt(StmtKind::For, forTok),
           initializer(std::move(init)),
           condition(std::move(cond)),
           increment(std::move(incr)),
           body(std::move(b)) {}
 };
 
+// A variable of an enclosing function that a function uses, found by the
+// Resolver. When the closure is created it takes that variable's cell:
+// from the scope 'depth' levels up from the declaration, or (when the
+// variable is further out) from the enclosing function's own capture
+// 'index'.
+struct Capture {
+    bool local = true;
+    int depth = 0;
+    int slot = 0;
+    int index = 0;
+};
+
 // Function declaration: fn name(params...) { body }
 struct FnStmt : Stmt {
     std::string name;
     std::vector<std::string> parameters;
     std::vector<StmtPtr> body;
+    int slot = -1;       // Resolved slot of the function's name (-1: global)
+    ScopeLayout layout;  // Parameters, then locals of one call
+    std::vector<Capture> captures;  // Variables of enclosing functions it uses
     
     FnStmt(Token nameTok, 
            std::vector<std::string> params,
            std::vector<StmtPtr> b)
-        : Stmt(nameTok),
+        : Stmt(StmtKind::Fn, nameTok),
           name(std::string(nameTok.lexeme)), 
           parameters(std::move(params)),
           body(std::move(b)) {}
@@ -112,18 +159,19 @@ struct FnStmt : Stmt {
 // Return statement: return expr;
 struct ReturnStmt : Stmt {
     ExprPtr value;  // can be null (just "return;")
+    bool tailCall = false;  // 'return f(...)' inside a function (set by the Resolver)
     
-    ReturnStmt(Token returnTok, ExprPtr v) : Stmt(returnTok), value(std::move(v)) {}
+    ReturnStmt(Token returnTok, ExprPtr v) : Stmt(StmtKind::Return, returnTok), value(std::move(v)) {}
 };
 
 // Break statement: break;
 struct BreakStmt : Stmt {
-    explicit BreakStmt(Token tok) : Stmt(tok) {}
+    explicit BreakStmt(Token tok) : Stmt(StmtKind::Break, tok) {}
 };
 
 // Continue statement: continue;
 struct ContinueStmt : Stmt {
-    explicit ContinueStmt(Token tok) : Stmt(tok) {}
+    explicit ContinueStmt(Token tok) : Stmt(StmtKind::Continue, tok) {}
 };
 
 } // namespace volt
@@ -0,0 +1,215 @@
+#include "chunk.h"
+#include <iomanip>
+#include <sstream>
+
+namespace volt {
+
+void Chunk::write(uint8_t byte, uint32_t token) {
+    code.push_back(byte);
+    tokenIndex.push_back(token);
+}
+
+size_t Chunk::addConstant(Value value) {
+    constants.push_back(std::move(value));
+    return constants.size() - 1;
+}
+
+size_t Chunk::addName(const std::string& name) {
+    // Names repeat a lot (every use of a global), so share the entries
+    for (size_t i = 0; i < names.size(); i++) {
+        if (names[i] == name) return i;
+    }
+    names.push_back(name);
+    globalCaches.emplace_back();
+    return names.size() - 1;
+}
+
+size_t Chunk::addFieldCache() {
+    fieldCaches.emplace_back();
+    return fieldCaches.size() - 1;
+}
+
+size_t Chunk::addMapLayout() {
+    mapLayouts.emplace_back();
+    return mapLayouts.size() - 1;
+}
+
+size_t Chunk::addFunction(std::shared_ptr<FunctionProto> function) {
+    functions.push_back(std::move(function));
+    return functions.size() - 1;
+}
+
+uint32_t Chunk::addToken(const Token& token) {
+    // Consecutive instructions usually share a token
+    if (!tokens.empty()) {
+        const Token& last = tokens.back();
+        if (last.line == token.line && last.column == token.column && last.type == token.type) {
+            return static_cast<uint32_t>(tokens.size() - 1);
+        }
+    }
+    tokens.push_back(token);
+    return static_cast<uint32_t>(tokens.size() - 1);
+}
+
+const char* opCodeName(OpCode op) {
+    switch (op) {
+        case OpCode::Constant: return "CONSTANT";
+        case OpCode::Nil: return "NIL";
+        case OpCode::True: return "TRUE";
+        case OpCode::False: return "FALSE";
+        case OpCode::Pop: return "POP";
+        case OpCode::Dup: return "DUP";
+        case OpCode::GetLocal: return "GET_LOCAL";
+        case OpCode::SetLocal: return "SET_LOCAL";
+        case OpCode::GetGlobal: return "GET_GLOBAL";
+        case OpCode::SetGlobal: return "SET_GLOBAL";
+        case OpCode::DefineGlobal: return "DEFINE_GLOBAL";
+        case OpCode::GetUpvalue: return "GET_UPVALUE";
+        case OpCode::SetUpvalue: return "SET_UPVALUE";
+        case OpCode::Add: return "ADD";
+        case OpCode::Subtract: return "SUBTRACT";
+        case OpCode::Multiply: return "MULTIPLY";
+        case OpCode::Divide: return "DIVIDE";
+        case OpCode::Modulo: return "MODULO";
+        case OpCode::Greater: return "GREATER";
+        case OpCode::GreaterEqual: return "GREATER_EQUAL";
+        case OpCode::Less: return "LESS";
+        case OpCode::LessEqual: return "LESS_EQUAL";
+        case OpCode::Equal: return "EQUAL";
+        case OpCode::NotEqual: return "NOT_EQUAL";
+        case OpCode::Negate: return "NEGATE";
+        case OpCode::Not: return "NOT";
+        case OpCode::Compound: return "COMPOUND";
+        case OpCode::Increment: return "INCREMENT";
+        case OpCode::Decrement: return "DECREMENT";
+        case OpCode::Jump: return "JUMP";
+        case OpCode::JumpIfFalse: return "JUMP_IF_FALSE";
+        case OpCode::JumpIfTrue: return "JUMP_IF_TRUE";
+        case OpCode::Loop: return "LOOP";
+        case OpCode::Call: return "CALL";
+        case OpCode::TailCall: return "TAIL_CALL";
+        case OpCode::Closure: return "CLOSURE";
+        case OpCode::CloseUpvalue: return "CLOSE_UPVALUE";
+        case OpCode::Return: return "RETURN";
+        case OpCode::BuildArray: return "BUILD_ARRAY";
+        case OpCode::BuildMap: return "BUILD_MAP";
+        case OpCode::BuildRecord: return "BUILD_RECORD";
+        case OpCode::GetIndex: return "GET_INDEX";
+        case OpCode::SetIndex: return "SET_INDEX";
+        case OpCode::GetMember: return "GET_MEMBER";
+        case OpCode::SetMember: return "SET_MEMBER";
+        case OpCode::Invoke: return "INVOKE";
+        case OpCode::Print: return "PRINT";
+    }
+    return "UNKNOWN";
+}
+
+namespace {
+
+uint16_t readShort(const Chunk& chunk, size_t offset) {
+    return static_cast<uint16_t>((chunk.code[offset] << 8) | chunk.code[offset + 1]);
+}
+
+} // anonymous namespace
+
+std::string disassemble(const FunctionProto& function) {
+    std::ostringstream oss;
+    const Chunk& chunk = function.chunk;
+    oss << "== " << function.name << " (arity " << function.arity << ") ==\n";
+
+    size_t offset = 0;
+    while (offset < chunk.code.size()) {
+        OpCode op = static_cast<OpCode>(chunk.code[offset]);
+        oss << std::setw(4) << std::setfill('0') << offset << std::setfill(' ')
+            << "  [line " << std::setw(3) << chunk.tokenAt(offset).line << "]  "
+            << std::left << std::setw(14) << opCodeName(op) << std::right;
+
+        switch (op) {
+            case OpCode::Constant: {
+                uint16_t index = readShort(chunk, offset + 1);
+                oss << " " << index << " (" << valueToString(chunk.constants[index]) << ")";
+                offset += 3;
+                break;
+            }
+            case OpCode::GetGlobal:
+            case OpCode::SetGlobal:
+            case OpCode::DefineGlobal: {
+                uint16_t index = readShort(chunk, offset + 1);
+                oss << " " << index << " '" << chunk.names[index] << "'";
+                offset += 3;
+                break;
+            }
+            case OpCode::BuildRecord:
+                oss << " " << readShort(chunk, offset + 1) << " (layout "
+                    << readShort(chunk, offset + 3) << ")";
+                offset += 5;
+                break;
+            case OpCode::GetMember:
+            case OpCode::SetMember: {
+                uint16_t index = readShort(chunk, offset + 1);
+                oss << " " << index << " '" << chunk.names[index] << "'";
+                offset += 6;
+                break;
+            }
+            case OpCode::Invoke: {
+                uint16_t index = readShort(chunk, offset + 1);
+                oss << " " << index << " '" << chunk.names[index] << "' ("
+                    << static_cast<int>(chunk.code[offset + 4]) << " args)";
+                offset += 7;
+                break;
+            }
+            case OpCode::GetLocal:
+            case OpCode::SetLocal:
+            case OpCode::GetUpvalue:
+            case OpCode::SetUpvalue:
+            case OpCode::BuildArray:
+            case OpCode::BuildMap:
+                oss << " " << readShort(chunk, offset + 1);
+                offset += 3;
+                break;
+            case OpCode::Jump:
+            case OpCode::JumpIfFalse:
+            case OpCode::JumpIfTrue: {
+                uint16_t jump = readShort(chunk, offset + 1);
+                oss << " -> " << offset + 3 + jump;
+                offset += 3;
+                break;
+            }
+            case OpCode::Loop: {
+                uint16_t jump = readShort(chunk, offset + 1);
+                oss << " -> " << offset + 3 - jump;
+                offset += 3;
+                break;
+            }
+            case OpCode::Call:
+            case OpCode::TailCall:
+                oss << " " << static_cast<int>(chunk.code[offset + 1]);
+                offset += 2;
+                break;
+            case OpCode::Closure: {
+                uint16_t index = readShort(chunk, offset + 1);
+                const FunctionProto& nested = *chunk.functions[index];
+                oss << " <fn " << nested.name << ">";
+                offset += 3;
+                for (int i = 0; i < nested.upvalueCount; i++) {
+                    bool isLocal = chunk.code[offset] != 0;
+                    oss << (i == 0 ? " " : ", ") << (isLocal ? "local " : "upvalue ")
+                        << readShort(chunk, offset + 1);
+                    offset += 3;
+                }
+                break;
+            }
+            default:
+                offset += 1;
+                break;
+        }
+        oss << "\n";
+    }
+
+    for (const auto& nested : chunk.functions) {
+        oss << "\n" << disassemble(*nested);
+    }
+    return oss.str();
+}
+
+} // namespace volt
@@ -0,0 +1,138 @@
+#pragma once
+#include "value.h"
+#include "environment.h"
+#include "hashmap.h"
+#include "token.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace volt {
+
+struct FunctionProto;
+
+/**
+ * OpCode - One instruction of the VoltScript virtual machine
+ *
+ * The VM is stack based: operands are popped from the value stack and
+ * results are pushed back. Operands that live in the instruction stream
+ * are noted next to each opcode (u8 = 1 byte, u16 = 2 bytes, big-endian).
+ */
+enum class OpCode : uint8_t {
+    // Constants and literals
+    Constant,       // u16 constant index
+    Nil,
+    True,
+    False,
+
+    // Stack manipulation
+    Pop,
+    Dup,
+
+    // Variables
+    GetLocal,       // u16 slot (relative to the frame base)
+    SetLocal,       // u16 slot
+    GetGlobal,      // u16 name index
+    SetGlobal,      // u16 name index (assigns, or defines when missing)
+    DefineGlobal,   // u16 name index
+    GetUpvalue,     // u16 upvalue index
+    SetUpvalue,     // u16 upvalue index
+
+    // Operators
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    Modulo,
+    Greater,
+    GreaterEqual,
+    Less,
+    LessEqual,
+    Equal,
+    NotEqual,
+    Negate,
+    Not,
+    Compound,       // compound assignment operator (+=, -=, *=, /=)
+    Increment,      // ++ (operand must be a number)
+    Decrement,      // --
+
+    // Control flow
+    Jump,           // u16 forward offset
+    JumpIfFalse,    // u16 forward offset (condition stays on the stack)
+    JumpIfTrue,     // u16 forward offset (condition stays on the stack)
+    Loop,           // u16 backward offset
+
+    // Functions
+    Call,           // u8 argument count
+    TailCall,       // u8 argument count; a call whose result is returned next
+    Closure,        // u16 function index, then per upvalue: u8 isLocal, u16 index
+    CloseUpvalue,
+    Return,
+
+    // Collections
+    BuildArray,     // u16 element count
+    BuildMap,       // u16 key/value pair count
+    BuildRecord,    // u16 key/value pair count, u16 layout index (every key a literal)
+    GetIndex,
+    SetIndex,
+    GetMember,      // u16 name index, u8 method ID, u16 field cache index
+    SetMember,      // u16 name index, u8 method ID, u16 field cache index
+    Invoke,         // u16 name index, u8 method ID, u8 argument count, u16 field cache index
+
+    // Statements
+    Print
+};
+
+/**
+ * Chunk - A compiled sequence of bytecode plus its side tables
+ *
+ * Every instruction remembers the source token it came from, so runtime
+ * errors raised by the VM point at exactly the same line and column as
+ * the tree-walk interpreter would.
+ */
+struct Chunk {
+    std::vector<uint8_t> code;
+    std::vector<Value> constants;
+    std::vector<std::string> names;       // Global and member names
+    mutable std::vector<GlobalCache> globalCaches;  // Parallel to names
+    mutable std::vector<FieldCache> fieldCaches;    // One per member instruction
+    mutable std::vector<Ref<Shape>> mapLayouts;     // One per BUILD_RECORD
+    std::vector<std::shared_ptr<FunctionProto>> functions;  // Nested functions
+    std::vector<Token> tokens;            // Tokens referenced by instructions
+    std::vector<uint32_t> tokenIndex;     // Parallel to code: index into tokens
+
+    void write(uint8_t byte, uint32_t token);
+    size_t addConstant(Value value);
+    size_t addName(const std::string& name);
+    size_t addFieldCache();
+    size_t addMapLayout();
+    size_t addFunction(std::shared_ptr<FunctionProto> function);
+    uint32_t addToken(const Token& token);
+
+    // Token of the instruction starting at the given offset
+    const Token& tokenAt(size_t offset) const { return tokens[tokenIndex[offset]]; }
+};
+
+/**
+ * FunctionProto - The compiled form of a function body
+ *
+ * A prototype is immutable once compiled. At runtime a Closure pairs a
+ * prototype with the upvalues it captured.
+ */
+struct FunctionProto {
+    std::string name;
+    int arity = 0;
+    int upvalueCount = 0;
+    Chunk chunk;
+};
+
+using FunctionProtoPtr = std::shared_ptr<FunctionProto>;
+
+// Human readable listing of a function and every function nested in it
+std::string disassemble(const FunctionProto& function);
+
+// Name of an opcode (for the disassembler)
+const char* opCodeName(OpCode op);
+
+} // namespace volt
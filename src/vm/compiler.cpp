@@ -0,0 +1,748 @@
+#include "compiler.h"
+#include "interpreter.h"
+#include <limits>
+
+namespace volt {
+
+// ========================================
+// ENTRY POINTS
+// ========================================
+
+FunctionProtoPtr Compiler::compile(const std::vector<StmtPtr>& statements) {
+    FunctionState script;
+    script.function = std::make_shared<FunctionProto>();
+    script.function->name = "script";
+    script.locals.push_back({"", 0, true, false}); // Slot 0 holds the callee
+    current_ = &script;
+
+    for (const auto& stmt : statements) {
+        compileStmt(stmt.get());
+    }
+
+    Token end = statements.empty() ? Token(TokenType::Eof, "", 0, 0) : statements.back()->token;
+    emit(OpCode::Nil, end);
+    emit(OpCode::Return, end);
+
+    current_ = nullptr;
+    return script.function;
+}
+
+FunctionProtoPtr Compiler::compileExpression(Expr* expr) {
+    FunctionState script;
+    script.function = std::make_shared<FunctionProto>();
+    script.function->name = "expression";
+    script.locals.push_back({"", 0, true, false});
+    current_ = &script;
+
+    compileExpr(expr);
+    emit(OpCode::Return, expr->token);
+
+    current_ = nullptr;
+    return script.function;
+}
+
+// ========================================
+// STATEMENTS
+// ========================================
+
+void Compiler::compileStmt(Stmt* stmt) {
+    switch (stmt->kind) {
+        case StmtKind::Expr:
+            compileExpr(static_cast<ExprStmt*>(stmt)->expr.get());
+            emit(OpCode::Pop, stmt->token);
+            return;
+        case StmtKind::Print:
+            compileExpr(static_cast<PrintStmt*>(stmt)->expr.get());
+            emit(OpCode::Print, stmt->token);
+            return;
+        case StmtKind::Let:
+            return compileLet(static_cast<LetStmt*>(stmt));
+        case StmtKind::Block:
+            return compileBlock(static_cast<BlockStmt*>(stmt));
+        case StmtKind::If:
+            return compileIf(static_cast<IfStmt*>(stmt));
+        case StmtKind::While:
+            return compileWhile(static_cast<WhileStmt*>(stmt));
+        case StmtKind::RunUntil:
+            return compileRunUntil(static_cast<RunUntilStmt*>(stmt));
+        case StmtKind::For:
+            return compileFor(static_cast<ForStmt*>(stmt));
+        case StmtKind::Fn:
+            return compileFn(static_cast<FnStmt*>(stmt));
+        case StmtKind::Return:
+            return compileReturn(static_cast<ReturnStmt*>(stmt));
+        case StmtKind::Break:
+            return compileBreak(static_cast<BreakStmt*>(stmt));
+        case StmtKind::Continue:
+            return compileContinue(static_cast<ContinueStmt*>(stmt));
+    }
+    throw RuntimeError(stmt->token, "Unknown statement type");
+}
+
+void Compiler::compileLet(LetStmt* stmt) {
+    // The initializer runs before the name exists, so 'let x = x + 1'
+    // still sees the outer x
+    if (stmt->initializer) {
+        compileExpr(stmt->initializer.get());
+    } else {
+        emit(OpCode::Nil, stmt->token);
+    }
+
+    if (current_->scopeDepth == 0) {
+        emitWithShort(OpCode::DefineGlobal, chunk().addName(stmt->name), stmt->token);
+        return;
+    }
+
+    int slot = findLocalInCurrentScope(stmt->name);
+    emitWithShort(OpCode::SetLocal, static_cast<size_t>(slot), stmt->token);
+    emit(OpCode::Pop, stmt->token);
+    markDeclared(stmt->name);
+}
+
+void Compiler::compileBlock(BlockStmt* stmt) {
+    std::vector<Stmt*> declarations;
+    for (const auto& inner : stmt->statements) {
+        collectDeclarations(inner.get(), declarations);
+    }
+
+    beginScope(declarations);
+    for (const auto& inner : stmt->statements) {
+        compileStmt(inner.get());
+    }
+    endScope(stmt->token);
+}
+
+void Compiler::compileIf(IfStmt* stmt) {
+    compileExpr(stmt->condition.get());
+    size_t thenJump = emitJump(OpCode::JumpIfFalse, stmt->token);
+    emit(OpCode::Pop, stmt->token);
+    compileStmt(stmt->thenBranch.get());
+
+    size_t elseJump = emitJump(OpCode::Jump, stmt->token);
+    patchJump(thenJump, stmt->token);
+    emit(OpCode::Pop, stmt->token);
+    if (stmt->elseBranch) {
+        compileStmt(stmt->elseBranch.get());
+    }
+    patchJump(elseJump, stmt->token);
+}
+
+void Compiler::compileWhile(WhileStmt* stmt) {
+    size_t loopStart = chunk().code.size();
+    compileExpr(stmt->condition.get());
+    size_t exitJump = emitJump(OpCode::JumpIfFalse, stmt->token);
+    emit(OpCode::Pop, stmt->token);
+
+    LoopState loop;
+    loop.scopeDepth = current_->scopeDepth;
+    loop.continueTarget = loopStart;
+    loop.continueBackward = true;
+    current_->loops.push_back(loop);
+
+    compileStmt(stmt->body.get());
+    emitLoop(loopStart, stmt->token);
+
+    patchJump(exitJump, stmt->token);
+    emit(OpCode::Pop, stmt->token);
+
+    for (size_t jump : current_->loops.back().breakJumps) {
+        patchJump(jump, stmt->token);
+    }
+    current_->loops.pop_back();
+}
+
+void Compiler::compileRunUntil(RunUntilStmt* stmt) {
+    // Body runs first; the loop repeats until the condition is TRUE
+    size_t bodyStart = chunk().code.size();
+
+    LoopState loop;
+    loop.scopeDepth = current_->scopeDepth;
+    current_->loops.push_back(loop);
+
+    compileStmt(stmt->body.get());
+
+    // 'continue' skips to the condition check
+    for (size_t jump : current_->loops.back().continueJumps) {
+        patchJump(jump, stmt->token);
+    }
+
+    compileExpr(stmt->condition.get());
+    size_t exitJump = emitJump(OpCode::JumpIfTrue, stmt->token);
+    emit(OpCode::Pop, stmt->token);
+    emitLoop(bodyStart, stmt->token);
+
+    patchJump(exitJump, stmt->token);
+    emit(OpCode::Pop, stmt->token);
+
+    for (size_t jump : current_->loops.back().breakJumps) {
+        patchJump(jump, stmt->token);
+    }
+    current_->loops.pop_back();
+}
+
+void Compiler::compileFor(ForStmt* stmt) {
+    // The loop variable lives in its own scope around the whole loop
+    std::vector<Stmt*> declarations;
+    if (stmt->initializer) {
+        collectDeclarations(stmt->initializer.get(), declarations);
+    }
+    collectDeclarations(stmt->body.get(), declarations);
+    beginScope(declarations);
+
+    if (stmt->initializer) {
+        compileStmt(stmt->initializer.get());
+    }
+
+    size_t loopStart = chunk().code.size();
+    size_t exitJump = 0;
+    if (stmt->condition) {
+        compileExpr(stmt->condition.get());
+        exitJump = emitJump(OpCode::JumpIfFalse, stmt->token);
+        emit(OpCode::Pop, stmt->token);
+    }
+
+    LoopState loop;
+    loop.scopeDepth = current_->scopeDepth;
+    current_->loops.push_back(loop);
+
+    compileStmt(stmt->body.get());
+
+    // 'continue' still runs the increment
+    for (size_t jump : current_->loops.back().continueJumps) {
+        patchJump(jump, stmt->token);
+    }
+    if (stmt->increment) {
+        compileExpr(stmt->increment.get());
+        emit(OpCode::Pop, stmt->token);
+    }
+    emitLoop(loopStart, stmt->token);
+
+    if (stmt->condition) {
+        patchJump(exitJump, stmt->token);
+        emit(OpCode::Pop, stmt->token);
+    }
+
+    for (size_t jump : current_->loops.back().breakJumps) {
+        patchJump(jump, stmt->token);
+    }
+    current_->loops.pop_back();
+
+    endScope(stmt->token);
+}
+
+void Compiler::compileFn(FnStmt* stmt) {
+    std::vector<UpvalueRef> captures;
+    FunctionProtoPtr function = compileFunction(stmt, captures);
+    size_t index = chunk().addFunction(function);
+
+    // The capture list follows the function index
+    emitWithShort(OpCode::Closure, index, stmt->token);
+    for (const UpvalueRef& capture : captures) {
+        emitByte(capture.isLocal ? 1 : 0, stmt->token);
+        emitShort(capture.index, stmt->token);
+    }
+
+    if (current_->scopeDepth == 0) {
+        emitWithShort(OpCode::DefineGlobal, chunk().addName(stmt->name), stmt->token);
+        return;
+    }
+
+    int slot = findLocalInCurrentScope(stmt->name);
+    emitWithShort(OpCode::SetLocal, static_cast<size_t>(slot), stmt->token);
+    emit(OpCode::Pop, stmt->token);
+    markDeclared(stmt->name);
+}
+
+void Compiler::compileReturn(ReturnStmt* stmt) {
+    if (stmt->tailCall) {
+        // TAIL_CALL reuses this frame for a closure; anything else is an
+        // ordinary call whose result the RETURN below hands back
+        compileCall(static_cast<CallExpr*>(stmt->value.get()), OpCode::TailCall);
+    } else if (stmt->value) {
+        compileExpr(stmt->value.get());
+    } else {
+        emit(OpCode::Nil, stmt->token);
+    }
+    emit(OpCode::Return, stmt->token);
+}
+
+void Compiler::compileBreak(BreakStmt* stmt) {
+    if (current_->loops.empty()) {
+        throw RuntimeError(stmt->token, "Can't use 'break' outside of a loop");
+    }
+    LoopState& loop = current_->loops.back();
+    emitScopeExit(loop.scopeDepth, stmt->token);
+    loop.breakJumps.push_back(emitJump(OpCode::Jump, stmt->token));
+}
+
+void Compiler::compileContinue(ContinueStmt* stmt) {
+    if (current_->loops.empty()) {
+        throw RuntimeError(stmt->token, "Can't use 'continue' outside of a loop");
+    }
+    LoopState& loop = current_->loops.back();
+    emitScopeExit(loop.scopeDepth, stmt->token);
+    if (loop.continueBackward) {
+        emitLoop(loop.continueTarget, stmt->token);
+    } else {
+        loop.continueJumps.push_back(emitJump(OpCode::Jump, stmt->token));
+    }
+}
+
+// ========================================
+// EXPRESSIONS
+// ========================================
+
+void Compiler::compileExpr(Expr* expr) {
+    switch (expr->kind) {
+        case ExprKind::Literal:
+            return compileLiteral(static_cast<LiteralExpr*>(expr));
+        case ExprKind::Variable: {
+            auto* var = static_cast<VariableExpr*>(expr);
+            return emitGet(var->name, var->token);
+        }
+        case ExprKind::Unary: {
+            auto* unary = static_cast<UnaryExpr*>(expr);
+            compileExpr(unary->right.get());
+            return emit(unary->op.type == TokenType::Minus ? OpCode::Negate : OpCode::Not, unary->op);
+        }
+        case ExprKind::Binary:
+            return compileBinary(static_cast<BinaryExpr*>(expr));
+        case ExprKind::Logical:
+            return compileLogical(static_cast<LogicalExpr*>(expr));
+        case ExprKind::Grouping:
+            return compileExpr(static_cast<GroupingExpr*>(expr)->expr.get());
+        case ExprKind::Call:
+            return compileCall(static_cast<CallExpr*>(expr));
+        case ExprKind::Assign: {
+            auto* assign = static_cast<AssignExpr*>(expr);
+            compileExpr(assign->value.get());
+            return emitSet(assign->name, assign->token);
+        }
+        case ExprKind::CompoundAssign:
+            return compileCompoundAssign(static_cast<CompoundAssignExpr*>(expr));
+        case ExprKind::Update:
+            return compileUpdate(static_cast<UpdateExpr*>(expr));
+        case ExprKind::Ternary:
+            return compileTernary(static_cast<TernaryExpr*>(expr));
+        case ExprKind::Array: {
+            auto* array = static_cast<ArrayExpr*>(expr);
+            for (const auto& element : array->elements) {
+                compileExpr(element.get());
+            }
+            return emitWithShort(OpCode::BuildArray, array->elements.size(), array->token);
+        }
+        case ExprKind::Index: {
+            auto* index = static_cast<IndexExpr*>(expr);
+            compileExpr(index->object.get());
+            compileExpr(index->index.get());
+            return emit(OpCode::GetIndex, index->token);
+        }
+        case ExprKind::IndexAssign: {
+            auto* indexAssign = static_cast<IndexAssignExpr*>(expr);
+            compileExpr(indexAssign->object.get());
+            compileExpr(indexAssign->index.get());
+            compileExpr(indexAssign->value.get());
+            return emit(OpCode::SetIndex, indexAssign->token);
+        }
+        case ExprKind::Member: {
+            auto* member = static_cast<MemberExpr*>(expr);
+            compileExpr(member->object.get());
+            emitWithShort(OpCode::GetMember, chunk().addName(member->member), member->token);
+            emitByte(static_cast<uint8_t>(member->method), member->token);
+            return emitFieldCache(member->token);
+        }
+        case ExprKind::MemberAssign: {
+            auto* assign = static_cast<MemberAssignExpr*>(expr);
+            compileExpr(assign->object.get());
+            compileExpr(assign->value.get());
+            emitWithShort(OpCode::SetMember, chunk().addName(assign->member), assign->token);
+            emitByte(static_cast<uint8_t>(assign->method), assign->token);
+            return emitFieldCache(assign->token);
+        }
+        case ExprKind::MethodCall:
+            return compileMethodCall(static_cast<MethodCallExpr*>(expr));
+        case ExprKind::HashMap: {
+            auto* hashMap = static_cast<HashMapExpr*>(expr);
+            bool literalKeys = true;
+            for (const auto& [key, value] : hashMap->keyValuePairs) {
+                compileExpr(key.get());
+                compileExpr(value.get());
+                literalKeys = literalKeys && key->kind == ExprKind::Literal;
+            }
+            if (!literalKeys) {
+                return emitWithShort(OpCode::BuildMap, hashMap->keyValuePairs.size(), hashMap->token);
+            }
+            // Records reuse the shape the first one built
+            emitWithShort(OpCode::BuildRecord, hashMap->keyValuePairs.size(), hashMap->token);
+            return emitShort(checkedShort(chunk().addMapLayout(), hashMap->token, "number of map literals"),
+                             hashMap->token);
+        }
+    }
+    throw RuntimeError(expr->token, "Unknown expression type");
+}
+
+void Compiler::compileBinary(BinaryExpr* expr) {
+    compileExpr(expr->left.get());
+    compileExpr(expr->right.get());
+    OpCode op;
+    switch (expr->op.type) {
+        case TokenType::Plus: op = OpCode::Add; break;
+        case TokenType::Minus: op = OpCode::Subtract; break;
+        case TokenType::Star: op = OpCode::Multiply; break;
+        case TokenType::Slash: op = OpCode::Divide; break;
+        case TokenType::Percent: op = OpCode::Modulo; break;
+        case TokenType::Greater: op = OpCode::Greater; break;
+        case TokenType::GreaterEqual: op = OpCode::GreaterEqual; break;
+        case TokenType::Less: op = OpCode::Less; break;
+        case TokenType::LessEqual: op = OpCode::LessEqual; break;
+        case TokenType::EqualEqual: op = OpCode::Equal; break;
+        case TokenType::BangEqual: op = OpCode::NotEqual; break;
+        default:
+            throw RuntimeError(expr->op, "Unknown binary operator");
+    }
+    emit(op, expr->op);
+}
+
+void Compiler::compileLiteral(LiteralExpr* expr) {
+    switch (expr->type) {
+        case LiteralExpr::Type::Number:
+            emitWithShort(OpCode::Constant, chunk().addConstant(expr->numberValue), expr->token);
+            break;
+        case LiteralExpr::Type::String:
+            emitWithShort(OpCode::Constant, chunk().addConstant(expr->value), expr->token);
+            break;
+        case LiteralExpr::Type::Bool:
+            emit(expr->boolValue ? OpCode::True : OpCode::False, expr->token);
+            break;
+        case LiteralExpr::Type::Nil:
+            emit(OpCode::Nil, expr->token);
+            break;
+    }
+}
+
+void Compiler::compileLogical(LogicalExpr* expr) {
+    // Short-circuit: the deciding operand is the result
+    compileExpr(expr->left.get());
+    OpCode jump = expr->op.type == TokenType::Or ? OpCode::JumpIfTrue : OpCode::JumpIfFalse;
+    size_t endJump = emitJump(jump, expr->op);
+    emit(OpCode::Pop, expr->op);
+    compileExpr(expr->right.get());
+    patchJump(endJump, expr->op);
+}
+
+void Compiler::compileCall(CallExpr* expr, OpCode op) {
+    compileExpr(expr->callee.get());
+    for (const auto& arg : expr->arguments) {
+        compileExpr(arg.get());
+    }
+    if (expr->arguments.size() > std::numeric_limits<uint8_t>::max()) {
+        throw RuntimeError(expr->token, "Can't have more than 255 arguments");
+    }
+    emit(op, expr->token);
+    emitByte(static_cast<uint8_t>(expr->arguments.size()), expr->token);
+}
+
+void Compiler::compileMethodCall(MethodCallExpr* expr) {
+    compileExpr(expr->object.get());
+    for (const auto& arg : expr->arguments) {
+        compileExpr(arg.get());
+    }
+    if (expr->arguments.size() > std::numeric_limits<uint8_t>::max()) {
+        throw RuntimeError(expr->token, "Can't have more than 255 arguments");
+    }
+    emitWithShort(OpCode::Invoke, chunk().addName(expr->member), expr->token);
+    emitByte(static_cast<uint8_t>(expr->method), expr->token);
+    emitByte(static_cast<uint8_t>(expr->arguments.size()), expr->token);
+    emitFieldCache(expr->token);
+}
+
+void Compiler::compileCompoundAssign(CompoundAssignExpr* expr) {
+    emitGet(expr->name, expr->token);
+    compileExpr(expr->value.get());
+    emit(OpCode::Compound, expr->op);
+    emitSet(expr->name, expr->token);
+}
+
+void Compiler::compileUpdate(UpdateExpr* expr) {
+    OpCode op = expr->op.type == TokenType::PlusPlus ? OpCode::Increment : OpCode::Decrement;
+    emitGet(expr->name, expr->token);
+    if (expr->prefix) {
+        emit(op, expr->op);
+        emitSet(expr->name, expr->token);
+    } else {
+        // Keep the old value underneath the updated one
+        emit(OpCode::Dup, expr->op);
+        emit(op, expr->op);
+        emitSet(expr->name, expr->token);
+        emit(OpCode::Pop, expr->op);
+    }
+}
+
+void Compiler::compileTernary(TernaryExpr* expr) {
+    compileExpr(expr->condition.get());
+    size_t elseJump = emitJump(OpCode::JumpIfFalse, expr->token);
+    emit(OpCode::Pop, expr->token);
+    compileExpr(expr->thenBranch.get());
+    size_t endJump = emitJump(OpCode::Jump, expr->token);
+    patchJump(elseJump, expr->token);
+    emit(OpCode::Pop, expr->token);
+    compileExpr(expr->elseBranch.get());
+    patchJump(endJump, expr->token);
+}
+
+// ========================================
+// VARIABLES
+// ========================================
+
+void Compiler::emitGet(const std::string& name, const Token& token) {
+    int slot = resolveLocal(current_, name, false);
+    if (slot >= 0) {
+        emitWithShort(OpCode::GetLocal, static_cast<size_t>(slot), token);
+        return;
+    }
+    int upvalue = resolveUpvalue(current_, name);
+    if (upvalue >= 0) {
+        emitWithShort(OpCode::GetUpvalue, static_cast<size_t>(upvalue), token);
+        return;
+    }
+    emitWithShort(OpCode::GetGlobal, chunk().addName(name), token);
+}
+
+void Compiler::emitSet(const std::string& name, const Token& token) {
+    int slot = resolveLocal(current_, name, false);
+    if (slot >= 0) {
+        emitWithShort(OpCode::SetLocal, static_cast<size_t>(slot), token);
+        return;
+    }
+    int upvalue = resolveUpvalue(current_, name);
+    if (upvalue >= 0) {
+        emitWithShort(OpCode::SetUpvalue, static_cast<size_t>(upvalue), token);
+        return;
+    }
+    emitWithShort(OpCode::SetGlobal, chunk().addName(name), token);
+}
+
+int Compiler::resolveLocal(FunctionState* state, const std::string& name, bool hoisted) {
+    for (int i = static_cast<int>(state->locals.size()) - 1; i >= 0; i--) {
+        const Local& local = state->locals[i];
+        if (local.name == name && (local.declared || hoisted)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int Compiler::resolveUpvalue(FunctionState* state, const std::string& name) {
+    if (!state->enclosing) return -1;
+
+    // A nested function body runs later, so hoisted siblings count
+    int local = resolveLocal(state->enclosing, name, true);
+    if (local >= 0) {
+        state->enclosing->locals[local].captured = true;
+        return addUpvalue(state, static_cast<uint16_t>(local), true);
+    }
+
+    int upvalue = resolveUpvalue(state->enclosing, name);
+    if (upvalue >= 0) {
+        return addUpvalue(state, static_cast<uint16_t>(upvalue), false);
+    }
+    return -1;
+}
+
+int Compiler::addUpvalue(FunctionState* state, uint16_t index, bool isLocal) {
+    for (size_t i = 0; i < state->upvalues.size(); i++) {
+        if (state->upvalues[i].index == index && state->upvalues[i].isLocal == isLocal) {
+            return static_cast<int>(i);
+        }
+    }
+    state->upvalues.push_back({index, isLocal});
+    state->function->upvalueCount = static_cast<int>(state->upvalues.size());
+    return static_cast<int>(state->upvalues.size() - 1);
+}
+
+void Compiler::declareLocal(const std::string& name, bool declared) {
+    current_->locals.push_back({name, current_->scopeDepth, declared, false});
+}
+
+void Compiler::markDeclared(const std::string& name) {
+    int slot = findLocalInCurrentScope(name);
+    if (slot >= 0) {
+        current_->locals[slot].declared = true;
+    }
+}
+
+int Compiler::findLocalInCurrentScope(const std::string& name) {
+    for (int i = static_cast<int>(current_->locals.size()) - 1; i >= 0; i--) {
+        const Local& local = current_->locals[i];
+        if (local.depth < current_->scopeDepth) break;
+        if (local.name == name) return i;
+    }
+    return -1;
+}
+
+// ========================================
+// SCOPES
+// ========================================
+
+// Declarations that end up in the scope of the enclosing block: direct
+// statements plus the bodies of if/while/run that are not blocks themselves
+void Compiler::collectDeclarations(Stmt* stmt, std::vector<Stmt*>& out) {
+    if (!stmt) return;
+    switch (stmt->kind) {
+        case StmtKind::Let:
+        case StmtKind::Fn:
+            out.push_back(stmt);
+            break;
+        case StmtKind::If: {
+            auto* ifStmt = static_cast<IfStmt*>(stmt);
+            collectDeclarations(ifStmt->thenBranch.get(), out);
+            collectDeclarations(ifStmt->elseBranch.get(), out);
+            break;
+        }
+        case StmtKind::While:
+            collectDeclarations(static_cast<WhileStmt*>(stmt)->body.get(), out);
+            break;
+        case StmtKind::RunUntil:
+            collectDeclarations(static_cast<RunUntilStmt*>(stmt)->body.get(), out);
+            break;
+        default:
+            break;
+    }
+}
+
+const std::string& Compiler::declaredName(Stmt* decl) {
+    return decl->kind == StmtKind::Let
+        ? static_cast<LetStmt*>(decl)->name
+        : static_cast<FnStmt*>(decl)->name;
+}
+
+void Compiler::beginScope(const std::vector<Stmt*>& declarations) {
+    current_->scopeDepth++;
+
+    // Reserve a nil slot for every name declared in this scope
+    for (Stmt* decl : declarations) {
+        const std::string& name = declaredName(decl);
+        if (findLocalInCurrentScope(name) >= 0) continue; // Redeclaration reuses the slot
+        if (current_->locals.size() > std::numeric_limits<uint16_t>::max()) {
+            throw RuntimeError(decl->token, "Too many local variables in function");
+        }
+        declareLocal(name, false);
+        emit(OpCode::Nil, decl->token);
+    }
+}
+
+void Compiler::endScope(const Token& token) {
+    emitScopeExit(current_->scopeDepth - 1, token);
+    current_->scopeDepth--;
+    while (!current_->locals.empty() && current_->locals.back().depth > current_->scopeDepth) {
+        current_->locals.pop_back();
+    }
+}
+
+// Pop (or close) every local deeper than the given depth without
+// forgetting them - used by endScope and by break/continue
+void Compiler::emitScopeExit(int depth, const Token& token) {
+    for (int i = static_cast<int>(current_->locals.size()) - 1; i >= 0; i--) {
+        const Local& local = current_->locals[i];
+        if (local.depth <= depth) break;
+        emit(local.captured ? OpCode::CloseUpvalue : OpCode::Pop, token);
+    }
+}
+
+// ========================================
+// FUNCTIONS
+// ========================================
+
+FunctionProtoPtr Compiler::compileFunction(FnStmt* stmt, std::vector<UpvalueRef>& captures) {
+    FunctionState state;
+    state.function = std::make_shared<FunctionProto>();
+    state.function->name = stmt->name;
+    state.function->arity = static_cast<int>(stmt->parameters.size());
+    state.enclosing = current_;
+    state.scopeDepth = 1;
+    current_ = &state;
+
+    declareLocal("", true); // Slot 0 holds the callee
+    for (const auto& param : stmt->parameters) {
+        if (findLocalInCurrentScope(param) >= 0) continue;
+        declareLocal(param, true);
+    }
+
+    // The body shares the parameters' scope
+    std::vector<Stmt*> declarations;
+    for (const auto& inner : stmt->body) {
+        collectDeclarations(inner.get(), declarations);
+    }
+    for (Stmt* decl : declarations) {
+        const std::string& name = declaredName(decl);
+        if (findLocalInCurrentScope(name) >= 0) continue;
+        declareLocal(name, false);
+        emit(OpCode::Nil, decl->token);
+    }
+
+    for (const auto& inner : stmt->body) {
+        compileStmt(inner.get());
+    }
+    emit(OpCode::Nil, stmt->token);
+    emit(OpCode::Return, stmt->token);
+
+    captures = std::move(state.upvalues);
+    current_ = state.enclosing;
+    return state.function;
+}
+
+// ========================================
+// EMITTING BYTECODE
+// ========================================
+
+void Compiler::emit(OpCode op, const Token& token) {
+    emitByte(static_cast<uint8_t>(op), token);
+}
+
+void Compiler::emitByte(uint8_t byte, const Token& token) {
+    chunk().write(byte, chunk().addToken(token));
+}
+
+void Compiler::emitShort(uint16_t value, const Token& token) {
+    emitByte(static_cast<uint8_t>((value >> 8) & 0xff), token);
+    emitByte(static_cast<uint8_t>(value & 0xff), token);
+}
+
+void Compiler::emitWithShort(OpCode op, size_t operand, const Token& token) {
+    uint16_t value = checkedShort(operand, token, "operand");
+    emit(op, token);
+    emitShort(value, token);
+}
+
+// A fresh inline cache for the member instruction just emitted
+void Compiler::emitFieldCache(const Token& token) {
+    emitShort(checkedShort(chunk().addFieldCache(), token, "number of member sites"), token);
+}
+
+size_t Compiler::emitJump(OpCode op, const Token& token) {
+    emit(op, token);
+    emitShort(0xffff, token);
+    return chunk().code.size() - 2;
+}
+
+void Compiler::patchJump(size_t offset, const Token& token) {
+    size_t jump = chunk().code.size() - offset - 2;
+    uint16_t value = checkedShort(jump, token, "jump");
+    chunk().code[offset] = static_cast<uint8_t>((value >> 8) & 0xff);
+    chunk().code[offset + 1] = static_cast<uint8_t>(value & 0xff);
+}
+
+void Compiler::emitLoop(size_t loopStart, const Token& token) {
+    emit(OpCode::Loop, token);
+    size_t offset = chunk().code.size() - loopStart + 2;
+    emitShort(checkedShort(offset, token, "loop body"), token);
+}
+
+uint16_t Compiler::checkedShort(size_t value, const Token& token, const char* what) {
+    if (value > std::numeric_limits<uint16_t>::max()) {
+        throw RuntimeError(token, std::string("Too large ") + what + " for bytecode");
+    }
+    return static_cast<uint16_t>(value);
+}
+
+} // namespace volt
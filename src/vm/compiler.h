@@ -0,0 +1,124 @@
+#pragma once
+#include "chunk.h"
+#include "ast.h"
+#include "stmt.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace volt {
+
+/**
+ * Compiler - Turns the AST into bytecode for the VM
+ *
+ * Single pass over the statements produced by Parser::parseProgram.
+ * Variables are resolved while compiling:
+ * - names declared in a block or function become stack slots (locals)
+ * - locals of enclosing functions are reached through upvalues
+ * - everything else is a global looked up by name at runtime
+ *
+ * Declarations are hoisted to the start of their block so that nested
+ * functions can refer to siblings declared after them (mutual recursion),
+ * exactly like the environment chain of the tree-walk interpreter allows.
+ * Plain references still only see a local once its 'let' has run.
+ */
+class Compiler {
+public:
+    Compiler() = default;
+
+    // Compile a whole program into the top-level "script" function
+    FunctionProtoPtr compile(const std::vector<StmtPtr>& statements);
+
+    // Compile a single expression into a function returning its value
+    FunctionProtoPtr compileExpression(Expr* expr);
+
+private:
+    struct Local {
+        std::string name;
+        int depth;
+        bool declared;   // Visible to direct references once its 'let' ran
+        bool captured;   // Closed over by a nested function
+    };
+
+    struct UpvalueRef {
+        uint16_t index;
+        bool isLocal;
+    };
+
+    struct LoopState {
+        int scopeDepth;                    // Locals deeper than this die on break/continue
+        std::vector<size_t> breakJumps;
+        std::vector<size_t> continueJumps; // Forward jumps (for and run-until)
+        size_t continueTarget = 0;         // Backward target (while)
+        bool continueBackward = false;
+    };
+
+    struct FunctionState {
+        FunctionProtoPtr function;
+        FunctionState* enclosing = nullptr;
+        std::vector<Local> locals;
+        std::vector<UpvalueRef> upvalues;
+        std::vector<LoopState> loops;
+        int scopeDepth = 0;
+    };
+
+    // Statements
+    void compileStmt(Stmt* stmt);
+    void compileLet(LetStmt* stmt);
+    void compileBlock(BlockStmt* stmt);
+    void compileIf(IfStmt* stmt);
+    void compileWhile(WhileStmt* stmt);
+    void compileRunUntil(RunUntilStmt* stmt);
+    void compileFor(ForStmt* stmt);
+    void compileFn(FnStmt* stmt);
+    void compileReturn(ReturnStmt* stmt);
+    void compileBreak(BreakStmt* stmt);
+    void compileContinue(ContinueStmt* stmt);
+
+    // Expressions
+    void compileExpr(Expr* expr);
+    void compileLiteral(LiteralExpr* expr);
+    void compileBinary(BinaryExpr* expr);
+    void compileLogical(LogicalExpr* expr);
+    void compileCall(CallExpr* expr, OpCode op = OpCode::Call);
+    void compileMethodCall(MethodCallExpr* expr);
+    void compileCompoundAssign(CompoundAssignExpr* expr);
+    void compileUpdate(UpdateExpr* expr);
+    void compileTernary(TernaryExpr* expr);
+
+    // Variables
+    void emitGet(const std::string& name, const Token& token);
+    void emitSet(const std::string& name, const Token& token);
+    int resolveLocal(FunctionState* state, const std::string& name, bool hoisted);
+    int resolveUpvalue(FunctionState* state, const std::string& name);
+    int addUpvalue(FunctionState* state, uint16_t index, bool isLocal);
+    void declareLocal(const std::string& name, bool declared);
+    void markDeclared(const std::string& name);
+    int findLocalInCurrentScope(const std::string& name);
+
+    // Scopes
+    void beginScope(const std::vector<Stmt*>& declarations);
+    void endScope(const Token& token);
+    void emitScopeExit(int depth, const Token& token);
+    static void collectDeclarations(Stmt* stmt, std::vector<Stmt*>& out);
+    static const std::string& declaredName(Stmt* decl);
+
+    // Functions
+    FunctionProtoPtr compileFunction(FnStmt* stmt, std::vector<UpvalueRef>& captures);
+
+    // Emitting bytecode
+    Chunk& chunk() { return current_->function->chunk; }
+    void emit(OpCode op, const Token& token);
+    void emitByte(uint8_t byte, const Token& token);
+    void emitShort(uint16_t value, const Token& token);
+    void emitFieldCache(const Token& token);
+    void emitWithShort(OpCode op, size_t operand, const Token& token);
+    size_t emitJump(OpCode op, const Token& token);
+    void patchJump(size_t offset, const Token& token);
+    void emitLoop(size_t loopStart, const Token& token);
+    uint16_t checkedShort(size_t value, const Token& token, const char* what);
+
+    FunctionState* current_ = nullptr;
+};
+
+} // namespace volt
@@ -0,0 +1,479 @@
+#include "vm.h"
+#include "compiler.h"
+#include "interpreter.h"
+#include "features/array.h"
+#include "features/hashmap.h"
+#include <iostream>
+
+namespace volt {
+
+// ========================================
+// CLOSURES
+// ========================================
+
+VmClosure::VmClosure(VM& vm, FunctionProtoPtr proto)
+    : vm(vm), proto(std::move(proto)) {}
+
+Value VmClosure::call(Interpreter&, std::span<const Value> arguments) {
+    return vm.call(*this, arguments);
+}
+
+std::string VmClosure::toString() const {
+    return "<fn " + proto->name + ">";
+}
+
+// ========================================
+// ENTRY POINTS
+// ========================================
+
+VM::VM(Interpreter& interpreter) : interpreter_(interpreter) {
+    stack_.reserve(256);
+    frames_.reserve(64);
+}
+
+void VM::execute(const std::vector<StmtPtr>& statements) {
+    Compiler compiler;
+    FunctionProtoPtr script = compiler.compile(statements);
+    if (dumpBytecode_) {
+        std::cout << "\n=== BYTECODE ===\n" << disassemble(*script) << "================\n\n";
+    }
+    runFunction(script);
+}
+
+Value VM::evaluate(Expr* expr) {
+    Compiler compiler;
+    return runFunction(compiler.compileExpression(expr));
+}
+
+Value VM::runFunction(FunctionProtoPtr proto) {
+    auto closure = makeRef<VmClosure>(*this, std::move(proto));
+    return call(*closure, {});
+}
+
+Value VM::call(VmClosure& closure, std::span<const Value> arguments) {
+    if (frames_.size() >= kMaxFrames) {
+        throw RuntimeError(closure.proto->chunk.tokenAt(0), "Stack overflow");
+    }
+
+    size_t stackBase = stack_.size();
+    size_t frameDepth = frames_.size();
+
+    // The arguments may live on this very stack (a native calling back
+    // in), so copy them by index: push_back can move the storage
+    const Value* first = arguments.data();
+    bool onStack = first >= stack_.data() && first < stack_.data() + stack_.size();
+    size_t firstSlot = onStack ? static_cast<size_t>(first - stack_.data()) : 0;
+
+    stack_.push_back(nullptr); // Slot 0: the callee is not needed here
+    for (size_t i = 0; i < arguments.size(); i++) {
+        Value arg = onStack ? stack_[firstSlot + i] : arguments[i];
+        stack_.push_back(std::move(arg));
+    }
+    frames_.push_back({&closure, closure.proto->chunk.code.data(), stackBase});
+
+    try {
+        return run(frameDepth);
+    } catch (...) {
+        // Unwind everything this call pushed so the VM stays usable
+        closeUpvalues(stackBase);
+        stack_.resize(stackBase);
+        frames_.resize(frameDepth);
+        throw;
+    }
+}
+
+// ========================================
+// UPVALUES
+// ========================================
+
+UpvaluePtr VM::captureUpvalue(size_t slot) {
+    // Reuse an open upvalue for the same slot so closures share it
+    auto it = openUpvalues_.end();
+    while (it != openUpvalues_.begin() && (*(it - 1))->slot >= slot) {
+        --it;
+        if ((*it)->slot == slot) return *it;
+    }
+    auto upvalue = makeRef<Upvalue>();
+    upvalue->slot = slot;
+    openUpvalues_.insert(it, upvalue);
+    return upvalue;
+}
+
+void VM::closeUpvalues(size_t fromSlot) {
+    while (!openUpvalues_.empty() && openUpvalues_.back()->slot >= fromSlot) {
+        Upvalue& upvalue = *openUpvalues_.back();
+        upvalue.closed = stack_[upvalue.slot];
+        upvalue.open = false;
+        openUpvalues_.pop_back();
+    }
+}
+
+// ========================================
+// INTERPRETER LOOP
+// ========================================
+
+Value VM::run(size_t exitDepth) {
+    CallFrame* frame = &frames_.back();
+    const Chunk* chunk = &frame->closure->proto->chunk;
+    const uint8_t* ip = frame->ip;
+    const uint8_t* instruction = ip;
+
+    auto readByte = [&]() { return *ip++; };
+    auto readShort = [&]() {
+        uint16_t value = static_cast<uint16_t>((ip[0] << 8) | ip[1]);
+        ip += 2;
+        return value;
+    };
+    auto currentToken = [&]() -> const Token& {
+        return chunk->tokenAt(static_cast<size_t>(instruction - chunk->code.data()));
+    };
+    auto pop = [&]() {
+        Value value = std::move(stack_.back());
+        stack_.pop_back();
+        return value;
+    };
+    auto push = [&](Value value) { stack_.push_back(std::move(value)); };
+    // Calls can re-enter the VM and grow frames_, so reload afterwards
+    auto saveFrame = [&]() { frame->ip = ip; };
+    auto loadFrame = [&]() {
+        frame = &frames_.back();
+        chunk = &frame->closure->proto->chunk;
+        ip = frame->ip;
+    };
+
+    for (;;) {
+        instruction = ip;
+        OpCode op = static_cast<OpCode>(readByte());
+
+        switch (op) {
+            case OpCode::Constant:
+                push(chunk->constants[readShort()]);
+                break;
+            case OpCode::Nil:
+                push(nullptr);
+                break;
+            case OpCode::True:
+                push(true);
+                break;
+            case OpCode::False:
+                push(false);
+                break;
+            case OpCode::Pop:
+                stack_.pop_back();
+                break;
+            case OpCode::Dup: {
+                Value top = stack_.back();
+                push(std::move(top));
+                break;
+            }
+
+            // Variables
+            case OpCode::GetLocal: {
+                Value value = stack_[frame->base + readShort()];
+                push(std::move(value));
+                break;
+            }
+            case OpCode::SetLocal:
+                stack_[frame->base + readShort()] = stack_.back();
+                break;
+            case OpCode::GetGlobal: {
+                uint16_t index = readShort();
+                const std::string& name = chunk->names[index];
+                Value* slot = interpreter_.globals_->lookupGlobal(name, chunk->globalCaches[index]);
+                if (!slot) {
+                    throw RuntimeError(currentToken(), "Undefined variable: " + name);
+                }
+                push(*slot);
+                break;
+            }
+            case OpCode::SetGlobal: {
+                uint16_t index = readShort();
+                const std::string& name = chunk->names[index];
+                // Assigning to an unknown name declares it
+                if (Value* slot = interpreter_.globals_->lookupGlobal(name, chunk->globalCaches[index])) {
+                    *slot = stack_.back();
+                } else {
+                    interpreter_.globals_->define(name, stack_.back());
+                }
+                break;
+            }
+            case OpCode::DefineGlobal:
+                interpreter_.globals_->define(chunk->names[readShort()], pop());
+                break;
+            case OpCode::GetUpvalue: {
+                Upvalue& upvalue = *frame->closure->upvalues[readShort()];
+                Value value = upvalue.open ? stack_[upvalue.slot] : upvalue.closed;
+                push(std::move(value));
+                break;
+            }
+            case OpCode::SetUpvalue: {
+                Upvalue& upvalue = *frame->closure->upvalues[readShort()];
+                if (upvalue.open) {
+                    stack_[upvalue.slot] = stack_.back();
+                } else {
+                    upvalue.closed = stack_.back();
+                }
+                break;
+            }
+
+            // Operators
+            case OpCode::Add:
+            case OpCode::Subtract:
+            case OpCode::Multiply:
+            case OpCode::Divide:
+            case OpCode::Modulo:
+            case OpCode::Greater:
+            case OpCode::GreaterEqual:
+            case OpCode::Less:
+            case OpCode::LessEqual:
+            case OpCode::Equal:
+            case OpCode::NotEqual: {
+                Value right = pop();
+                Value left = pop();
+                // Plain number arithmetic skips the generic helper
+                if (isNumber(left) && isNumber(right)) {
+                    double a = asNumber(left);
+                    double b = asNumber(right);
+                    switch (op) {
+                        case OpCode::Add: push(a + b); continue;
+                        case OpCode::Subtract: push(a - b); continue;
+                        case OpCode::Multiply: push(a * b); continue;
+                        case OpCode::Less: push(a < b); continue;
+                        case OpCode::LessEqual: push(a <= b); continue;
+                        case OpCode::Greater: push(a > b); continue;
+                        case OpCode::GreaterEqual: push(a >= b); continue;
+                        default: break;
+                    }
+                }
+                push(interpreter_.binaryOp(currentToken(), left, right));
+                break;
+            }
+            case OpCode::Negate:
+            case OpCode::Not: {
+                Value right = pop();
+                push(interpreter_.unaryOp(currentToken(), right));
+                break;
+            }
+            case OpCode::Compound: {
+                Value operand = pop();
+                Value current = pop();
+                push(interpreter_.compoundOp(currentToken(), current, operand));
+                break;
+            }
+            case OpCode::Increment:
+            case OpCode::Decrement: {
+                Value current = pop();
+                if (!isNumber(current)) {
+                    throw RuntimeError(currentToken(), "Operand must be a number for increment/decrement");
+                }
+                push(asNumber(current) + (op == OpCode::Increment ? 1.0 : -1.0));
+                break;
+            }
+
+            // Control flow
+            case OpCode::Jump: {
+                uint16_t offset = readShort();
+                ip += offset;
+                break;
+            }
+            case OpCode::JumpIfFalse: {
+                uint16_t offset = readShort();
+                if (!isTruthy(stack_.back())) ip += offset;
+                break;
+            }
+            case OpCode::JumpIfTrue: {
+                uint16_t offset = readShort();
+                if (isTruthy(stack_.back())) ip += offset;
+                break;
+            }
+            case OpCode::Loop: {
+                uint16_t offset = readShort();
+                ip -= offset;
+                Collector::safepoint();
+                break;
+            }
+
+            // Functions
+            case OpCode::Call:
+            case OpCode::TailCall: {
+                Collector::safepoint();
+                uint8_t argCount = readByte();
+                size_t calleeSlot = stack_.size() - argCount - 1;
+                const Value& callee = stack_[calleeSlot];
+
+                VmClosure* closure = nullptr;
+                if (isCallable(callee)) {
+                    closure = dynamic_cast<VmClosure*>(asCallable(callee).get());
+                }
+
+                if (closure && &closure->vm == this) {
+                    if (argCount != closure->proto->arity) {
+                        throw RuntimeError(currentToken(),
+                            "Expected " + std::to_string(closure->proto->arity) +
+                            " arguments but got " + std::to_string(argCount));
+                    }
+                    if (op == OpCode::TailCall) {
+                        // Replace the current frame: slide the callee and
+                        // its arguments down over it and start over
+                        closeUpvalues(frame->base);
+                        for (size_t i = 0; i <= argCount; i++) {
+                            stack_[frame->base + i] = std::move(stack_[calleeSlot + i]);
+                        }
+                        stack_.resize(frame->base + argCount + 1);
+                        frame->closure = closure;
+                        frame->ip = closure->proto->chunk.code.data();
+                        loadFrame();
+                        break;
+                    }
+                    // Same-VM call: just push a frame
+                    if (frames_.size() >= kMaxFrames) {
+                        throw RuntimeError(currentToken(), "Stack overflow");
+                    }
+                    saveFrame();
+                    frames_.push_back({closure, closure->proto->chunk.code.data(), calleeSlot});
+                    loadFrame();
+                    break;
+                }
+
+                // Natives and anything else go through the shared call path,
+                // reading their arguments straight off the VM stack
+                std::span<const Value> arguments(stack_.data() + calleeSlot + 1, argCount);
+                Value calleeValue = callee;
+                const Token& token = currentToken();
+                saveFrame();
+                Value result = interpreter_.callValue(token, calleeValue, arguments);
+                loadFrame();
+                stack_.resize(calleeSlot);
+                push(std::move(result));
+                break;
+            }
+            case OpCode::Closure: {
+                const FunctionProtoPtr& proto = chunk->functions[readShort()];
+                auto closure = makeRef<VmClosure>(*this, proto);
+                closure->upvalues.reserve(proto->upvalueCount);
+                for (int i = 0; i < proto->upvalueCount; i++) {
+                    bool isLocal = readByte() != 0;
+                    uint16_t index = readShort();
+                    if (isLocal) {
+                        closure->upvalues.push_back(captureUpvalue(frame->base + index));
+                    } else {
+                        closure->upvalues.push_back(frame->closure->upvalues[index]);
+                    }
+                }
+                push(Ref<Callable>(std::move(closure)));
+                break;
+            }
+            case OpCode::CloseUpvalue:
+                closeUpvalues(stack_.size() - 1);
+                stack_.pop_back();
+                break;
+            case OpCode::Return: {
+                Value result = pop();
+                closeUpvalues(frame->base);
+                stack_.resize(frame->base);
+                frames_.pop_back();
+                if (frames_.size() == exitDepth) {
+                    return result;
+                }
+                push(std::move(result));
+                loadFrame();
+                break;
+            }
+
+            // Collections
+            case OpCode::BuildArray: {
+                uint16_t count = readShort();
+                std::vector<Value> elements(stack_.end() - count, stack_.end());
+                stack_.resize(stack_.size() - count);
+                push(makeRef<VoltArray>(elements));
+                break;
+            }
+            case OpCode::BuildMap: {
+                uint16_t count = readShort();
+                auto hashMap = makeRef<VoltHashMap>();
+                size_t first = stack_.size() - static_cast<size_t>(count) * 2;
+                for (size_t i = first; i < stack_.size(); i += 2) {
+                    hashMap->set(stack_[i], stack_[i + 1]);
+                }
+                stack_.resize(first);
+                push(std::move(hashMap));
+                break;
+            }
+            case OpCode::BuildRecord: {
+                uint16_t count = readShort();
+                Ref<Shape>& layout = chunk->mapLayouts[readShort()];
+                auto hashMap = makeRef<VoltHashMap>();
+                size_t first = stack_.size() - static_cast<size_t>(count) * 2;
+                if (layout) {
+                    std::vector<Value> values;
+                    values.reserve(count);
+                    for (size_t i = first + 1; i < stack_.size(); i += 2) {
+                        values.push_back(std::move(stack_[i]));
+                    }
+                    hashMap->data.assign(layout, std::move(values));
+                } else {
+                    for (size_t i = first; i < stack_.size(); i += 2) {
+                        hashMap->set(stack_[i], stack_[i + 1]);
+                    }
+                    layout = hashMap->layoutFor(count);
+                }
+                stack_.resize(first);
+                push(std::move(hashMap));
+                break;
+            }
+            case OpCode::GetIndex: {
+                Value index = pop();
+                Value object = pop();
+                push(interpreter_.indexGet(currentToken(), object, index));
+                break;
+            }
+            case OpCode::SetIndex: {
+                Value value = pop();
+                Value index = pop();
+                Value object = pop();
+                push(interpreter_.indexSet(currentToken(), object, index, value));
+                break;
+            }
+            case OpCode::GetMember: {
+                const std::string& name = chunk->names[readShort()];
+                MethodId method = static_cast<MethodId>(readByte());
+                FieldCache& cache = chunk->fieldCaches[readShort()];
+                Value object = pop();
+                push(interpreter_.memberGet(currentToken(), object, method, name, cache));
+                break;
+            }
+            case OpCode::SetMember: {
+                const std::string& name = chunk->names[readShort()];
+                MethodId method = static_cast<MethodId>(readByte());
+                FieldCache& cache = chunk->fieldCaches[readShort()];
+                Value value = pop();
+                Value object = pop();
+                push(interpreter_.memberSet(currentToken(), object, method, name, value, cache));
+                break;
+            }
+            case OpCode::Invoke: {
+                const std::string& name = chunk->names[readShort()];
+                MethodId method = static_cast<MethodId>(readByte());
+                uint8_t argCount = readByte();
+                FieldCache& cache = chunk->fieldCaches[readShort()];
+                size_t objectSlot = stack_.size() - argCount - 1;
+                std::span<const Value> arguments(stack_.data() + objectSlot + 1, argCount);
+                Value object = stack_[objectSlot];
+                const Token& token = currentToken();
+                saveFrame();
+                Value result = interpreter_.callMethod(token, object, method, name, arguments, cache);
+                loadFrame();
+                stack_.resize(objectSlot);
+                push(std::move(result));
+                break;
+            }
+
+            // Statements
+            case OpCode::Print:
+                std::cout << valueToString(pop()) << "\n";
+                break;
+        }
+    }
+}
+
+} // namespace volt
@@ -0,0 +1,110 @@
+#pragma once
+#include "chunk.h"
+#include "callable.h"
+#include "stmt.h"
+#include "ast.h"
+#include <memory>
+#include <vector>
+
+namespace volt {
+
+class Interpreter;
+class VM;
+
+/**
+ * Upvalue - A variable captured by a closure
+ *
+ * While the variable's frame is alive the upvalue points at its stack
+ * slot ("open"). When the frame goes away the value is copied into the
+ * upvalue itself ("closed"), so the closure keeps working.
+ */
+struct Upvalue : GcObject {
+    size_t slot = 0;
+    Value closed;
+    bool open = true;
+
+    // Open, the value lives on the VM stack, which holds it
+    void trace(Tracer& tracer) const override { tracer(closed); }
+    void clearReferences() override { closed = nullptr; }
+    size_t byteSize() const override { return sizeof(*this); }
+};
+
+using UpvaluePtr = Ref<Upvalue>;
+
+/**
+ * VmClosure - A compiled function plus the upvalues it captured
+ *
+ * Closures are ordinary Callables, so natives and the rest of the
+ * runtime can call them without knowing which engine created them.
+ */
+class VmClosure : public Callable {
+public:
+    VmClosure(VM& vm, FunctionProtoPtr proto);
+
+    Value call(Interpreter& interpreter,
+              std::span<const Value> arguments) override;
+
+    int arity() const override { return proto->arity; }
+    std::string toString() const override;
+    
+    // A recursive closure reaches itself through a closed upvalue
+    void trace(Tracer& tracer) const override {
+        for (const auto& upvalue : upvalues) tracer(upvalue);
+    }
+    void clearReferences() override { upvalues.clear(); }
+    size_t byteSize() const override {
+        return sizeof(*this) + upvalues.capacity() * sizeof(UpvaluePtr);
+    }
+
+    VM& vm;
+    FunctionProtoPtr proto;
+    std::vector<UpvaluePtr> upvalues;
+};
+
+/**
+ * VM - Stack-based bytecode virtual machine
+ *
+ * Runs programs compiled by Compiler. Globals and natives are shared
+ * with the owning Interpreter, and all operator semantics go through
+ * the Interpreter's runtime helpers, so output and error messages match
+ * the tree-walk engine exactly.
+ */
+class VM {
+public:
+    explicit VM(Interpreter& interpreter);
+
+    // Compile and run a program
+    void execute(const std::vector<StmtPtr>& statements);
+
+    // Compile and evaluate a single expression
+    Value evaluate(Expr* expr);
+
+    // Call a closure with already-checked arguments
+    Value call(VmClosure& closure, std::span<const Value> arguments);
+
+    // Print the bytecode of every compiled program before running it
+    void setDumpBytecode(bool dump) { dumpBytecode_ = dump; }
+
+private:
+    struct CallFrame {
+        VmClosure* closure;
+        const uint8_t* ip;
+        size_t base;    // Stack index of slot 0 (the callee)
+    };
+
+    Value runFunction(FunctionProtoPtr proto);
+    Value run(size_t exitDepth);
+
+    UpvaluePtr captureUpvalue(size_t slot);
+    void closeUpvalues(size_t fromSlot);
+
+    static constexpr size_t kMaxFrames = 10000;
+
+    Interpreter& interpreter_;
+    std::vector<Value> stack_;
+    std::vector<CallFrame> frames_;
+    std::vector<UpvaluePtr> openUpvalues_;  // Sorted by slot
+    bool dumpBytecode_ = false;
+};
+
+} // namespace volt
@@ -658,6 +658,359 @@ TEST(Arrays, LenInCondition) {
     EXPECT_EQ(output, "yes\n");
 }
 
+// ========================================
+// NUMERIC BULK OPERATIONS
+// ========================================
+
+TEST(Arrays, SumMinMax) {
+    std::string output = runCode(
+        "let arr = [3, -1, 4, 1, -5, 9, 2];"
+        "print arr.sum();"
+        "print arr.min();"
+        "print arr.max();"
+    );
+    EXPECT_EQ(output, "13\n-5\n9\n");
+}
+
+TEST(Arrays, BulkOpsOnEmptyArray) {
+    std::string output = runCode(
+        "let arr = [];"
+        "print arr.sum();"
+        "print arr.min();"
+        "print arr.max();"
+    );
+    EXPECT_EQ(output, "0\nnil\nnil\n");
+}
+
+TEST(Arrays, DotScaleAndAdd) {
+    std::string output = runCode(
+        "let a = [1, 2, 3, 4, 5];"
+        "let b = [5, 4, 3, 2, 1];"
+        "print a.dot(b);"
+        "print a.scale(2);"
+        "print a.add(b);"
+        "print a;"
+    );
+    EXPECT_EQ(output, "35\n[2, 4, 6, 8, 10]\n[6, 6, 6, 6, 6]\n[1, 2, 3, 4, 5]\n");
+}
+
+TEST(Arrays, BulkOpsOnLargeArray) {
+    std::string output = runCode(
+        "let arr = [];"
+        "for (let i = 1; i <= 1001; i = i + 1) arr.push(i);"
+        "print arr.sum();"
+        "print arr.min();"
+        "print arr.max();"
+        "print arr.dot(arr.scale(0).add(arr));"
+    );
+    EXPECT_EQ(output, "501501\n1\n1001\n334835501\n");
+}
+
+TEST(Arrays, BulkOpsNeedNumbers) {
+    EXPECT_EQ(runCode("print [1, \"two\", 3].sum();"), "RUNTIME_ERROR");
+    EXPECT_EQ(runCode("print [1, 2].dot([1, 2, 3]);"), "RUNTIME_ERROR");
+    EXPECT_EQ(runCode("print [1, 2].add(3);"), "RUNTIME_ERROR");
+    EXPECT_EQ(runCode("print [1, 2].scale(\"x\");"), "RUNTIME_ERROR");
+}
+
+TEST(Arrays, BulkOpsFollowWritesThatChangeTheContents) {
+    std::string output = runCode(
+        "let arr = [1, 2, 3];"
+        "arr[1] = \"two\";"
+        "arr[1] = 20;"
+        "arr.push(nil);"
+        "arr.pop();"
+        "print arr.sum();"
+    );
+    EXPECT_EQ(output, "24\n");
+}
+
+// ========================================
+// SLICING, SEARCHING AND EDITING METHODS
+// ========================================
+
+TEST(Arrays, SliceAndConcat) {
+    std::string output = runCode(
+        "let arr = [1, 2, 3, 4, 5];"
+        "print arr.slice(1, 3);"
+        "print arr.slice(-2, 5);"
+        "print arr.slice(3, 1);"
+        "print arr.slice(0, 99);"
+        "print arr.concat([6, \"seven\"]);"
+        "print arr;"
+    );
+    EXPECT_EQ(output, "[2, 3]\n[4, 5]\n[]\n[1, 2, 3, 4, 5]\n[1, 2, 3, 4, 5, 6, seven]\n[1, 2, 3, 4, 5]\n");
+}
+
+TEST(Arrays, IndexOfAndIncludes) {
+    std::string output = runCode(
+        "let arr = [1, \"two\", nil, true];"
+        "print arr.indexOf(\"two\");"
+        "print arr.indexOf(nil);"
+        "print arr.indexOf(3);"
+        "print arr.includes(true);"
+        "print arr.includes(false);"
+    );
+    EXPECT_EQ(output, "1\n2\n-1\ntrue\nfalse\n");
+}
+
+TEST(Arrays, Join) {
+    std::string output = runCode(
+        "print [1, \"b\", 2.5, nil].join(\", \");"
+        "print [].join(\"-\");"
+        "print [\"solo\"].join(\"-\");"
+    );
+    EXPECT_EQ(output, "1, b, 2.5, nil\n\nsolo\n");
+}
+
+TEST(Arrays, SpliceAndInsert) {
+    std::string output = runCode(
+        "let arr = [1, 2, 3, 4, 5];"
+        "print arr.splice(1, 2);"
+        "print arr;"
+        "print arr.splice(-1, 10);"
+        "arr.insert(1, \"x\");"
+        "arr.insert(99, \"end\");"
+        "print arr;"
+        "print arr.length;"
+    );
+    EXPECT_EQ(output, "[2, 3]\n[1, 4, 5]\n[5]\n[1, x, 4, end]\n4\n");
+}
+
+TEST(Arrays, FillAndArrayConstructor) {
+    std::string output = runCode(
+        "let arr = Array(3, 0);"
+        "print arr;"
+        "print arr.fill(7);"
+        "print arr.sum();"
+        "print Array(0, nil);"
+        "let grid = Array(2, nil);"
+        "grid[0] = Array(2, 1);"
+        "print grid;"
+    );
+    EXPECT_EQ(output, "[0, 0, 0]\n[7, 7, 7]\n21\n[]\n[[1, 1], nil]\n");
+}
+
+TEST(Arrays, EditingMethodsKeepBulkOpsCorrect) {
+    std::string output = runCode(
+        "let arr = [1, 2, 3];"
+        "arr.insert(0, \"x\");"
+        "print arr.splice(0, 1);"
+        "print arr.sum();"
+        "print arr.concat([4]).sum();"
+    );
+    EXPECT_EQ(output, "[x]\n6\n10\n");
+}
+
+TEST(Arrays, EditingMethodsCheckTheirArguments) {
+    EXPECT_EQ(runCode("print [1, 2].slice(0.5, 1);"), "RUNTIME_ERROR");
+    EXPECT_EQ(runCode("print [1, 2].splice(0, -1);"), "RUNTIME_ERROR");
+    EXPECT_EQ(runCode("print [1, 2].concat(3);"), "RUNTIME_ERROR");
+    EXPECT_EQ(runCode("print [1, 2].join(1);"), "RUNTIME_ERROR");
+    EXPECT_EQ(runCode("print Array(-1, 0);"), "RUNTIME_ERROR");
+}
+
+// ========================================
+// SORTING
+// ========================================
+
+TEST(Arrays, SortNumbersAndStrings) {
+    std::string output = runCode(
+        "let nums = [5, -2, 3.5, 0, 10, -7];"
+        "print nums.sort();"
+        "print nums;"
+        "let words = [\"pear\", \"Apple\", \"fig\", \"apple\"];"
+        "words.sort();"
+        "print words;"
+        "print [].sort();"
+    );
+    EXPECT_EQ(output, "[-7, -2, 0, 3.5, 5, 10]\n[-7, -2, 0, 3.5, 5, 10]\n"
+                      "[Apple, apple, fig, pear]\n[]\n");
+}
+
+TEST(Arrays, SortLargeNumericArray) {
+    std::string output = runCode(
+        "let arr = [];"
+        "for (let i = 0; i < 1000; i++) arr.push((i * 7919) % 1000);"
+        "arr.sort();"
+        "let ordered = true;"
+        "for (let i = 1; i < arr.length; i++) { if (arr[i - 1] > arr[i]) ordered = false; }"
+        "print ordered;"
+        "print arr[0];"
+        "print arr[999];"
+    );
+    EXPECT_EQ(output, "true\n0\n999\n");
+}
+
+TEST(Arrays, SortWithComparator) {
+    std::string output = runCode(
+        "fn descending(a, b) { return b - a; }"
+        "let arr = [3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5];"
+        "print arr.sort(descending);"
+        "fn byLength(a, b) { return len(a) - len(b); }"
+        "print [\"ccc\", \"a\", \"bb\", \"b\", \"aaa\", \"c\"].sort(byLength);"
+    );
+    // Stable: equal lengths keep their original order
+    EXPECT_EQ(output, "[9, 6, 5, 5, 5, 4, 3, 3, 2, 1, 1]\n[a, b, c, bb, ccc, aaa]\n");
+}
+
+TEST(Arrays, SortMixedValuesNeedsAComparator) {
+    EXPECT_EQ(runCode("print [1, \"a\"].sort();"), "RUNTIME_ERROR");
+    EXPECT_EQ(runCode("print [nil, true].sort();"), "RUNTIME_ERROR");
+    EXPECT_EQ(runCode("fn one(a) { return 0; } print [2, 1].sort(one);"), "RUNTIME_ERROR");
+    EXPECT_EQ(runCode("fn bad(a, b) { return \"x\"; } print [2, 1].sort(bad);"), "RUNTIME_ERROR");
+}
+
+TEST(Arrays, SortSurvivesInconsistentComparators) {
+    std::string output = runCode(
+        "let arr = [];"
+        "for (let i = 0; i < 200; i++) arr.push(i);"
+        "fn chaos(a, b) { return random() - 0.5; }"
+        "arr.sort(chaos);"
+        "print arr.length;"
+        "print arr.sum();"
+    );
+    EXPECT_EQ(output, "200\n19900\n");
+}
+
+TEST(Arrays, SortByComputesKeysOnce) {
+    std::string output = runCode(
+        "let calls = 0;"
+        "fn age(person) { calls = calls + 1; return person[\"age\"]; }"
+        "fn name(person) { return person[\"name\"]; }"
+        "let people = [{\"name\": \"Cy\", \"age\": 40}, {\"name\": \"Al\", \"age\": 30},"
+        "              {\"name\": \"Bo\", \"age\": 40}, {\"name\": \"Di\", \"age\": 20}];"
+        "people.sortBy(age);"
+        "print people.map(name);"
+        "print calls;"
+        "people.sortBy(name);"
+        "print people.map(name);"
+    );
+    EXPECT_EQ(output, "[Di, Al, Cy, Bo]\n4\n[Al, Bo, Cy, Di]\n");
+}
+
+TEST(Arrays, SortByNeedsComparableKeys) {
+    EXPECT_EQ(runCode("fn id(x) { return x; } print [1, \"a\"].sortBy(id);"), "RUNTIME_ERROR");
+}
+
+// ========================================
+// HIGHER-ORDER METHODS
+// ========================================
+
+TEST(Arrays, MapAndFilter) {
+    std::string output = runCode(
+        "fn square(x) { return x * x; }"
+        "fn isEven(x) { return x % 2 == 0; }"
+        "let arr = [1, 2, 3, 4, 5];"
+        "print arr.map(square);"
+        "print arr.filter(isEven);"
+        "print arr;"
+    );
+    EXPECT_EQ(output, "[1, 4, 9, 16, 25]\n[2, 4]\n[1, 2, 3, 4, 5]\n");
+}
+
+TEST(Arrays, CallbacksMayTakeTheIndex) {
+    std::string output = runCode(
+        "fn label(x, i) { return str(i) + \":\" + x; }"
+        "fn oddIndex(x, i) { return i % 2 == 1; }"
+        "fn sumWithIndex(total, x, i) { return total + x * i; }"
+        "let arr = [\"a\", \"b\", \"c\"];"
+        "print arr.map(label);"
+        "print arr.filter(oddIndex);"
+        "print [1, 2, 3].reduce(sumWithIndex, 0);"
+    );
+    EXPECT_EQ(output, "[0:a, 1:b, 2:c]\n[b]\n8\n");
+}
+
+TEST(Arrays, Reduce) {
+    std::string output = runCode(
+        "fn add(total, x) { return total + x; }"
+        "fn join(text, x) { return text + str(x); }"
+        "print [1, 2, 3, 4].reduce(add, 10);"
+        "print [].reduce(add, 10);"
+        "print [1, 2, 3].reduce(join, \"\");"
+    );
+    EXPECT_EQ(output, "20\n10\n123\n");
+}
+
+TEST(Arrays, ForEachFindSomeEvery) {
+    std::string output = runCode(
+        "let total = 0;"
+        "fn accumulate(x) { total = total + x; }"
+        "print [1, 2, 3, 4].forEach(accumulate);"
+        "print total;"
+    );
+    EXPECT_EQ(output, "nil\n10\n");
+
+    output = runCode(
+        "fn big(x) { return x > 2; }"
+        "fn huge(x) { return x > 100; }"
+        "fn positive(x) { return x > 0; }"
+        "let arr = [1, 2, 3, 4];"
+        "print arr.find(big);"
+        "print arr.findIndex(big);"
+        "print arr.find(huge);"
+        "print arr.findIndex(huge);"
+        "print arr.some(big);"
+        "print arr.some(huge);"
+        "print arr.every(positive);"
+        "print arr.every(big);"
+        "print [].every(huge);"
+    );
+    EXPECT_EQ(output, "3\n2\nnil\n-1\ntrue\nfalse\ntrue\nfalse\ntrue\n");
+}
+
+TEST(Arrays, FindStopsAtTheFirstMatch) {
+    std::string output = runCode(
+        "let calls = 0;"
+        "fn big(x) { calls = calls + 1; return x > 1; }"
+        "print [1, 2, 3, 4].find(big);"
+        "print calls;"
+    );
+    EXPECT_EQ(output, "2\n2\n");
+}
+
+TEST(Arrays, CallbacksCanChangeTheArray) {
+    std::string output = runCode(
+        "let arr = [1, 2, 3];"
+        "fn grow(x) { arr.push(x); return x; }"
+        "print arr.map(grow);"
+        "print arr;"
+        "fn shrink(x) { arr.pop(); return x; }"
+        "print arr.map(shrink);"
+    );
+    EXPECT_EQ(output, "[1, 2, 3]\n[1, 2, 3, 1, 2, 3]\n[1, 2, 3]\n");
+}
+
+TEST(Arrays, HigherOrderMethodsNest) {
+    std::string output = runCode(
+        "fn double(x) { return x * 2; }"
+        "fn doubleRow(row) { return row.map(double); }"
+        "fn add(total, x) { return total + x; }"
+        "fn rowSum(total, row) { return total + row.reduce(add, 0); }"
+        "let grid = [[1, 2], [3, 4]];"
+        "print grid.map(doubleRow);"
+        "print grid.reduce(rowSum, 0);"
+    );
+    EXPECT_EQ(output, "[[2, 4], [6, 8]]\n10\n");
+}
+
+TEST(Arrays, HigherOrderMethodsAcceptNatives) {
+    std::string output = runCode(
+        "print [4, 9, 16].map(sqrt);"
+        "let f = [3, 2, 1].map;"
+        "print f(str);"
+    );
+    EXPECT_EQ(output, "[2, 3, 4]\n[3, 2, 1]\n");
+}
+
+TEST(Arrays, HigherOrderMethodsCheckTheCallback) {
+    EXPECT_EQ(runCode("print [1, 2].map(5);"), "RUNTIME_ERROR");
+    EXPECT_EQ(runCode("fn none() { return 1; } print [1, 2].map(none);"), "RUNTIME_ERROR");
+    EXPECT_EQ(runCode("fn one(x) { return x; } print [1, 2].reduce(one, 0);"), "RUNTIME_ERROR");
+    EXPECT_EQ(runCode("fn add(a, b) { return a + b; } print [1].reduce(add);"), "RUNTIME_ERROR");
+}
+
 // ========================================
 // EDGE CASES AND ERROR HANDLING
 // ========================================
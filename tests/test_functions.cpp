@@ -407,3 +407,101 @@ TEST(Functions, ComposeFunctions) {
     );
     EXPECT_EQ(output, "12\n");
 }
+
+// ========================================
+// TAIL CALL TESTS
+// ========================================
+
+TEST(Functions, TailRecursionRunsInConstantStack) {
+    // Far deeper than either the C++ stack or the VM's frame limit allows
+    std::string output = runCode(
+        "fn sum(n, total) {"
+        "  if (n == 0) return total;"
+        "  return sum(n - 1, total + n);"
+        "}"
+        "print sum(1000000, 0);"
+    );
+    EXPECT_EQ(output, "500000500000\n");
+}
+
+TEST(Functions, MutualTailCalls) {
+    std::string output = runCode(
+        "fn isEven(n) { if (n == 0) return true; return isOdd(n - 1); }"
+        "fn isOdd(n) { if (n == 0) return false; return isEven(n - 1); }"
+        "print isEven(300001);"
+        "print isOdd(300001);"
+    );
+    EXPECT_EQ(output, "false\ntrue\n");
+}
+
+TEST(Functions, TailCallsKeepCapturedFrames) {
+    // Closures made before a tail call still see their own variables
+    std::string output = runCode(
+        "fn collect(n, prev) {"
+        "  fn get() { return n; }"
+        "  if (n == 3) return [prev(), get()];"
+        "  return collect(n + 1, get);"
+        "}"
+        "fn none() { return 0; }"
+        "let pair = collect(0, none);"
+        "print pair[0];"
+        "print pair[1];"
+    );
+    EXPECT_EQ(output, "2\n3\n");
+}
+
+TEST(Functions, TailCallsToNativesAndErrors) {
+    EXPECT_EQ(runCode("fn root(x) { return sqrt(x); } print root(16);"), "4\n");
+    EXPECT_EQ(runCode("fn f(a) { return f(); } f(1);"), "RUNTIME_ERROR");
+    EXPECT_EQ(runCode("fn f() { let x = 1; return x(); } f();"), "RUNTIME_ERROR");
+}
+
+// ========================================
+// FRAME POOL TESTS
+// ========================================
+
+TEST(Functions, CallsReuseTheirFrames) {
+    // Functions point into their program, so keep each one alive
+    std::vector<std::vector<volt::StmtPtr>> programs;
+    volt::Interpreter interpreter(volt::Engine::Ast);
+    auto run = [&](const std::string& source) {
+        volt::Lexer lexer(source);
+        volt::Parser parser(lexer.tokenize());
+        programs.push_back(parser.parseProgram());
+        interpreter.execute(programs.back());
+    };
+
+    PrintCapture capture;
+    run("fn dummy(n) { let result = n * n; if (n > 0) { return result; } return 0; }"
+        "let total = 0;"
+        "for (let i = 0; i < 100; i++) { total = total + dummy(i); }"
+        "print total;");
+    size_t pooled = interpreter.pooledScopeCount();
+    EXPECT_GT(pooled, 0u);
+    EXPECT_LE(pooled, 8u);  // A handful of scopes cycled, not one per call
+
+    run("for (let i = 0; i < 100; i++) { dummy(i); }");
+    EXPECT_EQ(interpreter.pooledScopeCount(), pooled);
+    EXPECT_EQ(capture.get(), "328350\n");
+}
+
+TEST(Functions, CapturedFramesAreNotRecycled) {
+    // Each counter keeps its own frame even though calls in between
+    // recycle every frame nothing captured
+    std::string output = runCode(
+        "fn makeCounter(start) {"
+        "  let count = start;"
+        "  fn next() { count = count + 1; return count; }"
+        "  return next;"
+        "}"
+        "fn noise(a, b, c) { let d = a + b + c; return d; }"
+        "let first = makeCounter(0);"
+        "noise(1, 2, 3);"
+        "let second = makeCounter(100);"
+        "noise(4, 5, 6);"
+        "print first();"
+        "print second();"
+        "print first();"
+    );
+    EXPECT_EQ(output, "1\n101\n2\n");
+}
@@ -0,0 +1,227 @@
+#include <gtest/gtest.h>
+#include "lexer.h"
+#include "parser.h"
+#include "interpreter.h"
+#include "gc.h"
+#include "features/array.h"
+#include "features/hashmap.h"
+#include <sstream>
+#include <iostream>
+
+using namespace volt;
+
+namespace {
+
+class PrintCapture {
+public:
+    PrintCapture() : old(std::cout.rdbuf(buffer.rdbuf())) {}
+    ~PrintCapture() { std::cout.rdbuf(old); }
+    std::string get() { return buffer.str(); }
+private:
+    std::stringstream buffer;
+    std::streambuf* old;
+};
+
+// Runs source in an interpreter that lives as long as the call; returns
+// the output and, through liveDuring, the GcObjects alive at the end of
+// the program (before the interpreter is torn down)
+std::string run(const std::string& source, Engine engine, size_t* liveDuring = nullptr) {
+    PrintCapture capture;
+    Lexer lexer(source);
+    Parser parser(lexer.tokenize());
+    auto statements = parser.parseProgram();
+    if (parser.hadError()) return "PARSE_ERROR";
+
+    Interpreter interpreter(engine);
+    interpreter.execute(statements);
+    if (liveDuring) *liveDuring = Collector::trackedCount();
+    return capture.get();
+}
+
+const Engine kEngines[] = {Engine::Ast, Engine::Vm};
+
+} // anonymous namespace
+
+// ========================================
+// CYCLES
+// ========================================
+
+TEST(GC, FreesSelfContainingArray) {
+    Collector::collect();
+    size_t before = Collector::trackedCount();
+    {
+        auto array = makeRef<VoltArray>();
+        array->push(Value(array));
+    }
+    EXPECT_EQ(Collector::trackedCount(), before + 1);  // Refcounting can't free it
+    EXPECT_EQ(Collector::collect(), 1u);
+    EXPECT_EQ(Collector::trackedCount(), before);
+}
+
+TEST(GC, FreesMapArrayCycle) {
+    Collector::collect();
+    size_t before = Collector::trackedCount();
+    {
+        auto map = makeRef<VoltHashMap>();
+        auto array = makeRef<VoltArray>();
+        array->push(Value(map));
+        map->set("items", Value(array));
+    }
+    EXPECT_EQ(Collector::collect(), 2u);
+    EXPECT_EQ(Collector::trackedCount(), before);
+}
+
+TEST(GC, KeepsObjectsHeldOutsideTheHeap) {
+    Collector::collect();
+    auto array = makeRef<VoltArray>();
+    auto inner = makeRef<VoltArray>();
+    array->push(Value(array));
+    array->push(Value(inner));
+    inner->push(Value(42.0));
+
+    // A C++ local is a root like any other: nothing to register
+    EXPECT_EQ(Collector::collect(), 0u);
+    ASSERT_EQ(array->length(), 2u);
+    EXPECT_EQ(asArray(array->get(1))->get(0), Value(42.0));
+}
+
+// ========================================
+// GENERATIONS
+// ========================================
+
+TEST(GC, NurseryFreesShortLivedCycles) {
+    Collector::collect();
+    size_t before = Collector::trackedCount();
+    size_t collections = Collector::stats().collections;
+    for (size_t i = 0; i < Collector::kNurserySize; i++) {
+        auto array = makeRef<VoltArray>();
+        array->push(Value(array));
+    }
+    Collector::safepoint();
+    EXPECT_EQ(Collector::stats().collections, collections + 1);
+    EXPECT_EQ(Collector::stats().lastFreed, Collector::kNurserySize);
+    EXPECT_EQ(Collector::youngCount(), 0u);
+    EXPECT_EQ(Collector::trackedCount(), before);
+}
+
+TEST(GC, NurserySurvivorsArePromoted) {
+    Collector::collect();
+    size_t old = Collector::oldCount();
+    std::vector<Ref<VoltArray>> kept;
+    for (size_t i = 0; i < Collector::kNurserySize; i++) kept.push_back(makeRef<VoltArray>());
+    Collector::safepoint();
+    EXPECT_EQ(Collector::youngCount(), 0u);
+    EXPECT_EQ(Collector::oldCount(), old + Collector::kNurserySize);
+    EXPECT_GE(Collector::stats().lastBytesPromoted, Collector::kNurserySize * sizeof(VoltArray));
+}
+
+TEST(GC, OldGenerationIsCollectedInSlices) {
+    Collector::collect();
+    size_t before = Collector::trackedCount();
+
+    // Promote cyclic garbage-to-be, then let go of it
+    const size_t count = 4 * Collector::kMinOldThreshold;
+    {
+        std::vector<Ref<VoltArray>> kept;
+        for (size_t i = 0; i < count; i++) {
+            kept.push_back(makeRef<VoltArray>());
+            kept.back()->push(Value(kept.back()));
+            if (Collector::youngCount() >= Collector::kNurserySize) Collector::safepoint();
+        }
+        Collector::safepoint();
+    }
+    ASSERT_GE(Collector::oldCount(), count);
+
+    // Live data doubles the old generation, which starts a pass over it
+    Collector::setPauseBudget(0.001);
+    size_t passes = Collector::stats().oldPasses;
+    std::vector<Ref<VoltArray>> live;
+    for (size_t target = 2 * Collector::oldCount(); Collector::oldCount() < target;) {
+        for (size_t i = 0; i < Collector::kNurserySize; i++) live.push_back(makeRef<VoltArray>());
+        Collector::safepoint();
+    }
+
+    // Each nursery collection then takes a slice of it
+    size_t steps = 0;
+    while (Collector::stats().oldPasses == passes && steps < 10000) {
+        std::vector<Ref<VoltArray>> young;
+        for (size_t i = 0; i < Collector::kNurserySize; i++) young.push_back(makeRef<VoltArray>());
+        Collector::safepoint();
+        steps++;
+    }
+    Collector::setPauseBudget(0);
+
+    EXPECT_GT(steps, 1u);
+    EXPECT_EQ(Collector::stats().oldPasses, passes + 1);
+    EXPECT_EQ(Collector::trackedCount(), before + live.size());
+}
+
+TEST(GC, StatsAreVisibleToScripts) {
+    const std::string source =
+        "let s = gcStats();"
+        "print s.collections >= 0;"
+        "print s.liveBytes > 0;"
+        "print s.pauseBudgetMs;"
+        "print has(s, \"maxPauseMs\") && has(s, \"bytesPromoted\");";
+    for (Engine engine : kEngines) {
+        EXPECT_EQ(run(source, engine), "true\ntrue\n0\ntrue\n");
+    }
+}
+
+// ========================================
+// PROGRAMS
+// ========================================
+
+TEST(GC, RecursiveClosuresAreFreedByTeardown) {
+    const std::string source =
+        "fn makeCountdown() {"
+        "  fn down(n) { if (n > 0) { return down(n - 1); } return \"done\"; }"
+        "  return down;"
+        "}"
+        "for (let i = 0; i < 100; i++) { makeCountdown(); }"
+        "print makeCountdown()(5);";
+    for (Engine engine : kEngines) {
+        Collector::collect();
+        size_t before = Collector::trackedCount();
+        EXPECT_EQ(run(source, engine), "done\n");
+        EXPECT_EQ(Collector::trackedCount(), before);
+    }
+}
+
+TEST(GC, CyclicGarbageStaysBoundedWhileRunning) {
+    const std::string source =
+        "let count = 0;"
+        "for (let i = 0; i < 50000; i++) {"
+        "  let a = [i];"
+        "  a.push(a);"
+        "  let m = {\"self\": nil};"
+        "  m[\"self\"] = m;"
+        "  count = count + 1;"
+        "}"
+        "print count;";
+    for (Engine engine : kEngines) {
+        Collector::collect();
+        size_t before = Collector::trackedCount();
+        size_t live = 0;
+        EXPECT_EQ(run(source, engine, &live), "50000\n");
+        EXPECT_LT(live - before, 2 * Collector::kNurserySize);
+        EXPECT_EQ(Collector::trackedCount(), before);
+    }
+}
+
+TEST(GC, LiveDataSurvivesCollections) {
+    // Enough garbage to force collections while the list is being built
+    const std::string source =
+        "let list = [];"
+        "for (let i = 0; i < 30000; i++) {"
+        "  let node = {\"value\": i};"
+        "  node[\"self\"] = node;"
+        "  if (i % 1000 == 0) { list.push(node); }"
+        "}"
+        "let sum = 0;"
+        "for (let i = 0; i < list.length; i++) { sum = sum + list[i][\"self\"][\"value\"]; }"
+        "print sum;";
+    for (Engine engine : kEngines) {
+        EXPECT_EQ(run(source, engine), "435000\n");
+    }
+}
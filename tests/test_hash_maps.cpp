@@ -99,6 +99,38 @@ TEST(HashMap, NumberKeys) {
     EXPECT_EQ(output, "one\ntwo\nthree_point_five\n");
 }
 
+TEST(HashMap, FractionalKeysReadBackWhatWasWritten) {
+    std::string code = R"(
+        let map = {};
+        map[0.1] = "tenth";
+        map[2.5] = "two and a half";
+        map[1] = "one";
+        print map[0.1];
+        print map["2.5"];
+        print map["1"];
+        map["1"] = "uno";
+        print map[1];
+        print map.size;
+    )";
+    
+    std::string output = runCode(code);
+    EXPECT_EQ(output, "tenth\ntwo and a half\none\nuno\n3\n");
+}
+
+TEST(HashMap, BoolAndNilKeys) {
+    std::string code = R"(
+        let map = {true: "yes", nil: "none"};
+        map[false] = "no";
+        print map[true];
+        print map["nil"];
+        print map[false];
+        print has(map, "false");
+    )";
+    
+    std::string output = runCode(code);
+    EXPECT_EQ(output, "yes\nnone\nno\ntrue\n");
+}
+
 // ==================== HASH MAP ACCESS TESTS ====================
 
 TEST(HashMap, AccessNonexistentKey) {
@@ -308,6 +340,129 @@ TEST(HashMap, NonEmptyHashMapTruthiness) {
     EXPECT_EQ(output, "truthy\n");
 }
 
+// ==================== ITERATION ORDER ====================
+
+TEST(HashMap, KeysKeepInsertionOrder) {
+    std::string code = R"(
+        let map = {"zebra": 1, "apple": 2, "mango": 3};
+        map["banana"] = 4;
+        map["apple"] = 20;
+        print map;
+        print map.keys();
+        print map.values();
+    )";
+    
+    std::string output = runCode(code);
+    EXPECT_EQ(output,
+              "{\"zebra\": 1, \"apple\": 20, \"mango\": 3, \"banana\": 4}\n"
+              "[zebra, apple, mango, banana]\n"
+              "[1, 20, 3, 4]\n");
+}
+
+TEST(HashMap, RemovedKeysComeBackAtTheEnd) {
+    std::string code = R"(
+        let map = {"a": 1, "b": 2, "c": 3};
+        map.remove("a");
+        map["a"] = 10;
+        print map.keys();
+        print map.size;
+    )";
+    
+    std::string output = runCode(code);
+    EXPECT_EQ(output, "[b, c, a]\n3\n");
+}
+
+TEST(HashMap, ManyInsertsAndRemoves) {
+    std::string code = R"(
+        let map = {};
+        for (let i = 0; i < 2000; i++) map[str(i)] = i;
+        for (let i = 0; i < 2000; i = i + 2) map.remove(str(i));
+        let total = 0;
+        for (let i = 0; i < 2000; i++) { if (map.has(str(i))) total = total + map[str(i)]; }
+        print map.size;
+        print total;
+        print map.keys()[0];
+    )";
+    
+    std::string output = runCode(code);
+    EXPECT_EQ(output, "1000\n1000000\n1\n");
+}
+
+// ==================== FIELD ACCESS ====================
+
+TEST(HashMap, DotReadsAndWritesFields) {
+    std::string code = R"(
+        let account = {"owner": "Ann", "balance": 100};
+        account.balance = account.balance - 30;
+        account.frozen = false;
+        print account.owner;
+        print account.balance;
+        print account["balance"];
+        print account;
+        print account.missing;
+    )";
+    
+    std::string output = runCode(code);
+    EXPECT_EQ(output, "Ann\n70\n70\n{\"owner\": Ann, \"balance\": 70, \"frozen\": false}\nnil\n");
+}
+
+TEST(HashMap, FieldSitesSeeEveryRecordLayout) {
+    // One site reading records of different layouts, then a record that
+    // lost a key (and so its shared layout)
+    std::string code = R"(
+        fn describe(p) { return p.name + ":" + str(p.age); }
+        let a = {"name": "a", "age": 1};
+        let b = {"age": 2, "name": "b"};
+        let c = {"name": "c", "age": 3, "city": "x"};
+        let d = {"name": "d", "age": 4, "city": "y"};
+        d.remove("city");
+        for (let i = 0; i < 3; i++) {
+            print describe(a) + " " + describe(b) + " " + describe(c) + " " + describe(d);
+        }
+        a.age = 10;
+        print describe(a) + " " + describe({"name": "e", "age": 5});
+    )";
+    
+    std::string output = runCode(code);
+    EXPECT_EQ(output,
+              "a:1 b:2 c:3 d:4\n"
+              "a:1 b:2 c:3 d:4\n"
+              "a:1 b:2 c:3 d:4\n"
+              "a:10 e:5\n");
+}
+
+TEST(HashMap, FieldsHoldingFunctionsCanBeCalled) {
+    std::string code = R"(
+        fn greet(name) { return "hi " + name; }
+        let api = {"greet": greet};
+        print api.greet("bob");
+        print api.size;
+    )";
+    
+    std::string output = runCode(code);
+    EXPECT_EQ(output, "hi bob\n1\n");
+}
+
+TEST(HashMap, BuiltInMembersCannotBeAssigned) {
+    std::string code = R"(
+        let map = {};
+        map.size = 3;
+    )";
+    
+    std::string output = runCode(code);
+    EXPECT_EQ(output, "RUNTIME_ERROR: Cannot assign to built-in hash map member: size");
+}
+
+TEST(HashMap, OnlyHashMapsHaveFields) {
+    std::string code = R"(
+        let arr = [1, 2];
+        arr.first = 1;
+    )";
+    
+    std::string output = runCode(code);
+    EXPECT_EQ(output, "RUNTIME_ERROR: Only hash maps have fields");
+}
+
 // ==================== PRACTICAL EXAMPLES ====================
 
 TEST(HashMap, StudentRecord) {
@@ -2,6 +2,7 @@
 #include "lexer.h"
 #include "parser.h"
 #include "interpreter.h"
+#include "resolver.h"
 #include "value.h"
 #include <sstream>
 #include <iostream>
@@ -715,3 +716,362 @@ TEST(Interpreter, NestedForAndWhile) {
     );
     EXPECT_EQ(output, "0\n1\n10\n11\n");
 }
+
+// ========================================
+// RESOLVER TESTS
+// ========================================
+
+TEST(Interpreter, UndefinedVariableReportedBeforeRunning) {
+    PrintCapture capture;
+    volt::Lexer lexer("print \"start\"; fn f() { return missing; } print f();");
+    auto tokens = lexer.tokenize();
+    volt::Parser parser(tokens);
+    auto statements = parser.parseProgram();
+    
+    volt::Interpreter interpreter;
+    try {
+        interpreter.execute(statements);
+        FAIL() << "expected a RuntimeError";
+    } catch (const volt::RuntimeError& e) {
+        EXPECT_NE(std::string(e.what()).find("missing"), std::string::npos);
+        EXPECT_EQ(e.token.line, 1);
+    }
+    EXPECT_EQ(capture.get(), "");
+}
+
+TEST(Interpreter, GlobalsUsedBeforeTheirDeclaration) {
+    std::string output = runCode(
+        "fn bump() { count = count + 1; return count; }"
+        "let count = 10;"
+        "bump();"
+        "print bump();"
+    );
+    EXPECT_EQ(output, "12\n");
+}
+
+TEST(Interpreter, ShadowingResolvesToInnermostScope) {
+    std::string output = runCode(
+        "let x = \"global\";"
+        "{"
+        "  print x;"
+        "  let x = \"outer\";"
+        "  {"
+        "    let x = x + \"-inner\";"
+        "    print x;"
+        "  }"
+        "  print x;"
+        "}"
+        "print x;"
+    );
+    EXPECT_EQ(output, "global\nouter-inner\nouter\nglobal\n");
+}
+
+TEST(Interpreter, NestedClosuresReachOuterSlots) {
+    std::string output = runCode(
+        "fn outer(a) {"
+        "  let b = a * 2;"
+        "  fn middle(c) {"
+        "    fn inner() { b = b + 1; return a + b + c; }"
+        "    return inner;"
+        "  }"
+        "  return middle(100);"
+        "}"
+        "let f = outer(1);"
+        "print f();"
+        "print f();"
+    );
+    EXPECT_EQ(output, "104\n105\n");
+}
+
+TEST(Interpreter, MutualRecursionInBlock) {
+    std::string output = runCode(
+        "{"
+        "  fn isEven(n) { if (n == 0) return true; return isOdd(n - 1); }"
+        "  fn isOdd(n) { if (n == 0) return false; return isEven(n - 1); }"
+        "  print isEven(10);"
+        "  print isOdd(7);"
+        "}"
+    );
+    EXPECT_EQ(output, "true\ntrue\n");
+}
+
+TEST(Interpreter, LoopBodyVariablesAreFreshEachIteration) {
+    std::string output = runCode(
+        "let fns = [];"
+        "for (let i = 0; i < 3; i++) {"
+        "  let seen;"
+        "  print seen;"
+        "  seen = i;"
+        "  if (i == 1) { fn get() { return seen; } fns.push(get); }"
+        "}"
+        "print fns[0]();"
+    );
+    EXPECT_EQ(output, "nil\nnil\nnil\n1\n");
+}
+
+TEST(Interpreter, ReturnFromInsideNestedLoops) {
+    std::string output = runCode(
+        "fn find(target) {"
+        "  for (let i = 0; i < 5; i++) {"
+        "    let j = 0;"
+        "    while (true) {"
+        "      if (i * 10 + j == target) { return [i, j]; }"
+        "      j++;"
+        "      if (j > 4) break;"
+        "    }"
+        "  }"
+        "  return nil;"
+        "}"
+        "print find(32);"
+        "print find(99);"
+    );
+    EXPECT_EQ(output, "[3, 2]\nnil\n");
+}
+
+TEST(Interpreter, BreakOutsideLoopIsRejectedBeforeRunning) {
+    EXPECT_EQ(runCode("print 1; break;"), "RUNTIME_ERROR");
+    EXPECT_EQ(runCode("while (true) { fn f() { continue; } break; }"), "RUNTIME_ERROR");
+}
+
+// ========================================
+// GLOBAL INLINE CACHE TESTS
+// ========================================
+
+namespace {
+
+std::vector<volt::StmtPtr> parseProgram(const std::string& source) {
+    volt::Lexer lexer(source);
+    auto tokens = lexer.tokenize();
+    volt::Parser parser(tokens);
+    return parser.parseProgram();
+}
+
+} // anonymous namespace
+
+TEST(Interpreter, CachedCallSitesSeeRedefinedGlobals) {
+    // Like the REPL: one program keeps running while globals are redefined
+    PrintCapture capture;
+    volt::Interpreter interpreter;
+    auto first = parseProgram("fn f() { return 1; }");
+    auto caller = parseProgram("for (let i = 0; i < 3; i++) { print f() + len(\"ab\"); }");
+    auto redefine = parseProgram("fn f() { return 10; } fn len(s) { return 0; }");
+
+    interpreter.execute(first);
+    interpreter.execute(caller);
+    interpreter.execute(redefine);
+    interpreter.execute(caller);
+    EXPECT_EQ(capture.get(), "3\n3\n3\n10\n10\n10\n");
+}
+
+TEST(Interpreter, CachedCallSitesFollowTheirInterpreter) {
+    // The same AST run by two interpreters must not share cached globals
+    PrintCapture capture;
+    auto program = parseProgram("print who;");
+    volt::Interpreter first;
+    volt::Interpreter second;
+    first.execute(parseProgram("let who = \"first\";"));
+    second.execute(parseProgram("let who = \"second\";"));
+
+    first.execute(program);
+    second.execute(program);
+    first.reset();
+    first.execute(parseProgram("let who = \"reset\";"));
+    first.execute(program);
+    EXPECT_EQ(capture.get(), "first\nsecond\nreset\n");
+}
+
+// ========================================
+// QUICKENED NODE TESTS
+// ========================================
+
+TEST(Interpreter, QuickenedSitesFallBackWhenTypesChange) {
+    // Each site warms up on one type, then sees another
+    EXPECT_EQ(runCode(R"(
+        fn add(a, b) { return a + b; }
+        for (let i = 0; i < 4; i++) { add(i, 1); }
+        print add("volt", "script");
+        print add("n", 1);
+        print add(2, 3);
+    )"), "voltscript\nn1\n5\n");
+
+    EXPECT_EQ(runCode(R"(
+        fn at(xs, i) { return xs[i]; }
+        let xs = [10, 20, 30];
+        for (let i = 0; i < 3; i++) { at(xs, i); }
+        print at(xs, 2);
+        let m = {"k": 7};
+        print at(m, "k");
+        print at(xs, 0);
+    )"), "30\n7\n10\n");
+
+    EXPECT_EQ(runCode(R"(
+        fn grow(x, y) { x += y; return x; }
+        for (let i = 0; i < 4; i++) { grow(i, 1); }
+        print grow("a", "b");
+        print grow("a", 1);
+    )"), "ab\na1\n");
+}
+
+TEST(Interpreter, QuickenedSitesKeepRuntimeErrors) {
+    // The fast paths hand edge cases to the full path and its errors
+    EXPECT_EQ(runCode(R"(
+        fn div(a, b) { return a / b; }
+        for (let i = 1; i < 4; i++) { div(i, i); }
+        print div(1, 0);
+    )"), "RUNTIME_ERROR");
+    EXPECT_EQ(runCode(R"(
+        fn at(xs, i) { return xs[i]; }
+        let xs = [1, 2];
+        for (let i = 0; i < 2; i++) { at(xs, i); }
+        print at(xs, 5);
+    )"), "RUNTIME_ERROR");
+    EXPECT_EQ(runCode(R"(
+        let x = 4;
+        for (let i = 1; i < 4; i++) { x /= i; }
+        x /= 0;
+    )"), "RUNTIME_ERROR");
+}
+
+TEST(Interpreter, BinaryNodesSpecializeToTheirOperands) {
+    PrintCapture capture;
+    auto program = parseProgram("fn add(a, b) { return a + b; }");
+    auto* fn = static_cast<volt::FnStmt*>(program[0].get());
+    auto* ret = static_cast<volt::ReturnStmt*>(fn->body[0].get());
+    auto* add = static_cast<volt::BinaryExpr*>(ret->value.get());
+
+    volt::Interpreter interpreter(volt::Engine::Ast);
+    interpreter.execute(program);
+    interpreter.execute(parseProgram("add(1, 2);"));
+    EXPECT_EQ(add->quick.mode, volt::Quickened::Cold);
+    interpreter.execute(parseProgram("add(3, 4);"));
+    EXPECT_EQ(add->quick.mode, volt::Quickened::Numbers);
+
+    interpreter.execute(parseProgram("print add(\"a\", \"b\");"));
+    EXPECT_EQ(add->quick.mode, volt::Quickened::Generic);
+    EXPECT_EQ(capture.get(), "ab\n");
+}
+
+// ========================================
+// COUNTED LOOP TESTS
+// ========================================
+
+namespace {
+
+const volt::CountedLoop& countedLoopOf(const std::string& source) {
+    static std::vector<std::vector<volt::StmtPtr>> programs;
+    programs.push_back(parseProgram(source));
+    volt::Resolver resolver([](const std::string&) { return false; });
+    resolver.resolve(programs.back());
+    return static_cast<volt::ForStmt*>(programs.back().back().get())->counted;
+}
+
+} // anonymous namespace
+
+TEST(Interpreter, ResolverFindsCountedLoops) {
+    EXPECT_EQ(countedLoopOf("for (let i = 0; i < 3; i++) { print i; }").step, 1);
+    EXPECT_EQ(countedLoopOf("for (let i = 9; i >= 0; i = i - 3) print i;").step, -3);
+    EXPECT_EQ(countedLoopOf("let n = 4; for (let i = 0; i <= n; i += 0.5) {}").step, 0.5);
+
+    // The counter must only change through the increment
+    EXPECT_LT(countedLoopOf("for (let i = 0; i < 3; i++) { i = 5; }").slot, 0);
+    EXPECT_LT(countedLoopOf("for (let i = 0; i < 3; i++) { fn f() { i++; } }").slot, 0);
+    EXPECT_LT(countedLoopOf("for (let i = 0; i < 3; i = i * 2) {}").slot, 0);
+    EXPECT_LT(countedLoopOf("for (let i = 0; i != 3; i++) {}").slot, 0);
+    EXPECT_GE(countedLoopOf("for (let i = 0; i < 3; i++) { let i = 5; }").slot, 0);
+}
+
+TEST(Interpreter, CountedLoopsBehaveLikeForLoops) {
+    EXPECT_EQ(runCode("for (let i = 3; i > 0; i--) print i;"), "3\n2\n1\n");
+    EXPECT_EQ(runCode("for (let i = 0; i < 1; i += 0.25) print i;"), "0\n0.25\n0.5\n0.75\n");
+    EXPECT_EQ(runCode(R"(
+        let n = 2;
+        for (let i = 0; i < n; i++) { if (n < 4) n++; print i; }
+    )"), "0\n1\n2\n3\n");
+    EXPECT_EQ(runCode(R"(
+        for (let i = 0; i < 10; i++) {
+            if (i == 1) continue;
+            if (i == 3) break;
+            print i;
+        }
+    )"), "0\n2\n");
+
+    // Closures see the counter's current value, as in any for loop
+    EXPECT_EQ(runCode(R"(
+        let read = nil;
+        for (let i = 0; i < 3; i++) { if (i == 0) { fn get() { return i; } read = get; } }
+        print read();
+    )"), "3\n");
+
+    // A counter or bound that isn't a number takes the ordinary path
+    EXPECT_EQ(runCode(R"(for (let s = "a"; s < 3; s = s + 1) print s;)"), "RUNTIME_ERROR");
+    EXPECT_EQ(runCode(R"(for (let i = 0; i < "3"; i++) print i;)"), "RUNTIME_ERROR");
+}
+
+// ========================================
+// CLOSURE CAPTURE TESTS
+// ========================================
+
+TEST(Interpreter, ClosuresCaptureOnlyTheVariablesTheyUse) {
+    auto program = parseProgram(
+        "fn make() {"
+        "  let big = [1, 2, 3, 4, 5, 6, 7, 8];"
+        "  let n = 1;"
+        "  fn get() { return n; }"
+        "  return get;"
+        "}");
+    volt::Resolver resolver([](const std::string&) { return false; });
+    resolver.resolve(program);
+
+    auto* make = static_cast<volt::FnStmt*>(program[0].get());
+    auto* get = static_cast<volt::FnStmt*>(make->body[2].get());
+    ASSERT_EQ(get->captures.size(), 1u);
+    EXPECT_TRUE(get->captures[0].local);
+    EXPECT_EQ(make->layout.names[get->captures[0].slot], "n");
+    EXPECT_EQ(make->layout.cells, std::vector<int>{get->captures[0].slot});
+}
+
+TEST(Interpreter, ClosuresShareCapturedVariables) {
+    // Writes from either side are seen by the other
+    EXPECT_EQ(runCode(R"(
+        fn pair() {
+            let count = 0;
+            fn inc() { count = count + 1; }
+            fn read() { return count; }
+            inc(); inc();
+            count += 10;
+            return [inc, read];
+        }
+        let p = pair();
+        p[0]();
+        print p[1]();
+    )"), "13\n");
+
+    // Through a function in between, and hoisted siblings
+    EXPECT_EQ(runCode(R"(
+        fn outer(x) {
+            fn middle() {
+                fn inner() { x = x * 2; return later(); }
+                return inner();
+            }
+            fn later() { return x; }
+            return middle();
+        }
+        print outer(21);
+    )"), "42\n");
+}
+
+TEST(Interpreter, EachIterationCapturesFreshBodyVariables) {
+    EXPECT_EQ(runCode(R"(
+        let getters = [];
+        for (let i = 0; i < 3; i++) {
+            let copy = i * 10;
+            fn get() { return copy; }
+            getters.push(get);
+        }
+        print getters[0]() + getters[1]() + getters[2]();
+        let j = 0;
+        while (j < 2) { let k = j; fn show() { print k; } getters.push(show); j++; }
+        getters[3]();
+        getters[4]();
+    )"), "30\n0\n1\n");
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include "lexer.h"
+#include "parser.h"
+#include "interpreter.h"
+#include "optimizer.h"
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+class PrintCapture {
+public:
+    PrintCapture() : old(std::cout.rdbuf(buffer.rdbuf())) {}
+    ~PrintCapture() { std::cout.rdbuf(old); }
+    std::string get() { return buffer.str(); }
+private:
+    std::stringstream buffer;
+    std::streambuf* old;
+};
+
+std::vector<volt::StmtPtr> parse(const std::string& source) {
+    volt::Lexer lexer(source);
+    auto tokens = lexer.tokenize();
+    volt::Parser parser(tokens);
+    auto statements = parser.parseProgram();
+    if (parser.hadError()) ADD_FAILURE() << "parse error in: " << source;
+    return statements;
+}
+
+std::string run(std::vector<volt::StmtPtr>& statements) {
+    PrintCapture capture;
+    volt::Interpreter interpreter;
+    try {
+        interpreter.execute(statements);
+        return capture.get();
+    } catch (const volt::RuntimeError& e) {
+        return capture.get() + "RUNTIME_ERROR " + std::to_string(e.token.line) + ":" +
+               std::to_string(e.token.column) + " " + e.what();
+    }
+}
+
+// Optimizing must never change what a program prints or which error it raises
+void expectSameResult(const std::string& source) {
+    auto plain = parse(source);
+    auto optimized = parse(source);
+    volt::Optimizer().optimize(optimized);
+    EXPECT_EQ(run(plain), run(optimized)) << "source: " << source;
+}
+
+// The printed form of the first statement's expression after optimizing
+std::string optimizedExpr(const std::string& source) {
+    auto statements = parse(source);
+    volt::Optimizer().optimize(statements);
+    auto* stmt = static_cast<volt::ExprStmt*>(statements[0].get());
+    return volt::printAST(stmt->expr.get());
+}
+
+} // anonymous namespace
+
+// ========================================
+// CONSTANT FOLDING
+// ========================================
+
+TEST(Optimizer, FoldsLiteralArithmetic) {
+    EXPECT_EQ(optimizedExpr("1 + 2 * 3;"), "7.000000");
+    EXPECT_EQ(optimizedExpr("-(4 - 6);"), "2.000000");
+    EXPECT_EQ(optimizedExpr("\"volt\" + \"script\" + 1;"), "\"voltscript1\"");
+    EXPECT_EQ(optimizedExpr("!(1 < 2);"), "false");
+    EXPECT_EQ(optimizedExpr("x + (1 + 1);"), "(+ x 2.000000)");
+}
+
+TEST(Optimizer, PicksLiteralBranchesOfExpressions) {
+    EXPECT_EQ(optimizedExpr("true ? a : b;"), "a");
+    EXPECT_EQ(optimizedExpr("nil || x;"), "x");
+    EXPECT_EQ(optimizedExpr("0 && x;"), "0.000000");
+}
+
+TEST(Optimizer, LeavesFailingOperationsForRuntime) {
+    EXPECT_EQ(optimizedExpr("1 / 0;"), "(/ 1.000000 0.000000)");
+    expectSameResult("print 1;\nprint 2 / (1 - 1);");
+    expectSameResult("print -\"text\";");
+}
+
+// ========================================
+// DEAD CODE
+// ========================================
+
+TEST(Optimizer, RemovesDeadBranchesAndUnreachableCode) {
+    auto statements = parse(
+        "if (false) print 1; else print 2;"
+        "while (false) print 3;"
+        "fn f() { return 4; print 5; }"
+        "print f();");
+    volt::Optimizer optimizer;
+    optimizer.optimize(statements);
+
+    ASSERT_EQ(statements.size(), 3u);
+    EXPECT_EQ(statements[0]->kind, volt::StmtKind::Print);
+    EXPECT_EQ(static_cast<volt::FnStmt*>(statements[1].get())->body.size(), 1u);
+    EXPECT_EQ(optimizer.changes().size(), 3u);
+    EXPECT_EQ(run(statements), "2\n4\n");
+}
+
+TEST(Optimizer, KeepsDeadDeclarations) {
+    // 'x' is still declared (and nil) even though its branch never runs
+    expectSameResult("if (false) let x = 1; print x;");
+    expectSameResult("fn f() { return g; fn g() {} } print f();");
+    expectSameResult("fn f() { for (;;) { break; let y = 2; } return 1; } print f();");
+}
+
+// ========================================
+// CONSTANT LITERALS
+// ========================================
+
+TEST(Optimizer, ConstantLiteralsAreFreshOnEveryEvaluation) {
+    expectSameResult(
+        "fn make() { return [1, 2, \"three\"]; }"
+        "let a = make(); let b = make();"
+        "a.push(4); print a; print b; print a == b;"
+        "fn config() { return {\"debug\": false, \"level\": 2}; }"
+        "let c = config(); c[\"level\"] = 9; print config(); print c;");
+}
+
+TEST(Optimizer, ProgramsBehaveTheSame) {
+    expectSameResult(
+        "let total = 0;"
+        "for (let i = 0; i < 10; i++) {"
+        "  if (2 > 1) total = total + i * (3 - 1);"
+        "  if (false) { total = -1; }"
+        "}"
+        "print total;"
+        "print \"sum: \" + (1 + 2);"
+        "run { total--; } until (total < 85 || false);"
+        "print total;");
+}
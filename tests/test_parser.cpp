@@ -81,6 +81,27 @@ TEST(Parser, FunctionCall) {
     EXPECT_EQ(parseExpr("add(1, 2)"), "(call add 1.000000 2.000000)");
 }
 
+TEST(Parser, MethodCallsBecomeOneNode) {
+    volt::Lexer lexer("arr.push(1); arr.push; arr.frobnicate();");
+    auto tokens = lexer.tokenize();
+    volt::Parser parser(tokens);
+    auto statements = parser.parseProgram();
+    ASSERT_FALSE(parser.hadError());
+    ASSERT_EQ(statements.size(), 3);
+    
+    auto* call = static_cast<volt::ExprStmt*>(statements[0].get())->expr.get();
+    ASSERT_EQ(call->kind, volt::ExprKind::MethodCall);
+    EXPECT_EQ(static_cast<volt::MethodCallExpr*>(call)->method, volt::MethodId::Push);
+    EXPECT_EQ(volt::printAST(call), "(call arr.push 1.000000)");
+    
+    auto* member = static_cast<volt::ExprStmt*>(statements[1].get())->expr.get();
+    ASSERT_EQ(member->kind, volt::ExprKind::Member);
+    EXPECT_EQ(static_cast<volt::MemberExpr*>(member)->method, volt::MethodId::Push);
+    
+    auto* unknown = static_cast<volt::ExprStmt*>(statements[2].get())->expr.get();
+    EXPECT_EQ(static_cast<volt::MethodCallExpr*>(unknown)->method, volt::MethodId::None);
+}
+
 // ========================================
 // STATEMENT TESTS (NEW for Milestone 5)
 // ========================================
@@ -286,3 +307,27 @@ TEST(Parser, MissingConditionParen) {
     
     EXPECT_TRUE(parser.hadError());
 }
+
+// ========================================
+// NODE KIND TAGS
+// ========================================
+
+TEST(Parser, NodesCarryKindTags) {
+    volt::Lexer lexer("let m = {\"a\": [1, 2]}; m[\"a\"].length; for (;;) break;");
+    auto tokens = lexer.tokenize();
+    volt::Parser parser(tokens);
+    auto statements = parser.parseProgram();
+    
+    EXPECT_FALSE(parser.hadError());
+    ASSERT_EQ(statements.size(), 3);
+    EXPECT_EQ(statements[0]->kind, volt::StmtKind::Let);
+    EXPECT_EQ(statements[1]->kind, volt::StmtKind::Expr);
+    EXPECT_EQ(statements[2]->kind, volt::StmtKind::For);
+    
+    auto* let = static_cast<volt::LetStmt*>(statements[0].get());
+    EXPECT_EQ(let->initializer->kind, volt::ExprKind::HashMap);
+    
+    auto* member = static_cast<volt::ExprStmt*>(statements[1].get())->expr.get();
+    ASSERT_EQ(member->kind, volt::ExprKind::Member);
+    EXPECT_EQ(static_cast<volt::MemberExpr*>(member)->object->kind, volt::ExprKind::Index);
+}
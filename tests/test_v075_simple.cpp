@@ -171,5 +171,3 @@ TEST(V075Simple, JsonFunctionErrors) {
     EXPECT_TRUE(output.find("RUNTIME_ERROR") != std::string::npos);
     EXPECT_TRUE(output.find("string") != std::string::npos);
 }
-
-} // namespace
\ No newline at end of file
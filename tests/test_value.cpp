@@ -0,0 +1,326 @@
+#include <gtest/gtest.h>
+#include "value.h"
+#include "array.h"
+#include "hashmap.h"
+#include "callable.h"
+#include "interpreter.h"
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+using namespace volt;
+
+// ========================================
+// NAN-BOXED VALUE TESTS
+// ========================================
+
+TEST(Value, FitsInEightBytes) {
+    EXPECT_EQ(sizeof(Value), 8u);
+}
+
+TEST(Value, ImmediatesRoundTrip) {
+    EXPECT_TRUE(isNil(Value()));
+    EXPECT_TRUE(isNil(Value(nullptr)));
+    EXPECT_TRUE(isBool(Value(true)));
+    EXPECT_TRUE(isBool(Value(false)));
+    EXPECT_TRUE(asBool(Value(true)));
+    EXPECT_FALSE(asBool(Value(false)));
+    EXPECT_FALSE(isNumber(Value(true)));
+    EXPECT_FALSE(isBool(Value(nullptr)));
+}
+
+TEST(Value, NumbersIncludingSpecialDoubles) {
+    const double samples[] = {0.0, -0.0, 1.5, -42.0, 1e300, -1e-300,
+                              std::numeric_limits<double>::infinity(),
+                              -std::numeric_limits<double>::infinity()};
+    for (double d : samples) {
+        Value v(d);
+        ASSERT_TRUE(isNumber(v)) << d;
+        EXPECT_EQ(asNumber(v), d);
+    }
+
+    // Any NaN stays a number and never aliases an object or a bool
+    Value nan(std::nan(""));
+    Value negativeNan(-std::nan(""));
+    EXPECT_TRUE(isNumber(nan));
+    EXPECT_TRUE(isNumber(negativeNan));
+    EXPECT_TRUE(std::isnan(asNumber(negativeNan)));
+    EXPECT_FALSE(isEqual(nan, nan));
+}
+
+TEST(Value, StringsCompareByContent) {
+    Value a(std::string("volt"));
+    Value b("volt");
+    Value copy = a;
+    EXPECT_TRUE(isString(a));
+    EXPECT_EQ(asString(copy), "volt");
+    EXPECT_TRUE(isEqual(a, b));
+    EXPECT_FALSE(isEqual(a, Value("script")));
+}
+
+TEST(Value, ObjectsAreSharedAndCompareByIdentity) {
+    auto array = makeRef<VoltArray>();
+    Value first = array;
+    Value second = first;
+    asArray(second)->push(1.0);
+    EXPECT_EQ(array->length(), 1u);
+    EXPECT_TRUE(isArray(first));
+    EXPECT_TRUE(isEqual(first, second));
+    EXPECT_FALSE(isEqual(first, Value(makeRef<VoltArray>())));
+
+    Value map = makeRef<VoltHashMap>();
+    EXPECT_TRUE(isHashMap(map));
+    EXPECT_FALSE(isArray(map));
+}
+
+TEST(Value, ReleasesObjectsWhenLastReferenceGoes) {
+    static int destroyed = 0;
+    struct Probe : Callable {
+        ~Probe() override { destroyed++; }
+        Value call(Interpreter&, std::span<const Value>) override { return nullptr; }
+        int arity() const override { return 0; }
+        std::string toString() const override { return "<probe>"; }
+    };
+
+    {
+        Value outer = makeRef<Probe>();
+        EXPECT_TRUE(isCallable(outer));
+        {
+            Value inner = outer;
+            Value moved = std::move(inner);
+            EXPECT_TRUE(isNil(inner));
+        }
+        EXPECT_EQ(destroyed, 0);
+        outer = 3.0;
+        EXPECT_EQ(destroyed, 1);
+    }
+    EXPECT_EQ(destroyed, 1);
+}
+
+TEST(Value, ArraysTrackWhetherTheyHoldOnlyNumbers) {
+    VoltArray array({1.0, 2.0});
+    EXPECT_TRUE(array.allNumbers());
+    array.push("three");
+    EXPECT_FALSE(array.allNumbers());
+    array.set(2, 3.0);
+    EXPECT_TRUE(array.allNumbers());
+    array.push(nullptr);
+    EXPECT_FALSE(array.allNumbers());
+    array.pop();
+    EXPECT_TRUE(array.allNumbers());
+    EXPECT_EQ(array.sum(), 6.0);
+
+    // NaNs computed by the kernels stay numbers
+    auto inf = VoltArray({std::numeric_limits<double>::infinity(), 1.0, 2.0}).scale(0.0);
+    EXPECT_TRUE(inf->allNumbers());
+    EXPECT_TRUE(std::isnan(asNumber(inf->get(0))));
+    EXPECT_TRUE(std::isnan(asNumber(inf->max())));
+}
+
+// ========================================
+// STRING OBJECT TESTS
+// ========================================
+
+TEST(Value, InternedStringsAreShared) {
+    auto a = StringObject::intern("name");
+    auto b = StringObject::intern(std::string("na") + "me");
+    EXPECT_EQ(a.get(), b.get());
+    EXPECT_TRUE(a->isInterned());
+    EXPECT_EQ(StringObject::findInterned("name"), a.get());
+    EXPECT_EQ(a->hash(), StringObject::hashOf("name"));
+
+    // Literals intern identifier-like text only
+    EXPECT_EQ(StringObject::fromLiteral("name").get(), a.get());
+    EXPECT_FALSE(StringObject::fromLiteral("hello, world")->isInterned());
+}
+
+TEST(Value, InternTableForgetsDeadStrings) {
+    {
+        auto temp = StringObject::intern("only_used_here");
+        EXPECT_NE(StringObject::findInterned("only_used_here"), nullptr);
+    }
+    EXPECT_EQ(StringObject::findInterned("only_used_here"), nullptr);
+}
+
+TEST(Value, AsStringBorrowsTheCharacters) {
+    Value v(std::string("borrowed"));
+    Value copy = v;
+    EXPECT_EQ(&asString(v), &asString(copy));
+}
+
+TEST(Value, HashMapKeysMatchAnyStringWithSameContent) {
+    auto map = makeRef<VoltHashMap>();
+    map->set("color", 1.0);
+
+    Value runtimeKey(std::string("col") + "or");  // Built at runtime, not interned
+    EXPECT_FALSE(asStringObject(runtimeKey)->isInterned());
+    EXPECT_EQ(asNumber(map->get(asStringObject(runtimeKey))), 1.0);
+    EXPECT_TRUE(map->contains("color"));
+    EXPECT_TRUE(isNil(map->get("never seen before")));
+
+    map->set(asStringObject(runtimeKey), 2.0);
+    EXPECT_EQ(map->size(), 1u);
+    EXPECT_EQ(asNumber(map->get("color")), 2.0);
+}
+
+TEST(Value, HashTableMatchesAReferenceMap) {
+    // Random sets and removes of string and number keys, checked against
+    // std::unordered_map, with iteration in insertion order
+    HashTable table;
+    std::unordered_map<std::string, double> reference;
+    std::vector<std::string> order;
+    uint32_t seed = 12345;
+    for (int step = 0; step < 20000; step++) {
+        seed = seed * 1103515245 + 12345;
+        uint32_t n = (seed >> 8) % 500;
+        Value key = n % 2 ? Value(static_cast<double>(n)) : Value(StringObject::intern("k" + std::to_string(n)));
+        std::string printed = valueToString(key);
+        if ((seed >> 4) % 3 == 0) {
+            EXPECT_EQ(table.remove(key), reference.erase(printed) == 1);
+            std::erase(order, printed);
+        } else {
+            if (!reference.count(printed)) order.push_back(printed);
+            reference[printed] = step;
+            table.set(key, static_cast<double>(step));
+        }
+        ASSERT_EQ(table.size(), reference.size());
+    }
+    size_t i = 0;
+    for (const auto& [key, value] : table) {
+        ASSERT_LT(i, order.size());
+        EXPECT_EQ(valueToString(key), order[i++]);
+        EXPECT_EQ(asNumber(value), reference[valueToString(key)]);
+    }
+    EXPECT_EQ(i, order.size());
+}
+
+TEST(Value, HashMapKeysAreCanonical) {
+    auto map = makeRef<VoltHashMap>();
+    map->set(Value(1.0), "one");
+    map->set(Value(2.5), "two and a half");
+    map->set(Value(true), "yes");
+    map->set(Value(), "nothing");
+    map->set(Value(-0.0), "zero");
+
+    // Strings spelled the way the value prints are the same key
+    EXPECT_EQ(asString(map->get(Value("1"))), "one");
+    EXPECT_EQ(asString(map->get(Value(std::string("2.") + "5"))), "two and a half");
+    EXPECT_EQ(asString(map->get(Value("true"))), "yes");
+    EXPECT_EQ(asString(map->get(Value("nil"))), "nothing");
+    EXPECT_EQ(asString(map->get(Value(0.0))), "zero");
+    EXPECT_EQ(map->size(), 5u);
+
+    // Other spellings are different string keys
+    EXPECT_TRUE(isNil(map->get(Value("1.0"))));
+    EXPECT_TRUE(isNil(map->get(Value("01"))));
+    EXPECT_TRUE(isNil(map->get(Value("2.50"))));
+
+    // Number keys are stored as numbers and listed in their printed form
+    EXPECT_TRUE(isNumber(*VoltHashMap::keyFor(Value("1"), false)));
+    EXPECT_EQ(map->getKeys(), (std::vector<std::string>{"1", "2.5", "true", "nil", "0"}));
+}
+
+TEST(Value, MapsBuiltTheSameWayShareAShape) {
+    auto first = makeRef<VoltHashMap>();
+    auto second = makeRef<VoltHashMap>();
+    for (auto* map : {first.get(), second.get()}) {
+        map->set(Value("x"), 1.0);
+        map->set(Value("y"), 2.0);
+    }
+    EXPECT_TRUE(first->data.shape()->isShared());
+    EXPECT_EQ(first->data.shape(), second->data.shape());
+
+    // Another order is another layout
+    auto swapped = makeRef<VoltHashMap>();
+    swapped->set(Value("y"), 2.0);
+    swapped->set(Value("x"), 1.0);
+    EXPECT_NE(first->data.shape(), swapped->data.shape());
+
+    // Removing a key gives the map a private dictionary shape
+    second->remove(Value("x"));
+    EXPECT_FALSE(second->data.shape()->isShared());
+    EXPECT_TRUE(first->data.shape()->isShared());
+    EXPECT_EQ(asNumber(first->get(Value("x"))), 1.0);
+}
+
+TEST(Value, FieldCacheFollowsTheShape) {
+    auto point = makeRef<VoltHashMap>();
+    point->set(Value("x"), 1.0);
+    point->set(Value("y"), 2.0);
+
+    FieldCache cache;
+    EXPECT_EQ(asNumber(point->getField(cache, "y")), 2.0);
+    EXPECT_EQ(cache.shape, point->data.shape());
+    EXPECT_EQ(cache.position, 1u);
+
+    // Same layout: a cache hit reads and writes by position
+    auto other = makeRef<VoltHashMap>();
+    other->set(Value("x"), 10.0);
+    other->set(Value("y"), 20.0);
+    other->setField(cache, "y", 25.0);
+    EXPECT_EQ(asNumber(other->get(Value("y"))), 25.0);
+
+    // Adding a field changes the shape; the site's cache moves along
+    FieldCache zCache;  // One cache per site, so per field name
+    point->setField(zCache, "z", 3.0);
+    EXPECT_EQ(zCache.shape, point->data.shape());
+    EXPECT_EQ(asNumber(point->getField(zCache, "z")), 3.0);
+    EXPECT_TRUE(isNil(other->getField(zCache, "z")));
+    EXPECT_EQ(asNumber(other->getField(cache, "y")), 25.0);
+
+    // Dictionary shapes change in place and are never cached
+    other->remove(Value("x"));
+    FieldCache fresh;
+    EXPECT_EQ(asNumber(other->getField(fresh, "y")), 25.0);
+    EXPECT_FALSE(fresh.shape);
+}
+
+TEST(Value, ManyKeysTurnAMapIntoADictionary) {
+    auto map = makeRef<VoltHashMap>();
+    for (size_t i = 0; i <= Shape::kMaxSharedKeys; i++) {
+        map->set(Value("k" + std::to_string(i)), static_cast<double>(i));
+    }
+    EXPECT_FALSE(map->data.shape()->isShared());
+    EXPECT_EQ(map->size(), Shape::kMaxSharedKeys + 1);
+    EXPECT_EQ(asNumber(map->get(Value("k0"))), 0.0);
+}
+
+// ========================================
+// NATIVE FUNCTION TESTS
+// ========================================
+
+TEST(Value, NativeArityComesFromTheSignature) {
+    NativeFunction none([]() -> Value { return 1.0; }, "none");
+    NativeFunction two([](const Value& a, const Value& b) -> Value {
+        return asNumber(a) - asNumber(b);
+    }, "two");
+    NativeFunction many(4, [](std::span<const Value> args) -> Value {
+        return static_cast<double>(args.size());
+    }, "many");
+
+    EXPECT_EQ(none.arity(), 0);
+    EXPECT_EQ(two.arity(), 2);
+    EXPECT_EQ(many.arity(), 4);
+
+    Value args[] = {5.0, 3.0, nullptr, nullptr};
+    EXPECT_EQ(asNumber(none.invoke({})), 1.0);
+    EXPECT_EQ(asNumber(two.invoke(std::span<const Value>(args, 2))), 2.0);
+    EXPECT_EQ(asNumber(many.invoke(args)), 4.0);
+}
+
+TEST(Value, BoundMethodKeepsItsReceiverAlive) {
+    Value method;
+    {
+        auto array = makeRef<VoltArray>();
+        method = makeRef<NativeFunction>(1, [](Interpreter&, const Value& self,
+                                               std::span<const Value> args) -> Value {
+            asArray(self)->push(args[0]);
+            return static_cast<double>(asArray(self)->length());
+        }, Value(array), "push");
+    }
+    auto push = asCallable(method);
+    Value arg = 7.0;
+    Interpreter interpreter;
+    EXPECT_EQ(asNumber(push->call(interpreter, std::span<const Value>(&arg, 1))), 1.0);
+    EXPECT_EQ(asNumber(push->call(interpreter, std::span<const Value>(&arg, 1))), 2.0);
+}
@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+#include "lexer.h"
+#include "parser.h"
+#include "interpreter.h"
+#include "value.h"
+#include "vm/chunk.h"
+#include "vm/compiler.h"
+#include <sstream>
+#include <iostream>
+
+// Helper to capture print output
+namespace {
+
+class PrintCapture {
+public:
+    PrintCapture() : old(std::cout.rdbuf(buffer.rdbuf())) {}
+    ~PrintCapture() { std::cout.rdbuf(old); }
+    std::string get() { return buffer.str(); }
+private:
+    std::stringstream buffer;
+    std::streambuf* old;
+};
+
+// Helper to run code on a specific engine
+std::string runCode(const std::string& source, volt::Engine engine) {
+    PrintCapture capture;
+
+    volt::Lexer lexer(source);
+    auto tokens = lexer.tokenize();
+    volt::Parser parser(tokens);
+    auto statements = parser.parseProgram();
+
+    if (parser.hadError()) return "PARSE_ERROR";
+
+    volt::Interpreter interpreter(engine);
+    try {
+        interpreter.execute(statements);
+        return capture.get();
+    } catch (const volt::RuntimeError& e) {
+        return "RUNTIME_ERROR " + std::to_string(e.token.line) + ":" +
+               std::to_string(e.token.column) + " " + e.what();
+    } catch (...) {
+        return "RUNTIME_ERROR";
+    }
+}
+
+// Both engines must agree on output and errors
+void expectSameOnBothEngines(const std::string& source) {
+    std::string ast = runCode(source, volt::Engine::Ast);
+    std::string vm = runCode(source, volt::Engine::Vm);
+    EXPECT_EQ(ast, vm) << "source: " << source;
+}
+
+}
+
+// ========================================
+// ENGINE PARITY
+// ========================================
+
+TEST(VM, ArithmeticAndStrings) {
+    expectSameOnBothEngines(
+        "print 1 + 2 * 3 - 4 / 2;"
+        "print 7 % 3;"
+        "print \"a\" + \"b\" + 1;"
+        "print -(3) == -3 and !false;"
+    );
+}
+
+TEST(VM, BlockScopingAndShadowing) {
+    expectSameOnBothEngines(
+        "let x = 1;"
+        "{ let x = x + 1; print x; { let x = 10; print x; } print x; }"
+        "print x;"
+    );
+}
+
+TEST(VM, LoopsWithBreakAndContinue) {
+    expectSameOnBothEngines(
+        "for (let i = 0; i < 10; i++) {"
+        "  if (i == 2) continue;"
+        "  if (i == 6) break;"
+        "  let sq = i * i;"
+        "  print sq;"
+        "}"
+        "let n = 0;"
+        "run { n++; if (n == 2) continue; print n; } until (n >= 4);"
+        "while (n > 0) { n -= 1; if (n == 1) break; }"
+        "print n;"
+    );
+}
+
+TEST(VM, ClosuresShareCapturedVariables) {
+    expectSameOnBothEngines(
+        "fn makeCounter() {"
+        "  let count = 0;"
+        "  fn inc() { count++; return count; }"
+        "  return inc;"
+        "}"
+        "let a = makeCounter();"
+        "let b = makeCounter();"
+        "print a(); print a(); print b(); print a;"
+    );
+}
+
+TEST(VM, LoopClosuresCaptureFreshBlockVariables) {
+    expectSameOnBothEngines(
+        "let fns = [];"
+        "for (let i = 0; i < 3; i++) {"
+        "  let j = i;"
+        "  fn get() { return j; }"
+        "  fns.push(get);"
+        "}"
+        "print fns[0]() + fns[1]() + fns[2]();"
+    );
+}
+
+TEST(VM, MutualRecursionInsideFunction) {
+    expectSameOnBothEngines(
+        "fn check(n) {"
+        "  fn isEven(k) { if (k == 0) return true; return isOdd(k - 1); }"
+        "  fn isOdd(k) { if (k == 0) return false; return isEven(k - 1); }"
+        "  return isEven(n);"
+        "}"
+        "print check(10); print check(7);"
+    );
+}
+
+TEST(VM, CollectionsAndNatives) {
+    expectSameOnBothEngines(
+        "let arr = [3, 1, 2];"
+        "arr[0] = arr[1] + arr[2];"
+        "print arr; print arr.length; print len(\"volt\");"
+        "let m = {\"a\": 1, \"b\": [1, 2]};"
+        "m[\"c\"] = 3;"
+        "print m[\"b\"][1] + m[\"c\"];"
+    );
+}
+
+TEST(VM, MethodCallsAndBoundMethods) {
+    expectSameOnBothEngines(
+        "let arr = [1, 2];"
+        "arr.push(3); print arr.pop(); arr.reverse(); print arr;"
+        "let push = arr.push; push(9); print arr; print push;"
+        "let m = {\"a\": 1};"
+        "print m.has(\"a\"); print m.keys(); print m.remove(\"a\"); print m.size;"
+    );
+    expectSameOnBothEngines("let arr = [];\narr.push();");
+    expectSameOnBothEngines("let arr = [];\narr.length();");
+    expectSameOnBothEngines("let m = {};\nm.push(1);");
+}
+
+TEST(VM, RuntimeErrorsReportSameLocation) {
+    expectSameOnBothEngines("let a = 1;\nprint a / 0;");
+    expectSameOnBothEngines("print undefinedThing;");
+    expectSameOnBothEngines("fn f(a, b) { return a; }\nf(1);");
+    expectSameOnBothEngines("let x = \"s\";\nx++;");
+}
+
+TEST(VM, RecoversAfterRuntimeError) {
+    volt::Lexer lexer("fn boom() { return 1 / 0; } let ok = 1;");
+    auto tokens = lexer.tokenize();
+    volt::Parser parser(tokens);
+    auto statements = parser.parseProgram();
+
+    volt::Interpreter interpreter(volt::Engine::Vm);
+    interpreter.execute(statements);
+
+    volt::Lexer lexer2("boom();");
+    auto tokens2 = lexer2.tokenize();
+    volt::Parser parser2(tokens2);
+    auto failing = parser2.parseProgram();
+    EXPECT_THROW(interpreter.execute(failing), volt::RuntimeError);
+
+    volt::Lexer lexer3("ok + 1");
+    auto tokens3 = lexer3.tokenize();
+    volt::Parser parser3(tokens3);
+    auto expr = parser3.parseExpression();
+    EXPECT_EQ(volt::asNumber(interpreter.evaluate(expr.get())), 2.0);
+}
+
+// ========================================
+// BYTECODE
+// ========================================
+
+TEST(VM, CompilesLocalsToSlots) {
+    volt::Lexer lexer("{ let a = 1; print a; }");
+    auto tokens = lexer.tokenize();
+    volt::Parser parser(tokens);
+    auto statements = parser.parseProgram();
+
+    volt::Compiler compiler;
+    auto script = compiler.compile(statements);
+    std::string listing = volt::disassemble(*script);
+
+    EXPECT_NE(listing.find("SET_LOCAL"), std::string::npos);
+    EXPECT_NE(listing.find("GET_LOCAL"), std::string::npos);
+    EXPECT_EQ(listing.find("GET_GLOBAL"), std::string::npos);
+}